@@ -0,0 +1,167 @@
+#ifndef LINALG_CST_LIB_EPILOGUE_H
+#define LINALG_CST_LIB_EPILOGUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace linalg {
+    /**
+     * @namespace linalg::epilogue
+     * @brief Functors applied by the fused multiply kernels to each accumulator before it is stored.
+     *
+     * A fused product runs in two stages on every output element, while it is still hot:
+     * - a *pre* stage `T(T acc, size_t i, size_t j)`, which can depend on the output position
+     *   (bias, scale, clamp...). Its result is the pre-activation `z`, which can optionally be
+     *   written to a second buffer;
+     * - an *activation* stage `T(T z)`, whose result is the stored output `y`.
+     *
+     * Stages are plain value types, so the compiler inlines them into the kernel loop.
+     *
+     * @see kernels::gemmEpilogue, Matrix::dotFused
+     */
+    namespace epilogue {
+
+        // ========== PRE STAGES ==========
+
+        /**
+         * @brief Leaves the accumulator untouched.
+         */
+        struct None {
+            template <typename T>
+            T operator()(T acc, size_t, size_t) const { return acc; }
+        };
+
+        /**
+         * @brief Adds bias[i] (one bias per output row, e.g. W*x + b).
+         */
+        template <typename T>
+        struct RowBias {
+            const T* bias;
+            T operator()(T acc, size_t i, size_t) const { return acc + bias[i]; }
+        };
+
+        /**
+         * @brief Adds bias[j] (one bias per output column, e.g. X*W^T + b for batches in rows).
+         */
+        template <typename T>
+        struct ColBias {
+            const T* bias;
+            T operator()(T acc, size_t, size_t j) const { return acc + bias[j]; }
+        };
+
+        /**
+         * @brief Multiplies the accumulator by a constant.
+         */
+        template <typename T>
+        struct Scale {
+            T alpha;
+            T operator()(T acc, size_t, size_t) const { return alpha * acc; }
+        };
+
+        /**
+         * @brief Clamps the accumulator to [lo, hi].
+         */
+        template <typename T>
+        struct Clamp {
+            T lo;
+            T hi;
+            T operator()(T acc, size_t, size_t) const { return std::clamp(acc, lo, hi); }
+        };
+
+        /**
+         * @brief acc * scale[j] + bias[j]: maps the int32 accumulator of an int8 product back to float.
+         *
+         * scale[j] is the product of the input scale and the scale of output channel j.
+         * @see kernels::gemmInt8Epilogue
+         */
+        struct Dequantize {
+            const float* scale;
+            const float* bias;
+            float operator()(int32_t acc, size_t, size_t j) const { return static_cast<float>(acc) * scale[j] + bias[j]; }
+        };
+
+        /**
+         * @brief Composition of two pre stages: second(first(acc, i, j), i, j).
+         */
+        template <typename First, typename Second>
+        struct Chain {
+            First first;
+            Second second;
+            template <typename T>
+            T operator()(T acc, size_t i, size_t j) const { return second(first(acc, i, j), i, j); }
+        };
+
+        template <typename First, typename Second>
+        Chain<First, Second> chain(First first, Second second) {
+            return {first, second};
+        }
+
+        // ========== ACTIVATION STAGES ==========
+        //
+        // Each activation also provides its derivative, for the backward passes: grad(z) at the
+        // pre-activation, and gradFromOutput(y) from the stored output, which needs no
+        // transcendental function (sigmoid: y(1 - y), tanh: 1 - y^2).
+
+        struct Identity {
+            template <typename T>
+            T operator()(T z) const { return z; }
+            template <typename T>
+            T grad(T) const { return T(1); }
+            template <typename T>
+            T gradFromOutput(T) const { return T(1); }
+        };
+
+        struct ReLU {
+            template <typename T>
+            T operator()(T z) const { return z > T(0) ? z : T(0); }
+            template <typename T>
+            T grad(T z) const { return z > T(0) ? T(1) : T(0); }
+            template <typename T>
+            T gradFromOutput(T y) const { return y > T(0) ? T(1) : T(0); }
+        };
+
+        struct Sigmoid {
+            template <typename T>
+            T operator()(T z) const { return T(1) / (T(1) + std::exp(-z)); }
+            template <typename T>
+            T grad(T z) const { return gradFromOutput((*this)(z)); }
+            template <typename T>
+            T gradFromOutput(T y) const { return y * (T(1) - y); }
+        };
+
+        struct Tanh {
+            template <typename T>
+            T operator()(T z) const { return std::tanh(z); }
+            template <typename T>
+            T grad(T z) const { return gradFromOutput(std::tanh(z)); }
+            template <typename T>
+            T gradFromOutput(T y) const { return T(1) - y * y; }
+        };
+
+        // ========== SECOND OUTPUT ==========
+
+        /**
+         * @brief Activation stage that also makes the fused product write dy/dz, instead of z, to
+         * its optional second buffer.
+         *
+         * The derivative comes from the output just computed (Act::gradFromOutput), so training
+         * gets y and dy/dz from a single evaluation of the activation, and the backward pass is a
+         * plain multiply.
+         */
+        template <typename Act>
+        struct WithGrad : Act {};
+
+        /**
+         * @brief Value a fused product stores in its second buffer for pre-activation z and output y.
+         */
+        template <typename Act, typename T>
+        T secondOutput(const Act&, T z, T) { return z; }
+
+        template <typename Act, typename T>
+        T secondOutput(const WithGrad<Act>& act, T, T y) { return act.gradFromOutput(y); }
+    }
+}
+
+#endif // LINALG_CST_LIB_EPILOGUE_H
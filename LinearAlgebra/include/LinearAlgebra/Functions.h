@@ -94,6 +94,20 @@ namespace linalg {
     template <typename T, typename Func>
     Vector<T> transform(const Vector<T> &v1, const Vector<T> &v2, Func func);
 
+    // In-place variants: write into `out` (resized only if its shape differs), so reusing the
+    // same output buffer does not allocate. `out` may alias the inputs.
+    template <typename T, typename Func>
+    void transformInto(const Matrix<T> &m, Matrix<T> &out, Func func);
+    template <typename T, typename Func>
+    void transformInto(const Matrix<T> &m1, const Matrix<T> &m2, Matrix<T> &out, Func func);
+
+    // Sum of func(m1[i], m2[i]) without materializing the element-wise result
+    template <typename T, typename Func>
+    T transformSum(const Matrix<T> &m1, const Matrix<T> &m2, Func func);
+    // Both in one pass: writes out[i] = func(m1[i], m2[i]) and returns the sum of term(m1[i], m2[i])
+    template <typename T, typename Func, typename Term>
+    T transformSumInto(const Matrix<T> &m1, const Matrix<T> &m2, Matrix<T> &out, Func func, Term term);
+
     // Ternary and above (ATTENTION: DOES NOT VERIFY SHAPE/SIZE)
     template <typename T, typename Func, typename... Matrices>
     Matrix<T> transform(Func func, const Matrix<T>& first, const Matrices&... rest);
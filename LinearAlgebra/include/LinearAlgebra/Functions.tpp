@@ -6,6 +6,7 @@
 #include "Matrix.h"
 #include "Vector.h"
 #include "Shape.h"
+#include "Kernels.h"
 #include <cmath>
 //#include <functional>
 //std::vector<double> transform(std::vector<double> x, std::function<double(double)> f) {
@@ -68,9 +69,9 @@ namespace linalg {
         T max = v[0]; 
         for (size_t i = 1; i < v.getSize(); i++) {
             T current = v[i];
-            idx = i;
             if (current > max) {
                 max = current;
+                idx = i;
             }
         }
         return idx;        
@@ -80,22 +81,14 @@ namespace linalg {
     template <typename T, typename Func>
     Matrix<T> transform(const Matrix<T>& m, Func func) {
         Matrix<T> result(m.getShape());
-        std::vector<T>& temp = result.getElements();
-        const std::vector<T>& values = m.getElements();
-        for (size_t i = 0; i < values.size(); i++) {
-            temp[i] = func(values[i]);
-        }
+        kernels::map(m.data(), result.data(), m.getShape().N, func);
         return result;
     }
 
     template <typename T, typename Func>
     Vector<T> transform(const Vector<T>& v, Func func) {
         Vector<T> result(v.getSize());
-        std::vector<T>& temp = result.getElements();
-        const std::vector<T>& values = v.getElements();
-        for (size_t i = 0; i < values.size(); i++) {
-            temp[i] = func(values[i]);
-        }
+        kernels::map(v.data(), result.data(), v.getSize(), func);
         return result;
     }
 
@@ -107,12 +100,7 @@ namespace linalg {
         if (S1 != S2) throw linalg::MismatchedShapes(S1, S2);
 
         Matrix<T> result(S1);
-        std::vector<T>& temp = result.getElements();
-        const std::vector<T>& values1 = m1.getElements();
-        const std::vector<T>& values2 = m2.getElements();
-        for (size_t i = 0; i < S1.N; i++) {
-            temp[i] = func(values1[i], values2[i]);
-        }
+        kernels::zip(m1.data(), m2.data(), result.data(), S1.N, func);
         return result;
     }
 
@@ -123,15 +111,50 @@ namespace linalg {
         if (N1 != N2) throw linalg::MismatchedNumberOfElements(N1,N2);
         
         Vector<T> result(N1);
-        std::vector<T>& temp = result.getElements();
-        const std::vector<T>& values1 = v1.getElements();
-        const std::vector<T>& values2 = v2.getElements();
-        for (size_t i = 0; i < N1; i++) {
-            temp[i] = func(values1[i], values2[i]);
-        }
+        kernels::zip(v1.data(), v2.data(), result.data(), N1, func);
         return result;
     }
 
+    // In-place transforms
+    template <typename T, typename Func>
+    void transformInto(const Matrix<T>& m, Matrix<T>& out, Func func) {
+        const Shape& S = m.getShape();
+        if (out.getShape() != S) out.resize(S.rows, S.cols);
+        kernels::map(m.data(), out.data(), S.N, func);
+    }
+
+    template <typename T, typename Func>
+    void transformInto(const Matrix<T>& m1, const Matrix<T>& m2, Matrix<T>& out, Func func) {
+        const Shape& S1 = m1.getShape();
+        const Shape& S2 = m2.getShape();
+        if (S1 != S2) throw linalg::MismatchedShapes(S1, S2);
+        if (out.getShape() != S1) out.resize(S1.rows, S1.cols);
+        kernels::zip(m1.data(), m2.data(), out.data(), S1.N, func);
+    }
+
+    template <typename T, typename Func>
+    T transformSum(const Matrix<T>& m1, const Matrix<T>& m2, Func func) {
+        const Shape& S1 = m1.getShape();
+        const Shape& S2 = m2.getShape();
+        if (S1 != S2) throw linalg::MismatchedShapes(S1, S2);
+        const T* a = m1.data();
+        const T* b = m2.data();
+        T total = 0;
+        for (size_t i = 0; i < S1.N; i++) {
+            total += func(a[i], b[i]);
+        }
+        return total;
+    }
+
+    template <typename T, typename Func, typename Term>
+    T transformSumInto(const Matrix<T>& m1, const Matrix<T>& m2, Matrix<T>& out, Func func, Term term) {
+        const Shape& S1 = m1.getShape();
+        const Shape& S2 = m2.getShape();
+        if (S1 != S2) throw linalg::MismatchedShapes(S1, S2);
+        if (out.getShape() != S1) out.resize(S1.rows, S1.cols);
+        return kernels::zipSum(m1.data(), m2.data(), out.data(), S1.N, func, term);
+    }
+
 	// Ternary and above (ATTENTION: DOES NOT VERIFY SHAPE/SIZE)
     template <typename T, typename Func, typename... Matrices>
     Matrix<T> transform(Func func, const Matrix<T>& first, const Matrices& ...rest) {
@@ -141,9 +164,7 @@ namespace linalg {
     	}
 		
 		Matrix<T> result(S);
-		const T* first_ptr = &first[0];
-		const T* rest_ptr[] = { (&rest[0])... };
-		T* temp_ptr = &result.getElements();
+		T* temp_ptr = result.data();
 		for (size_t i = 0; i < S.N; ++i) {
 			temp_ptr[i] = func(first[i], rest[i]...);
 		}
@@ -158,9 +179,7 @@ namespace linalg {
     	}
 		
 		Vector<T> result(N);
-		const T* first_ptr = &first[0];
-		const T* rest_ptr[] = { (&rest[0])... };
-		T* temp_ptr = &result.getElements();
+		T* temp_ptr = result.data();
 		for (size_t i = 0; i < N; ++i) {
 			temp_ptr[i] = func(first[i], rest[i]...);
 		}
@@ -0,0 +1,285 @@
+#ifndef LINALG_CST_LIB_INSTRUMENTATION_H
+#define LINALG_CST_LIB_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace linalg {
+    /**
+     * @namespace linalg::instrumentation
+     * @brief Opt-in accounting of Matrix/Vector lifetime events, heap allocations and kernel work.
+     *
+     * Compiled in only when LINALG_INSTRUMENTATION is defined; otherwise every hook is an
+     * empty inline function and snapshots are all zeros.
+     *
+     * Each thread updates its own counters (single writer, relaxed atomics, no locks), which
+     * are registered in a global list so that globalSnapshot() can aggregate every thread,
+     * including threads that already exited.
+     *
+     * @example
+     *   instrumentation::ScopedSnapshot epoch;
+     *   model.fit(x_train, y_train, 1);
+     *   double per_sample = epoch.delta().allocationsPer(x_train.getShape().rows);
+     */
+    namespace instrumentation {
+
+#ifdef LINALG_INSTRUMENTATION
+        inline constexpr bool enabled = true;
+#else
+        inline constexpr bool enabled = false;
+#endif
+
+        /**
+         * @brief Kernel families counted by the raw-pointer kernels (see linalg::kernels).
+         */
+        enum class Kernel : size_t {
+            GEMM,               ///< gemm, gemmTransposedA, gemmTransposedB
+            GEMM_EPILOGUE,      ///< Fused products (gemmEpilogue, gemmTransposedBEpilogue, gemmPackedEpilogue, gemmInt8Epilogue)
+            TRANSPOSE,
+            ELEMENT_WISE,       ///< map, zip, zipSum, quantizeInt8, row-wise softmax kernels, gatherRows
+            REDUCTION,          ///< sum, max, dot
+            COUNT
+        };
+
+        inline constexpr size_t KERNEL_COUNT = static_cast<size_t>(Kernel::COUNT);
+
+        /**
+         * @brief Plain copy of the counters at one point in time.
+         */
+        struct Snapshot {
+            uint64_t constructions = 0;     ///< Owning Matrix/Vector constructions (views excluded)
+            uint64_t copies = 0;            ///< Copy constructions and copy assignments
+            uint64_t moves = 0;             ///< Move constructions and move assignments
+            uint64_t allocations = 0;       ///< Heap (re)allocations of element buffers
+            uint64_t bytes_allocated = 0;
+            std::array<uint64_t, KERNEL_COUNT> kernel_calls{};
+            std::array<uint64_t, KERNEL_COUNT> kernel_flops{};
+
+            Snapshot operator-(const Snapshot& other) const {
+                Snapshot r;
+                r.constructions = constructions - other.constructions;
+                r.copies = copies - other.copies;
+                r.moves = moves - other.moves;
+                r.allocations = allocations - other.allocations;
+                r.bytes_allocated = bytes_allocated - other.bytes_allocated;
+                for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                    r.kernel_calls[k] = kernel_calls[k] - other.kernel_calls[k];
+                    r.kernel_flops[k] = kernel_flops[k] - other.kernel_flops[k];
+                }
+                return r;
+            }
+
+            Snapshot& operator+=(const Snapshot& other) {
+                constructions += other.constructions;
+                copies += other.copies;
+                moves += other.moves;
+                allocations += other.allocations;
+                bytes_allocated += other.bytes_allocated;
+                for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                    kernel_calls[k] += other.kernel_calls[k];
+                    kernel_flops[k] += other.kernel_flops[k];
+                }
+                return *this;
+            }
+
+            uint64_t calls(Kernel kernel) const { return kernel_calls[static_cast<size_t>(kernel)]; }
+            uint64_t flops(Kernel kernel) const { return kernel_flops[static_cast<size_t>(kernel)]; }
+
+            uint64_t totalFlops() const {
+                uint64_t total = 0;
+                for (uint64_t f : kernel_flops) total += f;
+                return total;
+            }
+
+            /**
+             * @brief Allocations per unit of work (e.g. per training sample).
+             */
+            double allocationsPer(size_t units) const {
+                return units ? static_cast<double>(allocations) / units : 0.0;
+            }
+
+            std::string toString() const {
+                static const char* names[KERNEL_COUNT] = {"gemm", "gemm_epilogue", "transpose", "element_wise", "reduction"};
+                std::string s = "constructions=" + std::to_string(constructions)
+                              + " copies=" + std::to_string(copies)
+                              + " moves=" + std::to_string(moves)
+                              + " allocations=" + std::to_string(allocations)
+                              + " bytes=" + std::to_string(bytes_allocated);
+                for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                    if (kernel_calls[k] == 0) continue;
+                    s += std::string(" ") + names[k] + "=" + std::to_string(kernel_calls[k])
+                       + "(" + std::to_string(kernel_flops[k]) + " flops)";
+                }
+                return s;
+            }
+        };
+
+        namespace detail {
+            /**
+             * @brief Live counters of one thread. Only the owning thread writes them, so
+             * increments are relaxed load+store pairs (no locked read-modify-write).
+             */
+            struct ThreadCounters {
+                std::atomic<uint64_t> constructions{0};
+                std::atomic<uint64_t> copies{0};
+                std::atomic<uint64_t> moves{0};
+                std::atomic<uint64_t> allocations{0};
+                std::atomic<uint64_t> bytes_allocated{0};
+                std::array<std::atomic<uint64_t>, KERNEL_COUNT> kernel_calls{};
+                std::array<std::atomic<uint64_t>, KERNEL_COUNT> kernel_flops{};
+
+                Snapshot load() const {
+                    Snapshot s;
+                    s.constructions = constructions.load(std::memory_order_relaxed);
+                    s.copies = copies.load(std::memory_order_relaxed);
+                    s.moves = moves.load(std::memory_order_relaxed);
+                    s.allocations = allocations.load(std::memory_order_relaxed);
+                    s.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+                    for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                        s.kernel_calls[k] = kernel_calls[k].load(std::memory_order_relaxed);
+                        s.kernel_flops[k] = kernel_flops[k].load(std::memory_order_relaxed);
+                    }
+                    return s;
+                }
+            };
+
+            inline void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+                counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            struct Registry {
+                std::mutex mutex;
+                std::vector<const ThreadCounters*> live;
+                Snapshot retired; // Totals of threads that already exited
+            };
+
+            inline Registry& registry() {
+                static Registry instance;
+                return instance;
+            }
+
+            /**
+             * @brief Registers the thread's counters on first use and folds them into the
+             * retired totals when the thread exits.
+             */
+            struct ThreadHolder {
+                ThreadCounters counters;
+                ThreadHolder() {
+                    std::lock_guard<std::mutex> lock(registry().mutex);
+                    registry().live.push_back(&counters);
+                }
+                ~ThreadHolder() {
+                    Registry& r = registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    r.retired += counters.load();
+                    r.live.erase(std::remove(r.live.begin(), r.live.end(), &counters), r.live.end());
+                }
+            };
+
+            inline ThreadCounters& local() {
+                thread_local ThreadHolder holder;
+                return holder.counters;
+            }
+        }
+
+        // ========== HOOKS (no-ops unless LINALG_INSTRUMENTATION) ==========
+
+        inline void onConstruction() {
+            if constexpr (enabled) detail::bump(detail::local().constructions, 1);
+        }
+
+        inline void onCopy() {
+            if constexpr (enabled) detail::bump(detail::local().copies, 1);
+        }
+
+        inline void onMove() {
+            if constexpr (enabled) detail::bump(detail::local().moves, 1);
+        }
+
+        inline void onAllocation(size_t bytes) {
+            if constexpr (enabled) {
+                if (bytes == 0) return;
+                detail::ThreadCounters& c = detail::local();
+                detail::bump(c.allocations, 1);
+                detail::bump(c.bytes_allocated, bytes);
+            }
+        }
+
+        /**
+         * @brief Records an allocation if a buffer's capacity changed (i.e. it was reallocated).
+         */
+        inline void onCapacityChange(size_t capacity_before, size_t capacity_after, size_t element_size) {
+            if constexpr (enabled) {
+                if (capacity_after != capacity_before) onAllocation(capacity_after * element_size);
+            }
+        }
+
+        inline void onKernel(Kernel kernel, uint64_t flops) {
+            if constexpr (enabled) {
+                detail::ThreadCounters& c = detail::local();
+                detail::bump(c.kernel_calls[static_cast<size_t>(kernel)], 1);
+                detail::bump(c.kernel_flops[static_cast<size_t>(kernel)], flops);
+            }
+        }
+
+        // ========== QUERIES ==========
+
+        /**
+         * @brief Counters of the calling thread.
+         */
+        inline Snapshot threadSnapshot() {
+            if constexpr (enabled) return detail::local().load();
+            return Snapshot();
+        }
+
+        /**
+         * @brief Sum of the counters of every thread (live and exited).
+         */
+        inline Snapshot globalSnapshot() {
+            if constexpr (enabled) {
+                detail::Registry& r = detail::registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                Snapshot total = r.retired;
+                for (const detail::ThreadCounters* c : r.live) {
+                    total += c->load();
+                }
+                return total;
+            }
+            return Snapshot();
+        }
+
+        /**
+         * @brief Captures the counters on construction; delta() returns what happened since.
+         *
+         * Thread scope (default) only sees the calling thread; global scope aggregates all threads.
+         */
+        class ScopedSnapshot {
+        private:
+            bool global;
+            Snapshot start;
+
+        public:
+            explicit ScopedSnapshot(bool global = false) :
+                global(global),
+                start(global ? globalSnapshot() : threadSnapshot())
+            {
+            }
+
+            Snapshot delta() const {
+                return (global ? globalSnapshot() : threadSnapshot()) - start;
+            }
+
+            void reset() {
+                start = global ? globalSnapshot() : threadSnapshot();
+            }
+        };
+    }
+}
+
+#endif // LINALG_CST_LIB_INSTRUMENTATION_H
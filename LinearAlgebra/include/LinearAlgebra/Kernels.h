@@ -0,0 +1,263 @@
+#ifndef LINALG_CST_LIB_KERNELS_H
+#define LINALG_CST_LIB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Epilogue.h"
+#include "Instrumentation.h"
+
+namespace linalg {
+    /**
+     * @namespace linalg::kernels
+     * @brief Raw-pointer compute kernels shared by Matrix, Vector and Tensor.
+     *
+     * Every container in the library is a thin shape/ownership wrapper around a flat,
+     * row-major buffer. The arithmetic itself lives here, on plain pointers, so that
+     * different containers (and views into each other's memory) run the exact same loops.
+     *
+     * The kernels perform no shape validation: callers are responsible for passing
+     * consistent dimensions and buffers that do not alias the output (unless stated).
+     */
+    namespace kernels {
+
+        // ========== MATRIX PRODUCTS ==========
+
+        /**
+         * @brief C = A * B, with A (M x K) and B (K x N), all row-major.
+         *
+         * Uses the i-k-j ordering so the innermost loop streams through rows of B and C.
+         * When N == 1 (matrix-vector product) each output is accumulated in a register.
+         */
+        template <typename T>
+        void gemm(const T* A, const T* B, T* C, size_t M, size_t K, size_t N);
+
+        /**
+         * @brief C = A^T * B, with A stored as (K x M) and B as (K x N).
+         * @see rankUpdate()
+         */
+        template <typename T>
+        void gemmTransposedA(const T* A, const T* B, T* C, size_t M, size_t K, size_t N);
+
+        /// Outer products applied per pass over C by rankUpdate()
+        inline constexpr size_t RANK_BLOCK = 4;
+
+        /**
+         * @brief C += A^T * B, with A stored as (K x M) and B as (K x N): a rank-K update of C.
+         *
+         * Row k of A and row k of B form one outer product (e.g. a sample's delta and input).
+         * RANK_BLOCK of them are summed in registers before C is touched, so C is read and
+         * written K / RANK_BLOCK times instead of once per outer product.
+         */
+        template <typename T>
+        void rankUpdate(const T* A, const T* B, T* C, size_t M, size_t K, size_t N);
+
+        /**
+         * @brief C = A * B^T, with A stored as (M x K) and B as (N x K).
+         *
+         * Every output element is a contiguous dot product, accumulated in registers.
+         */
+        template <typename T>
+        void gemmTransposedB(const T* A, const T* B, T* C, size_t M, size_t K, size_t N);
+
+        /**
+         * @brief Y = act(pre(A * B)), with A (M x K) and B (K x N), fused into the product.
+         *
+         * Each output row is accumulated exactly as in gemm() and the epilogue is applied
+         * while the row is still in registers/L1, so the output is written once instead of
+         * being re-read by separate bias and activation passes.
+         * @param pre Pre stage `T(T acc, size_t i, size_t j)` producing the pre-activation z
+         * @param act Activation stage `T(T z)` producing the stored output y
+         * @param Z Optional (M x N) buffer receiving z (skipped when nullptr), or dy/dz when act is
+         *          an epilogue::WithGrad stage. May not alias Y.
+         * @see linalg::epilogue
+         */
+        template <typename T, typename Pre, typename Act>
+        void gemmEpilogue(const T* A, const T* B, T* Y, size_t M, size_t K, size_t N,
+                          Pre pre, Act act, T* Z = nullptr);
+
+        /**
+         * @brief Y = act(pre(A * B^T)), with A stored as (M x K) and B as (N x K).
+         *
+         * Same contract as gemmEpilogue(); every accumulator is a register dot product.
+         */
+        template <typename T, typename Pre, typename Act>
+        void gemmTransposedBEpilogue(const T* A, const T* B, T* Y, size_t M, size_t K, size_t N,
+                                     Pre pre, Act act, T* Z = nullptr);
+
+        // ========== PACKED PRODUCTS ==========
+
+        /// Output rows per packed panel: one SIMD-friendly accumulator row of the micro-kernel
+        inline constexpr size_t PACK_PANEL = 8;
+        /// Input rows (samples) per micro-kernel tile: each loaded panel row is reused this many times
+        inline constexpr size_t PACK_ROWS = 4;
+
+        /**
+         * @brief Number of elements of W (N x K) once packed by packPanels().
+         */
+        inline size_t packedPanelsSize(size_t N, size_t K) {
+            return (N + PACK_PANEL - 1) / PACK_PANEL * PACK_PANEL * K;
+        }
+
+        /**
+         * @brief Re-lays out W (N x K, row-major) into panels of PACK_PANEL rows interleaved by k:
+         * packed[(p*K + k)*PACK_PANEL + r] = W[(p*PACK_PANEL + r)*K + k].
+         *
+         * The micro-kernel then reads one contiguous PACK_PANEL-wide row per k, which maps to
+         * full vector loads. The last panel is zero-padded.
+         * @param packed Buffer of packedPanelsSize(N, K) elements
+         */
+        template <typename T>
+        void packPanels(const T* W, T* packed, size_t N, size_t K);
+
+        /**
+         * @brief Y = act(pre(X * W^T)), with X (M x K), Y (M x N) and W (N x K) packed by packPanels().
+         *
+         * Register-tiled micro-kernel: a PACK_ROWS x PACK_PANEL block of accumulators is updated
+         * with independent vertical multiply-adds (no horizontal reduction, so it vectorizes
+         * without fast-math), and the epilogue runs on the registers before the single store.
+         * M == 1 (matrix-vector product) runs the same kernel with a one-row tile.
+         * @see gemmTransposedBEpilogue, linalg::epilogue
+         */
+        template <typename T, typename Pre, typename Act>
+        void gemmPackedEpilogue(const T* X, const T* packed, T* Y, size_t M, size_t K, size_t N,
+                                Pre pre, Act act);
+
+        // ========== INT8 PRODUCTS ==========
+
+        /// Length of the fixed k blocks of the int8 micro-kernel
+        inline constexpr size_t INT8_BLOCK = 16;
+        /// Rows of W per int8 micro-kernel tile: each widened input block is reused this many times
+        inline constexpr size_t INT8_COLS = 4;
+
+        /**
+         * @brief Y = act(dequant(X * W^T)) on int8 operands, with X (M x K), Y (M x N) and W (N x K),
+         * all row-major.
+         *
+         * Products are accumulated exactly in int32 (with |x|, |w| <= 127 that holds for any
+         * K < 2^17). Integer addition is associative, so the reduction over k vectorizes into
+         * widening multiply-adds without fast-math. A PACK_ROWS x INT8_COLS tile shares every
+         * widened block of X and W, and the epilogue maps the accumulators back to float before the store.
+         * @param dequant Pre stage `float(int32_t acc, size_t i, size_t j)`, e.g. epilogue::Dequantize
+         * @param act Activation stage `float(float z)`
+         * @see quantizeInt8
+         */
+        template <typename Dequant, typename Act>
+        void gemmInt8Epilogue(const int8_t* X, const int8_t* W, float* Y, size_t M, size_t K, size_t N,
+                              Dequant dequant, Act act);
+
+        /**
+         * @brief Symmetric int8 quantization: out[i] = clamp(round(a[i] / scale), -127, 127).
+         */
+        inline void quantizeInt8(const float* a, int8_t* out, size_t n, float scale);
+
+        /**
+         * @brief Dot product of two contiguous arrays of length n.
+         */
+        template <typename T>
+        T dot(const T* a, const T* b, size_t n);
+
+        /**
+         * @brief Cache-blocked out-of-place transpose: B (cols x rows) = A^T (rows x cols).
+         */
+        template <typename T>
+        void transpose(const T* A, T* B, size_t rows, size_t cols, size_t block_size);
+
+        // ========== ELEMENT-WISE ==========
+
+        /**
+         * @brief out[i] = func(a[i]) for i in [0, n). `out` may alias `a`.
+         */
+        template <typename T, typename Func>
+        void map(const T* a, T* out, size_t n, Func func);
+
+        /**
+         * @brief out[i] = func(a[i], b[i]) for i in [0, n). `out` may alias `a` or `b`.
+         */
+        template <typename T, typename Func>
+        void zip(const T* a, const T* b, T* out, size_t n, Func func);
+
+        /**
+         * @brief zip() that also returns the sum of term(a[i], b[i]), in the same pass: e.g. a loss
+         * gradient and the loss itself. `out` may alias `a` or `b`.
+         */
+        template <typename T, typename Func, typename Term>
+        T zipSum(const T* a, const T* b, T* out, size_t n, Func func, Term term);
+
+        // ========== ROW-WISE ==========
+
+        /**
+         * @brief Softmax of each of the M rows of N: out = exp(x - max) / sum(exp(x - max)).
+         *
+         * Subtracting the row maximum keeps exp() in range for any input. `out` may alias `X`.
+         */
+        template <typename T>
+        void softmaxRows(const T* X, T* out, size_t M, size_t N);
+
+        /**
+         * @brief Backward through softmaxRows(): out = P * (G - sum_j G_j P_j), row by row.
+         *
+         * P holds the softmax outputs and G the gradient with respect to them. `out` may alias `G`.
+         */
+        template <typename T>
+        void softmaxBackwardRows(const T* P, const T* G, T* out, size_t M, size_t N);
+
+        /**
+         * @brief Fused softmax + cross-entropy on M rows of N logits.
+         *
+         * Per row, with lse = log(sum_j exp(Z_j)) computed from the row maximum (log-sum-exp), the
+         * loss is sum_j T_j (lse - Z_j) = -sum_j T_j log(softmax(Z)_j), and the gradient with
+         * respect to the logits is softmax(Z) - T when the targets of the row sum to 1. One visit
+         * per row: the exponentials are stored in G and normalized in place.
+         * @param G Gradient output (M x N), or nullptr when only the loss is needed. May alias Z.
+         * @return Loss summed over the rows
+         */
+        template <typename T>
+        T softmaxCrossEntropy(const T* Z, const T* targets, T* G, size_t M, size_t N);
+
+        /// Rows ahead of the current one whose first cache lines gatherRows() prefetches
+        inline constexpr size_t GATHER_DISTANCE = 8;
+        /// Cache lines prefetched per row: the hardware prefetcher follows the rest of a long row
+        inline constexpr size_t GATHER_LINES = 4;
+
+        /**
+         * @brief out row i = src row rows[i], for `count` rows of `cols` elements.
+         *
+         * Assembles a contiguous batch from scattered rows (e.g. a shuffled mini-batch). Each row is
+         * one vectorized copy; since the rows of a random permutation defeat the stride-following
+         * hardware prefetcher, the row GATHER_DISTANCE ahead is prefetched while the current one is copied.
+         * `out` must not overlap `src`.
+         */
+        template <typename T, typename Index>
+        void gatherRows(const T* src, const Index* rows, size_t count, size_t cols, T* out);
+
+        // ========== REDUCTIONS ==========
+
+        /**
+         * @brief Sum of the n elements of a.
+         */
+        template <typename T>
+        T sum(const T* a, size_t n);
+
+        /**
+         * @brief Column sums of a row-major (rows x cols) matrix: out[j] = sum_i A[i*cols + j].
+         */
+        template <typename T>
+        void sumColumns(const T* A, T* out, size_t rows, size_t cols);
+
+        /**
+         * @brief Accumulating column sums: out[j] += sum_i A[i*cols + j].
+         */
+        template <typename T>
+        void addColumnSums(const T* A, T* out, size_t rows, size_t cols);
+
+        /**
+         * @brief Maximum of the n elements of a (n must be > 0).
+         */
+        template <typename T>
+        T max(const T* a, size_t n);
+    }
+}
+
+#include "Kernels.tpp"
+
+#endif // LINALG_CST_LIB_KERNELS_H
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <cmath>
+#include "Kernels.h"
+
+namespace linalg::kernels {
+
+    namespace detail {
+        // Uncounted dot product, shared by the products below
+        template <typename T>
+        T dot(const T* a, const T* b, size_t n) {
+            // Four independent accumulators break the add dependency chain
+            T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            size_t k = 0;
+            for (; k + 4 <= n; k += 4) {
+                s0 += a[k]     * b[k];
+                s1 += a[k + 1] * b[k + 1];
+                s2 += a[k + 2] * b[k + 2];
+                s3 += a[k + 3] * b[k + 3];
+            }
+            for (; k < n; k++) {
+                s0 += a[k] * b[k];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        // ROWS x PACK_PANEL output tile of gemmPackedEpilogue(), for every panel
+        template <size_t ROWS, typename T, typename Pre, typename Act>
+        void packedTile(const T* X, const T* packed, T* Y, size_t row, size_t K, size_t N, Pre pre, Act act) {
+            constexpr size_t P = PACK_PANEL;
+            for (size_t j0 = 0; j0 < N; j0 += P) {
+                const T* panel = packed + j0*K;
+                // Rows unrolled so the whole tile stays in registers. The column loop is kept as a loop:
+                // it is the one to vectorize (unrolled early, the compiler vectorizes over k instead)
+                T acc[ROWS][P] = {};
+                for (size_t k = 0; k < K; k++) {
+                    const T* w = panel + k*P;
+                    #pragma GCC unroll 8
+                    for (size_t r = 0; r < ROWS; r++) {
+                        const T x = X[r*K + k];
+                        #pragma GCC unroll 1
+                        for (size_t c = 0; c < P; c++) {
+                            acc[r][c] += x * w[c];
+                        }
+                    }
+                }
+                const size_t cols = std::min(P, N - j0);
+                for (size_t r = 0; r < ROWS; r++) {
+                    for (size_t c = 0; c < cols; c++) {
+                        Y[r*N + j0 + c] = act(pre(acc[r][c], row + r, j0 + c));
+                    }
+                }
+            }
+        }
+
+        // ROWS x COLS output tile of gemmInt8Epilogue() at (row, col)
+        template <size_t ROWS, size_t COLS, typename Dequant, typename Act>
+        void int8Tile(const int8_t* X, const int8_t* W, float* Y, size_t row, size_t col, size_t K, size_t N,
+                      Dequant dequant, Act act) {
+            constexpr size_t B = INT8_BLOCK;
+            const size_t K_blocked = K / B * B;
+            int32_t acc[ROWS][COLS] = {};
+            for (size_t k0 = 0; k0 < K_blocked; k0 += B) {
+                // Both operands are widened once per block and reused across the tile. Fixed-length
+                // blocks vectorize even at -O2; the inner loops are kept as loops because, fully
+                // unrolled first (-O3), they are no longer vectorized
+                int16_t wb[COLS][B];
+                #pragma GCC unroll 4
+                for (size_t c = 0; c < COLS; c++) {
+                    #pragma GCC unroll 1
+                    for (size_t t = 0; t < B; t++) {
+                        wb[c][t] = W[(col + c)*K + k0 + t];
+                    }
+                }
+                #pragma GCC unroll 8
+                for (size_t r = 0; r < ROWS; r++) {
+                    int16_t xb[B];
+                    #pragma GCC unroll 1
+                    for (size_t t = 0; t < B; t++) {
+                        xb[t] = X[r*K + k0 + t];
+                    }
+                    #pragma GCC unroll 4
+                    for (size_t c = 0; c < COLS; c++) {
+                        int32_t s = 0;
+                        #pragma GCC unroll 1
+                        for (size_t t = 0; t < B; t++) {
+                            s += int32_t(xb[t]) * int32_t(wb[c][t]);
+                        }
+                        acc[r][c] += s;
+                    }
+                }
+            }
+            for (size_t k = K_blocked; k < K; k++) {
+                for (size_t r = 0; r < ROWS; r++) {
+                    for (size_t c = 0; c < COLS; c++) {
+                        acc[r][c] += int32_t(X[r*K + k]) * int32_t(W[(col + c)*K + k]);
+                    }
+                }
+            }
+            for (size_t r = 0; r < ROWS; r++) {
+                for (size_t c = 0; c < COLS; c++) {
+                    Y[r*N + col + c] = act(dequant(acc[r][c], row + r, col + c));
+                }
+            }
+        }
+
+        // Every column of ROWS consecutive rows of gemmInt8Epilogue()
+        template <size_t ROWS, typename Dequant, typename Act>
+        void int8Rows(const int8_t* X, const int8_t* W, float* Y, size_t row, size_t K, size_t N,
+                      Dequant dequant, Act act) {
+            constexpr size_t COLS = INT8_COLS;
+            size_t j = 0;
+            for (; j + COLS <= N; j += COLS) {
+                int8Tile<ROWS, COLS>(X, W, Y, row, j, K, N, dequant, act);
+            }
+            for (; j < N; j++) {
+                int8Tile<ROWS, 1>(X, W, Y, row, j, K, N, dequant, act);
+            }
+        }
+    }
+
+    namespace detail {
+        // Uncounted rank-K update, shared by gemmTransposedA() and rankUpdate()
+        template <typename T>
+        void rankUpdate(const T* A, const T* B, T* C, size_t M, size_t K, size_t N) {
+            static_assert(RANK_BLOCK == 4, "rankUpdate() is unrolled for four outer products");
+            size_t k = 0;
+            for (; k + RANK_BLOCK <= K; k += RANK_BLOCK) {
+                const T* B0 = B + k*N;
+                const T* B1 = B0 + N;
+                const T* B2 = B1 + N;
+                const T* B3 = B2 + N;
+                for (size_t i = 0; i < M; i++) {
+                    const T a0 = A[k*M + i];
+                    const T a1 = A[(k + 1)*M + i];
+                    const T a2 = A[(k + 2)*M + i];
+                    const T a3 = A[(k + 3)*M + i];
+                    T* C_row = C + i*N;
+                    // The four B rows stay in L1 while every row of C is updated once
+                    for (size_t j = 0; j < N; j++) {
+                        C_row[j] += a0 * B0[j] + a1 * B1[j] + a2 * B2[j] + a3 * B3[j];
+                    }
+                }
+            }
+            for (; k < K; k++) {
+                const T* A_row = A + k*M;
+                const T* B_row = B + k*N;
+                for (size_t i = 0; i < M; i++) {
+                    const T A_ki = A_row[i];
+                    T* C_row = C + i*N;
+                    for (size_t j = 0; j < N; j++) {
+                        C_row[j] += A_ki * B_row[j];
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    T dot(const T* a, const T* b, size_t n) {
+        instrumentation::onKernel(instrumentation::Kernel::REDUCTION, 2*n);
+        return detail::dot(a, b, n);
+    }
+
+    template <typename T>
+    void gemm(const T* A, const T* B, T* C, size_t M, size_t K, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM, 2*M*K*N);
+        // Matrix-vector product: one register accumulator per output
+        if (N == 1) {
+            for (size_t i = 0; i < M; i++) {
+                C[i] = detail::dot(A + i*K, B, K);
+            }
+            return;
+        }
+        for (size_t i = 0; i < M; i++) {
+            T* C_row = C + i*N;
+            std::fill(C_row, C_row + N, T(0));
+            for (size_t k = 0; k < K; k++) {
+                const T A_ik = A[i*K + k];
+                const T* B_row = B + k*N;
+                // Internal loop with sequential acesses in memory (only j changes)
+                for (size_t j = 0; j < N; j++) {
+                    C_row[j] += A_ik * B_row[j];
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void gemmTransposedA(const T* A, const T* B, T* C, size_t M, size_t K, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM, 2*M*K*N);
+        std::fill(C, C + M*N, T(0));
+        detail::rankUpdate(A, B, C, M, K, N);
+    }
+
+    template <typename T>
+    void rankUpdate(const T* A, const T* B, T* C, size_t M, size_t K, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM, 2*M*K*N);
+        detail::rankUpdate(A, B, C, M, K, N);
+    }
+
+    template <typename T>
+    void gemmTransposedB(const T* A, const T* B, T* C, size_t M, size_t K, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM, 2*M*K*N);
+        for (size_t i = 0; i < M; i++) {
+            const T* A_row = A + i*K;
+            for (size_t j = 0; j < N; j++) {
+                C[i*N + j] = detail::dot(A_row, B + j*K, K);
+            }
+        }
+    }
+
+    template <typename T, typename Pre, typename Act>
+    void gemmEpilogue(const T* A, const T* B, T* Y, size_t M, size_t K, size_t N,
+                      Pre pre, Act act, T* Z) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM_EPILOGUE, 2*M*K*N);
+        // Matrix-vector product: the epilogue runs directly on the register accumulator
+        if (N == 1) {
+            for (size_t i = 0; i < M; i++) {
+                const T z = pre(detail::dot(A + i*K, B, K), i, size_t(0));
+                const T y = act(z);
+                if (Z) Z[i] = epilogue::secondOutput(act, z, y);
+                Y[i] = y;
+            }
+            return;
+        }
+        for (size_t i = 0; i < M; i++) {
+            T* Y_row = Y + i*N;
+            std::fill(Y_row, Y_row + N, T(0));
+            for (size_t k = 0; k < K; k++) {
+                const T A_ik = A[i*K + k];
+                const T* B_row = B + k*N;
+                for (size_t j = 0; j < N; j++) {
+                    Y_row[j] += A_ik * B_row[j];
+                }
+            }
+            // Row is still hot in cache: finish it before moving on
+            if (Z) {
+                T* Z_row = Z + i*N;
+                for (size_t j = 0; j < N; j++) {
+                    const T z = pre(Y_row[j], i, j);
+                    const T y = act(z);
+                    Z_row[j] = epilogue::secondOutput(act, z, y);
+                    Y_row[j] = y;
+                }
+            } else {
+                for (size_t j = 0; j < N; j++) {
+                    Y_row[j] = act(pre(Y_row[j], i, j));
+                }
+            }
+        }
+    }
+
+    template <typename T, typename Pre, typename Act>
+    void gemmTransposedBEpilogue(const T* A, const T* B, T* Y, size_t M, size_t K, size_t N,
+                                 Pre pre, Act act, T* Z) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM_EPILOGUE, 2*M*K*N);
+        for (size_t i = 0; i < M; i++) {
+            const T* A_row = A + i*K;
+            for (size_t j = 0; j < N; j++) {
+                const T z = pre(detail::dot(A_row, B + j*K, K), i, j);
+                const T y = act(z);
+                if (Z) Z[i*N + j] = epilogue::secondOutput(act, z, y);
+                Y[i*N + j] = y;
+            }
+        }
+    }
+
+    template <typename T>
+    void packPanels(const T* W, T* packed, size_t N, size_t K) {
+        constexpr size_t P = PACK_PANEL;
+        for (size_t j0 = 0; j0 < N; j0 += P) {
+            T* panel = packed + j0*K;
+            for (size_t k = 0; k < K; k++) {
+                for (size_t c = 0; c < P; c++) {
+                    panel[k*P + c] = j0 + c < N ? W[(j0 + c)*K + k] : T(0);
+                }
+            }
+        }
+    }
+
+    template <typename T, typename Pre, typename Act>
+    void gemmPackedEpilogue(const T* X, const T* packed, T* Y, size_t M, size_t K, size_t N,
+                            Pre pre, Act act) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM_EPILOGUE, 2*M*K*N);
+        size_t i = 0;
+        for (; i + PACK_ROWS <= M; i += PACK_ROWS) {
+            detail::packedTile<PACK_ROWS>(X + i*K, packed, Y + i*N, i, K, N, pre, act);
+        }
+        for (; i < M; i++) {
+            detail::packedTile<1>(X + i*K, packed, Y + i*N, i, K, N, pre, act);
+        }
+    }
+
+    template <typename Dequant, typename Act>
+    void gemmInt8Epilogue(const int8_t* X, const int8_t* W, float* Y, size_t M, size_t K, size_t N,
+                          Dequant dequant, Act act) {
+        instrumentation::onKernel(instrumentation::Kernel::GEMM_EPILOGUE, 2*M*K*N);
+        size_t i = 0;
+        for (; i + PACK_ROWS <= M; i += PACK_ROWS) {
+            detail::int8Rows<PACK_ROWS>(X + i*K, W, Y + i*N, i, K, N, dequant, act);
+        }
+        for (; i < M; i++) {
+            detail::int8Rows<1>(X + i*K, W, Y + i*N, i, K, N, dequant, act);
+        }
+    }
+
+    inline void quantizeInt8(const float* a, int8_t* out, size_t n, float scale) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, 2*n);
+        const float inverse = 1.0f / scale;
+        for (size_t i = 0; i < n; i++) {
+            const float q = std::nearbyint(a[i] * inverse);
+            out[i] = static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+        }
+    }
+
+    template <typename T>
+    void transpose(const T* A, T* B, size_t rows, size_t cols, size_t block_size) {
+        instrumentation::onKernel(instrumentation::Kernel::TRANSPOSE, 0);
+        for (size_t i = 0; i < rows; i+=block_size) {
+            for (size_t j=0; j < cols; j+=block_size) {
+                size_t i_end = std::min(i + block_size, rows);
+                size_t j_end = std::min(j + block_size, cols);
+                for (size_t bi = i; bi < i_end; bi++) {
+                    for (size_t bj = j; bj < j_end; bj++) {
+                        B[bj * rows + bi] = A[bi * cols + bj];
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename T, typename Func>
+    void map(const T* a, T* out, size_t n, Func func) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, n);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = func(a[i]);
+        }
+    }
+
+    template <typename T, typename Func>
+    void zip(const T* a, const T* b, T* out, size_t n, Func func) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, n);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = func(a[i], b[i]);
+        }
+    }
+
+    template <typename T, typename Func, typename Term>
+    T zipSum(const T* a, const T* b, T* out, size_t n, Func func, Term term) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, n);
+        // Four accumulators, as in sum(); the inputs of a block are read before out is written
+        T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const T a0 = a[i], a1 = a[i + 1], a2 = a[i + 2], a3 = a[i + 3];
+            const T b0 = b[i], b1 = b[i + 1], b2 = b[i + 2], b3 = b[i + 3];
+            s0 += term(a0, b0);
+            s1 += term(a1, b1);
+            s2 += term(a2, b2);
+            s3 += term(a3, b3);
+            out[i] = func(a0, b0);
+            out[i + 1] = func(a1, b1);
+            out[i + 2] = func(a2, b2);
+            out[i + 3] = func(a3, b3);
+        }
+        for (; i < n; i++) {
+            const T x = a[i], y = b[i];
+            s0 += term(x, y);
+            out[i] = func(x, y);
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    template <typename T>
+    T sum(const T* a, size_t n) {
+        instrumentation::onKernel(instrumentation::Kernel::REDUCTION, n);
+        T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += a[i];
+            s1 += a[i + 1];
+            s2 += a[i + 2];
+            s3 += a[i + 3];
+        }
+        for (; i < n; i++) {
+            s0 += a[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    template <typename T>
+    void sumColumns(const T* A, T* out, size_t rows, size_t cols) {
+        instrumentation::onKernel(instrumentation::Kernel::REDUCTION, rows*cols);
+        std::fill(out, out + cols, T(0));
+        // Row by row, so reads stay sequential
+        for (size_t i = 0; i < rows; i++) {
+            const T* A_row = A + i*cols;
+            for (size_t j = 0; j < cols; j++) {
+                out[j] += A_row[j];
+            }
+        }
+    }
+
+    template <typename T>
+    void addColumnSums(const T* A, T* out, size_t rows, size_t cols) {
+        instrumentation::onKernel(instrumentation::Kernel::REDUCTION, rows*cols);
+        for (size_t i = 0; i < rows; i++) {
+            const T* A_row = A + i*cols;
+            for (size_t j = 0; j < cols; j++) {
+                out[j] += A_row[j];
+            }
+        }
+    }
+
+    template <typename T>
+    void softmaxRows(const T* X, T* out, size_t M, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, M*N);
+        for (size_t i = 0; i < M; i++) {
+            const T* x = X + i*N;
+            T* y = out + i*N;
+            const T m = *std::max_element(x, x + N);
+            T total = 0;
+            for (size_t j = 0; j < N; j++) {
+                y[j] = std::exp(x[j] - m);
+                total += y[j];
+            }
+            const T inverse = T(1) / total;
+            for (size_t j = 0; j < N; j++) {
+                y[j] *= inverse;
+            }
+        }
+    }
+
+    template <typename T>
+    void softmaxBackwardRows(const T* P, const T* G, T* out, size_t M, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, M*N);
+        for (size_t i = 0; i < M; i++) {
+            const T* p = P + i*N;
+            const T* g = G + i*N;
+            T* d = out + i*N;
+            const T projection = detail::dot(g, p, N);
+            for (size_t j = 0; j < N; j++) {
+                d[j] = p[j] * (g[j] - projection);
+            }
+        }
+    }
+
+    template <typename T>
+    T softmaxCrossEntropy(const T* Z, const T* targets, T* G, size_t M, size_t N) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, M*N);
+        T loss = 0;
+        for (size_t i = 0; i < M; i++) {
+            const T* z = Z + i*N;
+            const T* t = targets + i*N;
+            const T m = *std::max_element(z, z + N);
+            // sum_j t_j (lse - z_j) = (sum_j t_j) * log(sum_j exp(z_j - m)) - sum_j t_j (z_j - m)
+            T total = 0, target_sum = 0, target_dot = 0;
+            if (G) {
+                T* g = G + i*N;
+                for (size_t j = 0; j < N; j++) {
+                    const T shifted = z[j] - m;
+                    target_sum += t[j];
+                    target_dot += t[j] * shifted;
+                    g[j] = std::exp(shifted);
+                    total += g[j];
+                }
+                const T inverse = T(1) / total;
+                for (size_t j = 0; j < N; j++) {
+                    g[j] = g[j] * inverse - t[j];
+                }
+            } else {
+                for (size_t j = 0; j < N; j++) {
+                    const T shifted = z[j] - m;
+                    target_sum += t[j];
+                    target_dot += t[j] * shifted;
+                    total += std::exp(shifted);
+                }
+            }
+            loss += target_sum * std::log(total) - target_dot;
+        }
+        return loss;
+    }
+
+    template <typename T, typename Index>
+    void gatherRows(const T* src, const Index* rows, size_t count, size_t cols, T* out) {
+        instrumentation::onKernel(instrumentation::Kernel::ELEMENT_WISE, count*cols);
+        constexpr size_t LINE = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+        const size_t prefetched = std::min(cols, GATHER_LINES * LINE);
+        auto prefetch = [&](size_t i) {
+#if defined(__GNUC__) || defined(__clang__)
+            const T* ahead = src + static_cast<size_t>(rows[i])*cols;
+            for (size_t k = 0; k < prefetched; k += LINE) {
+                __builtin_prefetch(ahead + k, 0, 3);
+            }
+#endif
+        };
+        // The first rows are requested together, then each iteration requests one row ahead
+        for (size_t i = 0; i < std::min(count, GATHER_DISTANCE); i++) {
+            prefetch(i);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (i + GATHER_DISTANCE < count) {
+                prefetch(i + GATHER_DISTANCE);
+            }
+            const T* row = src + static_cast<size_t>(rows[i])*cols;
+            std::copy(row, row + cols, out + i*cols);
+        }
+    }
+
+    template <typename T>
+    T max(const T* a, size_t n) {
+        instrumentation::onKernel(instrumentation::Kernel::REDUCTION, n);
+        T m = a[0];
+        for (size_t i = 1; i < n; i++) {
+            m = std::max(m, a[i]);
+        }
+        return m;
+    }
+
+} // namespace linalg::kernels
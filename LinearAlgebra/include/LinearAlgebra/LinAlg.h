@@ -8,6 +8,8 @@
 #include "LinAlgFwds.h"
 #include "Matrix.h"
 #include "Vector.h"
+#include "Tensor.h"
+#include "Instrumentation.h"
 #include "Functions.h"
 
 #endif //LINALG_CST_LIB_H
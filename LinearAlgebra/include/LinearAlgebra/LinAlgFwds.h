@@ -4,6 +4,7 @@
 namespace linalg {
     template <typename T> class Matrix;
     template <typename T> class Vector;
+    template <typename T> class Tensor;
     struct Shape;
 }
 
@@ -11,6 +12,7 @@ using precision = float; // changeable to double if needed
 
 using Matrix = linalg::Matrix<precision>;
 using Vector = linalg::Vector<precision>;
+using Tensor = linalg::Tensor<precision>;
 using Shape  = linalg::Shape;
 
 #endif //LINALG_FWD_H
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include "Shape.h"
+#include "Epilogue.h"
 
 namespace linalg {
 
@@ -33,6 +34,8 @@ namespace linalg {
      * - Internally stored as flat std::vector for cache efficiency
      * - Shape tracks rows, columns, and total elements (N)
      * - All operations validate dimensions for safety
+     * - A matrix can also be a non-owning *view* over external memory (see view()).
+     *   Views read and write the borrowed buffer in place and never reallocate it.
      * 
      * @see Shape, Vector, MatrixError
      */
@@ -41,6 +44,7 @@ namespace linalg {
     protected:
         Shape shape;
         std::vector<T> values;
+        T* view_data = nullptr; // Non-null when the matrix borrows external memory
         std::string class_name = "Matrix";
 
     private:
@@ -51,12 +55,14 @@ namespace linalg {
          * @private
          */
         static Matrix<T> BaseNumberOp(const Matrix<T>&A, T x, int op);
+        static void BaseNumberOpInto(const Matrix<T>&A, T x, Matrix<T>& result, int op);
         
         /**
          * @brief Helper for element-wise operations between matrices.
          * @private
          */
         static Matrix<T> BaseMatricesOp(const Matrix<T>& A, const Matrix<T>& B, int op);
+        static void BaseMatricesOpInto(const Matrix<T>& A, const Matrix<T>& B, Matrix<T>& result, int op);
 
     public:
         // ========== CONSTRUCTORS ==========
@@ -66,8 +72,11 @@ namespace linalg {
          */
         Matrix() = default;
         
-        Matrix(const Matrix& other) = default;
-        Matrix(Matrix&& other) noexcept = default;
+        /**
+         * @brief Copy constructor. Always produces an owning matrix (copying a view deep-copies its elements).
+         */
+        Matrix(const Matrix& other);
+        Matrix(Matrix&& other) noexcept;
 
         /**
          * @brief Constructs column vector from flat values.
@@ -124,6 +133,43 @@ namespace linalg {
          */
         Matrix(std::initializer_list<std::initializer_list<T>> values);
 
+        /**
+         * @brief Creates a non-owning matrix view over external row-major memory.
+         * 
+         * No elements are copied: reads and writes go straight to `data`. copyFrom() writes into
+         * the borrowed buffer (the element count must match); assignment replaces the view, and
+         * copying a view produces an independent owning matrix.
+         * 
+         * @param data Pointer to rows*cols contiguous elements
+         * @param rows Number of rows
+         * @param cols Number of columns
+         * @return Matrix viewing `data`
+         * @warning The caller must keep `data` alive for as long as the view is used.
+         */
+        static Matrix<T> view(T* data, size_t rows, size_t cols);
+        static Matrix<T> view(T* data, Shape shape);
+
+        /**
+         * @brief Copies the elements to `data` and turns this matrix into a view of it, keeping its shape.
+         * 
+         * Unlike copyFrom(), which copies into the buffer a view already borrows, this re-points the
+         * matrix (owning or view) at new memory. Owned storage is released.
+         * 
+         * @param data Pointer to getShape().N contiguous elements
+         * @warning The caller must keep `data` alive for as long as the view is used.
+         */
+        void rebind(T* data);
+
+        /**
+         * @brief Copies the elements of `B` into this matrix's storage, taking its shape.
+         * 
+         * A view keeps its borrowed buffer and writes into it; an owning matrix copies as assignment does.
+         * 
+         * @param B Matrix to copy from
+         * @throw MismatchedNumberOfElements if this is a view and the element counts differ
+         */
+        void copyFrom(const Matrix<T>& B);
+
         // ========== ELEMENT ACCESS ==========
         void setName(const std::string& name);
 
@@ -190,9 +236,22 @@ namespace linalg {
          */
         T& getElement(size_t i);
 
+        /**
+         * @brief Pointer to the first element (owned storage or borrowed view memory).
+         * @return Pointer to the row-major element buffer
+         */
+        T* data();
+        const T* data() const;
+
+        /**
+         * @brief Whether this matrix borrows external memory (see view()).
+         */
+        bool isView() const;
+
         /**
          * @brief Gets imutable reference to internal element vector.
          * @return Reference to internal values vector
+         * @throw MatrixError if this is a view, which owns no vector (use data() and getShape().N)
          */
         const std::vector<T>& getElements() const;
 
@@ -200,6 +259,7 @@ namespace linalg {
          * @brief Gets mutable reference to internal element vector.
          * @warning Direct access bypasses bounds checking
          * @return Reference to internal values vector
+         * @throw MatrixError if this is a view, which owns no vector (use data() and getShape().N)
          */
         std::vector<T>& getElements();
 
@@ -342,6 +402,65 @@ namespace linalg {
         static Matrix<T> dotTransposed(const Matrix<T> &W, const Matrix<T> &X);
         static Matrix<T> dotAdd(const Matrix<T> &W, const Matrix<T> &X, const Matrix<T> &B);
 
+        /**
+         * @brief Fused matrix product: out = act(pre(W * X)), in a single pass over the output.
+         *
+         * The epilogue (bias, scale, clamp, activation...) runs inside the multiply kernel,
+         * on each accumulator before it is stored, instead of as separate element-wise passes.
+         * @param W Left operand (m x n)
+         * @param X Right operand (n x p)
+         * @param out Destination, resized to (m x p) if needed (no reallocation when it already fits)
+         * @param pre Pre stage `T(T acc, size_t i, size_t j)` (see linalg::epilogue)
+         * @param act Activation stage `T(T z)` (see linalg::epilogue)
+         * @param preactivation If not null, also receives z = pre(W * X) (e.g. for backpropagation),
+         *                      or dy/dz when act is an epilogue::WithGrad stage
+         * @throw MismatchedShapes if W.cols != X.rows
+         * @example
+         *   Matrix::dotFusedInto(W, x, y, epilogue::RowBias<float>{b.data()}, epilogue::Sigmoid{}, &z);
+         */
+        template <typename Pre, typename Act = epilogue::Identity>
+        static void dotFusedInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out,
+                                 Pre pre, Act act = {}, Matrix<T>* preactivation = nullptr);
+
+        /**
+         * @brief Allocating version of dotFusedInto().
+         * @return act(pre(W * X)) with shape (W.rows x X.cols)
+         */
+        template <typename Pre, typename Act = epilogue::Identity>
+        static Matrix<T> dotFused(const Matrix<T>& W, const Matrix<T>& X,
+                                  Pre pre, Act act = {}, Matrix<T>* preactivation = nullptr);
+
+        /**
+         * @brief Fused product with a transposed right operand: out = act(pre(X * W^T)).
+         *
+         * Typical dense layer on a batch stored as rows: X (batch x in), W (out x in),
+         * with epilogue::ColBias for the biases. Same contract as dotFusedInto().
+         * @throw MismatchedShapes if X.cols != W.cols
+         */
+        template <typename Pre, typename Act = epilogue::Identity>
+        static void dotTransposedFusedInto(const Matrix<T>& X, const Matrix<T>& W, Matrix<T>& out,
+                                           Pre pre, Act act = {}, Matrix<T>* preactivation = nullptr);
+
+        /**
+         * @brief Non-allocating products: write into `out` (resized if needed) instead of returning.
+         * @throw MismatchedShapes on incompatible operands
+         */
+        static void dotInto(const Matrix<T>& A, const Matrix<T>& B, Matrix<T>& out);
+        static void transposedDotInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out);
+
+        /**
+         * @brief Sums every column: out (cols x 1), out[j] = sum_i A(i, j).
+         */
+        static void sumColumnsInto(const Matrix<T>& A, Matrix<T>& out);
+
+        /**
+         * @brief Accumulating products: out += W^T * X (a rank-k update, see kernels::rankUpdate())
+         * and out += column sums of A. `out` must already have the result shape.
+         * @throw MismatchedShapes on incompatible operands
+         */
+        static void rankUpdateInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out);
+        static void addColumnSumsInto(const Matrix<T>& A, Matrix<T>& out);
+
         /**
          * 
          */
@@ -470,7 +589,8 @@ namespace linalg {
         // ========== OPERATORS: ASSIGNMENT ==========
         
         /**
-         * @brief Assignment operator.
+         * @brief Assignment operator. Replaces this matrix, even a view: copying into a view's
+         * buffer is copyFrom().
          * @param B Matrix to assign
          * @return Reference to this matrix
          */
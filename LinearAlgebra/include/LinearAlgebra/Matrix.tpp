@@ -4,6 +4,8 @@
 #include <utility>
 #include "MatrixErrors.h"
 #include "Matrix.h"
+#include "Kernels.h"
+#include "Trace.h"
 
 namespace linalg {
 
@@ -14,6 +16,7 @@ namespace linalg {
         shape(values.size(),1,values.size()),
         values(std::move(values))
     {
+        instrumentation::onConstruction();
     }
 
     template <typename T>
@@ -21,6 +24,8 @@ namespace linalg {
         shape(rows, cols),
         values(rows*cols)
     {
+        instrumentation::onConstruction();
+        instrumentation::onAllocation(this->values.capacity()*sizeof(T));
     }
 
     template <typename T>
@@ -28,6 +33,8 @@ namespace linalg {
         shape(rows, cols),
         values(rows*cols, value)
     {
+        instrumentation::onConstruction();
+        instrumentation::onAllocation(this->values.capacity()*sizeof(T));
     }
 
     template <typename T>
@@ -35,6 +42,8 @@ namespace linalg {
         shape(shape),
         values(shape.N)
     {
+        instrumentation::onConstruction();
+        instrumentation::onAllocation(this->values.capacity()*sizeof(T));
     }
 
     template <typename T>
@@ -42,6 +51,7 @@ namespace linalg {
         shape(rows, cols),
         values(std::move(values))
     {
+        instrumentation::onConstruction();
     }
 
     template <typename T>
@@ -49,6 +59,7 @@ namespace linalg {
         shape(shape),
         values(std::move(values))
     {
+        instrumentation::onConstruction();
     }
 
     template <typename T>
@@ -56,6 +67,29 @@ namespace linalg {
         shape(1, values.size()),
         values(values)
     {
+        instrumentation::onConstruction();
+        instrumentation::onAllocation(this->values.capacity()*sizeof(T));
+    }
+
+    template <typename T>
+    Matrix<T>::Matrix(const Matrix<T>& other) :
+        shape(other.shape),
+        values(other.isView() ? std::vector<T>(other.data(), other.data() + other.shape.N) : other.values),
+        class_name(other.class_name)
+    {
+        instrumentation::onConstruction();
+        instrumentation::onCopy();
+        instrumentation::onAllocation(values.capacity()*sizeof(T));
+    }
+
+    template <typename T>
+    Matrix<T>::Matrix(Matrix<T>&& other) noexcept :
+        shape(std::move(other.shape)),
+        values(std::move(other.values)),
+        view_data(std::exchange(other.view_data, nullptr)),
+        class_name(std::move(other.class_name))
+    {
+        instrumentation::onMove();
     }
 
     template <typename T>
@@ -75,7 +109,50 @@ namespace linalg {
                 flattened.push_back(value);
             }
         }
-        this->values = flattened;
+        this->values = std::move(flattened);
+        instrumentation::onConstruction();
+        instrumentation::onAllocation(this->values.capacity()*sizeof(T));
+    }
+
+    template <typename T>
+    Matrix<T> Matrix<T>::view(T* data, size_t rows, size_t cols) {
+        Matrix<T> M;
+        M.shape = Shape(rows, cols);
+        M.view_data = data;
+        return M;
+    }
+
+    template <typename T>
+    Matrix<T> Matrix<T>::view(T* data, Shape shape) {
+        Matrix<T> M;
+        M.shape = shape;
+        M.view_data = data;
+        return M;
+    }
+
+    template <typename T>
+    void Matrix<T>::rebind(T* data) {
+        if (data != this->data()) {
+            std::copy(this->data(), this->data() + shape.N, data);
+        }
+        std::vector<T>().swap(values);
+        view_data = data;
+    }
+
+    template <typename T>
+    void Matrix<T>::copyFrom(const Matrix<T>& B) {
+        if (!isView()) {
+            *this = B;
+            return;
+        }
+        if (shape.N != B.shape.N) {
+            throw MismatchedNumberOfElements(shape.N, B.shape.N);
+        }
+        instrumentation::onCopy();
+        if (B.data() != view_data) {
+            std::copy(B.data(), B.data() + B.shape.N, view_data);
+        }
+        shape = B.shape;
     }
 
     
@@ -90,25 +167,29 @@ namespace linalg {
         if (i>=shape.rows || j>=shape.cols) {
             throw IndexError(i, j, shape);
         }
-        values[i*shape.cols + j] = newElement;
+        data()[i*shape.cols + j] = newElement;
     }
     template <typename T>
     void Matrix<T>::setElement(T newElement, size_t i) {
         if (i>=shape.N) {
             throw IndexError(i, shape);
         }
-        values[i] = newElement;
+        data()[i] = newElement;
     }
 
     template <typename T> void Matrix<T>::setElements(std::vector<T> values) {
         resize(1, values.size());
+        if (isView()) {
+            std::copy(values.begin(), values.end(), view_data);
+            return;
+        }
         this->values = std::move(values);
     }
 
     template <typename T>
     void Matrix<T>::setElements(std::initializer_list<T> values) {
         resize(1, values.size());
-        this->values = std::move(values);
+        std::copy(values.begin(), values.end(), data());
     }
     
     template <typename T>
@@ -147,7 +228,7 @@ namespace linalg {
         if (i>=shape.N) {
             throw IndexError(i, shape);
         }
-        return values[i];
+        return data()[i];
     }
 
     template <typename T>
@@ -155,7 +236,7 @@ namespace linalg {
         if (i>=shape.N) {
             throw IndexError(i, shape);
         }
-        return values[i];
+        return data()[i];
     }
 
     template <typename T>
@@ -163,7 +244,7 @@ namespace linalg {
         if (i>=shape.rows || j>=shape.cols) {
             throw IndexError(i,j,shape);
         }
-        return values[i*shape.cols + j];
+        return data()[i*shape.cols + j];
     }
 
     template <typename T>
@@ -171,17 +252,38 @@ namespace linalg {
         if (i>=shape.rows || j>=shape.cols) {
             throw IndexError(i, j, shape);
         }
-        return values[i*shape.cols + j];
+        return data()[i*shape.cols + j];
     }
 
 
+    template <typename T>
+    T* Matrix<T>::data() {
+        return view_data ? view_data : values.data();
+    }
+
+    template <typename T>
+    const T* Matrix<T>::data() const {
+        return view_data ? view_data : values.data();
+    }
+
+    template <typename T>
+    bool Matrix<T>::isView() const {
+        return view_data != nullptr;
+    }
+
     template <typename T>
     const std::vector<T>& Matrix<T>::getElements() const {
+        if (isView()) {
+            throw MatrixError("A view owns no element vector: use data() and getShape().N");
+        }
         return values;
     }
 
     template <typename T>
     std::vector<T> &Matrix<T>::getElements() {
+        if (isView()) {
+            throw MatrixError("A view owns no element vector: use data() and getShape().N");
+        }
         return values;
     }
 
@@ -192,10 +294,18 @@ namespace linalg {
 
     template <typename T>
     void Matrix<T>::resize(size_t newRows, size_t newCols) {
+        // Views cannot reallocate the borrowed buffer, only reinterpret it
+        if (isView() && newRows*newCols != shape.N) {
+            throw ResizeError(newRows, newCols, shape);
+        }
         shape.rows = newRows;
         shape.cols = newCols;
         shape.N = newRows*newCols;
-        values.resize(shape.N);
+        if (!isView()) {
+            size_t capacity = values.capacity();
+            values.resize(shape.N);
+            instrumentation::onCapacityChange(capacity, values.capacity(), sizeof(T));
+        }
     }
 
     // TODO: IMPLEMENT GET ROW FUNCTIONS
@@ -285,33 +395,40 @@ namespace linalg {
     // Copying
     template <typename T>
     Matrix<T> Matrix<T>::copy(const Matrix<T> &m) {
-        return {m.values, m.shape};
+        return Matrix<T>(m);
     }
 
     // Operations
     template <typename T>
     Matrix<T> Matrix<T>::BaseNumberOp(const Matrix<T>&A, T x, int op) {
         Matrix<T> result(A.shape);
+        Matrix<T>::BaseNumberOpInto(A, x, result, op);
+        return result;
+    }
+
+    template <typename T>
+    void Matrix<T>::BaseNumberOpInto(const Matrix<T>&A, T x, Matrix<T>& result, int op) {
+        const T* A_ptr = A.data();
+        T* result_ptr = result.data();
         switch (op) {
             case ADD:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] + x;}
+                kernels::map(A_ptr, result_ptr, A.shape.N, [x](T a) { return a + x; });
                 break;
             case SUB:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] - x;}
+                kernels::map(A_ptr, result_ptr, A.shape.N, [x](T a) { return a - x; });
                 break;
             case MUL:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] * x;}
+                kernels::map(A_ptr, result_ptr, A.shape.N, [x](T a) { return a * x; });
                 break;
             case DIV:
                 if (x == 0) {
                     throw DivisionByZero();
                 }
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] / x;}
+                kernels::map(A_ptr, result_ptr, A.shape.N, [x](T a) { return a / x; });
                 break;
             default:
                 std::cout << "Error." << std::endl;
         }
-        return result;
     }
 
     template <typename T>
@@ -324,25 +441,32 @@ namespace linalg {
         else if (A.shape.N != B.shape.N) {
             throw MismatchedNumberOfElements(A.shape.N, B.shape.N);
         }
-        // Operations
         Matrix<T> result(A.shape);
+        Matrix<T>::BaseMatricesOpInto(A, B, result, op);
+        return result;
+    }
+
+    template <typename T>
+    void Matrix<T>::BaseMatricesOpInto(const Matrix<T> &A, const Matrix<T> &B, Matrix<T> &result, int op) {
+        const T* A_ptr = A.data();
+        const T* B_ptr = B.data();
+        T* result_ptr = result.data();
         switch (op) {
             case ADD:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] + B[i];}
+                kernels::zip(A_ptr, B_ptr, result_ptr, A.shape.N, [](T a, T b) { return a + b; });
                 break;
             case SUB:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] - B[i];}
+                kernels::zip(A_ptr, B_ptr, result_ptr, A.shape.N, [](T a, T b) { return a - b; });
                 break;
             case MUL:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] * B[i];}
+                kernels::zip(A_ptr, B_ptr, result_ptr, A.shape.N, [](T a, T b) { return a * b; });
                 break;
             case DIV:
-                for (size_t i = 0; i < A.shape.N; i++) {result[i] = A[i] / B[i];}
+                kernels::zip(A_ptr, B_ptr, result_ptr, A.shape.N, [](T a, T b) { return a / b; });
                 break;
             default:
                 std::cout << "Error." << std::endl;
         }
-        return result;
     }
 
     template <typename T>
@@ -355,11 +479,7 @@ namespace linalg {
 
     template <typename T>
     T Matrix<T>::accumulate() const {
-        T S = 0;
-        for (size_t i=0; i<this->shape.N; i++) {
-            S+=this->values[i];
-        }
-        return S;
+        return kernels::sum(data(), shape.N);
     }
 
     template <typename T>
@@ -378,27 +498,12 @@ namespace linalg {
 
     template <typename T>
     Matrix<T> Matrix<T>::dot(const Matrix<T> &A, const Matrix<T> &B) {
+        TRACE_SCOPE("Matrix::dot");
         if (A.shape.cols != B.shape.rows) {
             throw MismatchedShapes(A.shape, B.shape);
         }
-        // Caches
-        const T* A_ptr = A.values.data();
-        size_t A_rows = A.shape.rows;
-        size_t A_cols = A.shape.cols;
-        const T* B_ptr = B.values.data();
-        size_t B_cols = B.shape.cols;
-        Matrix<T> result(A_rows, B_cols);
-        T* result_ptr = result.values.data();
-        // Looping first through A matrix
-        for (size_t i=0; i<A_rows; i++) {
-            for (size_t k=0; k<A_cols; k++) {
-                const T A_ik = A_ptr[i*A_cols + k];     
-                // Internal loop with sequential acesses in memory (only j changes)
-                for (size_t j=0; j<B_cols; j++) {
-                    result_ptr[i*B_cols + j] += A_ik * B_ptr[k*B_cols + j];
-                }
-            }
-        }
+        Matrix<T> result(A.shape.rows, B.shape.cols);
+        kernels::gemm(A.data(), B.data(), result.data(), A.shape.rows, A.shape.cols, B.shape.cols);
         return result;
     }
 
@@ -423,111 +528,145 @@ namespace linalg {
 
     template <typename T>
     Matrix<T> Matrix<T>::dotAdd(const Matrix<T> &W, const Matrix<T> &X, const Matrix<T> &B) {
-        if (W.shape.cols != X.shape.rows) {
-            throw MismatchedShapes(W.shape, X.shape);
-        }
         if (W.shape.rows != B.shape.rows) {
             throw MismatchedShapes(W.shape, B.shape);
         }
-        // Caches
-        const T* W_ptr = W.values.data();
-        const T* X_ptr = X.values.data();
-        const T* B_ptr = B.values.data();
+        // Biases (one per row) are added in the kernel epilogue
+        return dotFused(W, X, epilogue::RowBias<T>{B.data()});
+    }
+
+    template <typename T>
+    template <typename Pre, typename Act>
+    void Matrix<T>::dotFusedInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out,
+                                 Pre pre, Act act, Matrix<T>* preactivation) {
+        TRACE_SCOPE("Matrix::dotFused");
+        if (W.shape.cols != X.shape.rows) {
+            throw MismatchedShapes(W.shape, X.shape);
+        }
         size_t W_rows = W.shape.rows;
-        size_t W_cols = W.shape.cols;
         size_t X_cols = X.shape.cols;
-        Matrix<T> result(W_rows, X_cols);
-        T* result_ptr = result.values.data();
-        // dotAdd logic:
-        for (size_t i = 0; i < W_rows; i++) {
-            // Applying biases first
-            T bias_i = B_ptr[i];
-            for (size_t j = 0; j < X_cols; j++) {
-                result_ptr[i*X_cols + j] = bias_i;
-            }
-            // Multiplication 
-            for (size_t k = 0; k < W_cols; k++) {
-                const T W_ik = W_ptr[i*W_cols + k];     
-                // Internal loop with sequential acesses in memory (only j changes)
-                for (size_t j = 0; j < X_cols; j++) {
-                    result_ptr[i*X_cols + j] += W_ik * X_ptr[k*X_cols + j];
-                }
+        if (out.shape.rows != W_rows || out.shape.cols != X_cols) {
+            out.resize(W_rows, X_cols);
+        }
+        T* Z_ptr = nullptr;
+        if (preactivation) {
+            if (preactivation->shape.rows != W_rows || preactivation->shape.cols != X_cols) {
+                preactivation->resize(W_rows, X_cols);
             }
+            Z_ptr = preactivation->data();
         }
+        kernels::gemmEpilogue(W.data(), X.data(), out.data(), W_rows, W.shape.cols, X_cols, pre, act, Z_ptr);
+    }
+
+    template <typename T>
+    template <typename Pre, typename Act>
+    Matrix<T> Matrix<T>::dotFused(const Matrix<T>& W, const Matrix<T>& X,
+                                  Pre pre, Act act, Matrix<T>* preactivation) {
+        Matrix<T> result(W.shape.rows, X.shape.cols);
+        dotFusedInto(W, X, result, pre, act, preactivation);
         return result;
     }
 
     template <typename T>
-    Matrix<T> Matrix<T>::transposedDot(const Matrix<T> &W, const Matrix<T> &X) {
-        if (W.shape.rows != X.shape.rows) {
-            throw MismatchedShapes(W.shape, X.shape);
+    template <typename Pre, typename Act>
+    void Matrix<T>::dotTransposedFusedInto(const Matrix<T>& X, const Matrix<T>& W, Matrix<T>& out,
+                                           Pre pre, Act act, Matrix<T>* preactivation) {
+        TRACE_SCOPE("Matrix::dotTransposedFused");
+        if (X.shape.cols != W.shape.cols) {
+            throw MismatchedShapes(X.shape, W.shape);
         }
-        // Caches
-        const T* W_ptr = W.values.data();
-        const T* X_ptr = X.values.data();
+        size_t X_rows = X.shape.rows;
         size_t W_rows = W.shape.rows;
-        size_t W_cols = W.shape.cols;
-        size_t X_cols = X.shape.cols;
-        Matrix<T> result(W_cols, X_cols);
-        T* result_ptr = result.values.data();
-        // transposedDot logic:
-        for (size_t i = 0; i < W_cols ; i++) {
-            for (size_t k = 0; k < W_rows; k++) {
-                const T W_ki = W_ptr[k*W_cols + i];     
-                // Internal loop with sequential acesses in memory (only j changes)
-                for (size_t j = 0; j < X_cols; j++) {
-                    result_ptr[i*X_cols + j] += W_ki * X_ptr[k*X_cols + j];
-                }
+        if (out.shape.rows != X_rows || out.shape.cols != W_rows) {
+            out.resize(X_rows, W_rows);
+        }
+        T* Z_ptr = nullptr;
+        if (preactivation) {
+            if (preactivation->shape.rows != X_rows || preactivation->shape.cols != W_rows) {
+                preactivation->resize(X_rows, W_rows);
             }
+            Z_ptr = preactivation->data();
         }
-        return result;
+        kernels::gemmTransposedBEpilogue(X.data(), W.data(), out.data(), X_rows, X.shape.cols, W_rows, pre, act, Z_ptr);
     }
 
     template <typename T>
-    Matrix<T> Matrix<T>::dotTransposed(const Matrix<T> &W, const Matrix<T> &X) {
-        if (W.shape.cols != X.shape.cols) {
+    void Matrix<T>::dotInto(const Matrix<T>& A, const Matrix<T>& B, Matrix<T>& out) {
+        TRACE_SCOPE("Matrix::dot");
+        if (A.shape.cols != B.shape.rows) {
+            throw MismatchedShapes(A.shape, B.shape);
+        }
+        if (out.shape.rows != A.shape.rows || out.shape.cols != B.shape.cols) {
+            out.resize(A.shape.rows, B.shape.cols);
+        }
+        kernels::gemm(A.data(), B.data(), out.data(), A.shape.rows, A.shape.cols, B.shape.cols);
+    }
+
+    template <typename T>
+    void Matrix<T>::transposedDotInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out) {
+        TRACE_SCOPE("Matrix::transposedDot");
+        if (W.shape.rows != X.shape.rows) {
             throw MismatchedShapes(W.shape, X.shape);
         }
-        // Caches
-        const T* W_ptr = W.values.data();
-        const T* X_ptr = X.values.data();
-        size_t W_rows = W.shape.rows;
-        size_t W_cols = W.shape.cols;
-        size_t X_rows = X.shape.rows;
-        Matrix<T> result(W_rows, X_rows);
-        T* result_ptr = result.values.data();
-        // dotTransposed logic:
-        for (size_t i = 0; i < W_rows; i++) {
-            for (size_t j = 0; j < X_rows; j++) {
-                // Internal loop with sequential acesses in memory (only k changes) and a single acess to 'result_ptr'.
-                T aux = 0;
-                for (size_t k = 0; k < W_cols; k++) {
-                    aux += W_ptr[i*W_cols + k] * X_ptr[j*W_cols + k];
-                }
-                result_ptr[i*X_rows + j] = aux;
-            }
+        if (out.shape.rows != W.shape.cols || out.shape.cols != X.shape.cols) {
+            out.resize(W.shape.cols, X.shape.cols);
         }
+        kernels::gemmTransposedA(W.data(), X.data(), out.data(), W.shape.cols, W.shape.rows, X.shape.cols);
+    }
+
+    template <typename T>
+    void Matrix<T>::sumColumnsInto(const Matrix<T>& A, Matrix<T>& out) {
+        if (out.shape.rows != A.shape.cols || out.shape.cols != 1) {
+            out.resize(A.shape.cols, 1);
+        }
+        kernels::sumColumns(A.data(), out.data(), A.shape.rows, A.shape.cols);
+    }
+
+    template <typename T>
+    void Matrix<T>::rankUpdateInto(const Matrix<T>& W, const Matrix<T>& X, Matrix<T>& out) {
+        TRACE_SCOPE("Matrix::rankUpdate");
+        if (W.shape.rows != X.shape.rows) {
+            throw MismatchedShapes(W.shape, X.shape);
+        }
+        if (out.shape.rows != W.shape.cols || out.shape.cols != X.shape.cols) {
+            throw MismatchedShapes(out.shape, Shape(W.shape.cols, X.shape.cols));
+        }
+        kernels::rankUpdate(W.data(), X.data(), out.data(), W.shape.cols, W.shape.rows, X.shape.cols);
+    }
+
+    template <typename T>
+    void Matrix<T>::addColumnSumsInto(const Matrix<T>& A, Matrix<T>& out) {
+        if (out.shape.N != A.shape.cols) {
+            throw MismatchedShapes(out.shape, Shape(A.shape.cols, 1));
+        }
+        kernels::addColumnSums(A.data(), out.data(), A.shape.rows, A.shape.cols);
+    }
+
+    template <typename T>
+    Matrix<T> Matrix<T>::transposedDot(const Matrix<T> &W, const Matrix<T> &X) {
+        TRACE_SCOPE("Matrix::transposedDot");
+        if (W.shape.rows != X.shape.rows) {
+            throw MismatchedShapes(W.shape, X.shape);
+        }
+        Matrix<T> result(W.shape.cols, X.shape.cols);
+        kernels::gemmTransposedA(W.data(), X.data(), result.data(), W.shape.cols, W.shape.rows, X.shape.cols);
         return result;
     }
 
     template <typename T>
-    inline void transposeBlock(T* A, T* B, size_t rows, size_t cols, size_t block_size) {
-        // #pragma omp parallel for collapse(2)
-        for (size_t i = 0; i < rows; i+=block_size) {
-            for (size_t j=0; j < cols; j+=block_size) {
-                size_t i_end = std::min(i + block_size, rows);
-                size_t j_end = std::min(j + block_size, cols);
-                for (size_t bi = i; bi < i_end; bi++) {
-                    for (size_t bj = j; bj < j_end; bj++) {
-                        B[bj * rows + bi] = A[bi * cols + bj];
-                    }
-                }
-            }
+    Matrix<T> Matrix<T>::dotTransposed(const Matrix<T> &W, const Matrix<T> &X) {
+        TRACE_SCOPE("Matrix::dotTransposed");
+        if (W.shape.cols != X.shape.cols) {
+            throw MismatchedShapes(W.shape, X.shape);
         }
+        Matrix<T> result(W.shape.rows, X.shape.rows);
+        kernels::gemmTransposedB(W.data(), X.data(), result.data(), W.shape.rows, W.shape.cols, X.shape.rows);
+        return result;
     }
     
     template <typename T>
     void Matrix<T>::transpose() {
+        TRACE_SCOPE("Matrix::transpose");
         // Dynamic calculation of block_size
         size_t block_size;
         size_t min_dim = std::min(shape.rows, shape.cols);
@@ -537,10 +676,13 @@ namespace linalg {
         else block_size = 64;
         // Transposing logic
         std::vector<T> transposed_values(shape.N);
-        T* A = values.data();
-        T* B = transposed_values.data();
-        transposeBlock(A, B, shape.rows, shape.cols, block_size);
-        values = std::move(transposed_values);
+        instrumentation::onAllocation(shape.N*sizeof(T));
+        kernels::transpose(data(), transposed_values.data(), shape.rows, shape.cols, block_size);
+        if (isView()) {
+            std::copy(transposed_values.begin(), transposed_values.end(), view_data);
+        } else {
+            values = std::move(transposed_values);
+        }
         std::swap(shape.rows, shape.cols);
     }
 
@@ -652,8 +794,17 @@ namespace linalg {
     template <typename T>
     Matrix<T> &Matrix<T>::operator=(const Matrix<T> &B) {
         if (this != &B) {
+            instrumentation::onCopy();
+            // Always an owning copy: a view drops its borrowed buffer (copyFrom() writes into it)
             shape = B.shape;
-            values = B.values;
+            size_t capacity = values.capacity();
+            if (B.isView()) {
+                values.assign(B.data(), B.data() + B.shape.N);
+            } else {
+                values = B.values;
+            }
+            view_data = nullptr;
+            instrumentation::onCapacityChange(capacity, values.capacity(), sizeof(T));
         }
         return *this;
     }
@@ -661,33 +812,47 @@ namespace linalg {
     template <typename T>
     Matrix<T> &Matrix<T>::operator=(Matrix<T> &&B) noexcept {
         if (this != &B) {
+            instrumentation::onMove();
             shape = std::move(B.shape);
             values = std::move(B.values);
+            view_data = std::exchange(B.view_data, nullptr);
         }
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator+=(const Matrix<T> &B) {
-        *this = *this + B;
+        if (shape != B.shape) {
+            throw MismatchedShapes(shape, B.shape);
+        }
+        Matrix<T>::BaseMatricesOpInto(*this, B, *this, ADD);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator-=(const Matrix<T> &B) {
-        *this = *this - B;
+        if (shape != B.shape) {
+            throw MismatchedShapes(shape, B.shape);
+        }
+        Matrix<T>::BaseMatricesOpInto(*this, B, *this, SUB);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator*=(const Matrix<T> &B) {
-        *this = *this * B;
+        if (shape != B.shape) {
+            throw MismatchedShapes(shape, B.shape);
+        }
+        Matrix<T>::BaseMatricesOpInto(*this, B, *this, MUL);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator/=(const Matrix<T> &B) {
-        *this = *this / B;
+        if (shape != B.shape) {
+            throw MismatchedShapes(shape, B.shape);
+        }
+        Matrix<T>::BaseMatricesOpInto(*this, B, *this, DIV);
         return *this;
     }
 
@@ -697,31 +862,31 @@ namespace linalg {
         // for (size_t i = 0; i < this->shape.N; i++) {
         //     this->values[i] = x;
         // }
-        std::fill(values.begin(), values.end(), x);
+        std::fill(data(), data() + shape.N, x);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator+=(T x) {
-        *this = *this + x;
+        Matrix<T>::BaseNumberOpInto(*this, x, *this, ADD);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator-=(T x) {
-        *this = *this - x;
+        Matrix<T>::BaseNumberOpInto(*this, x, *this, SUB);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator*=(T x) {
-        *this = *this * x;
+        Matrix<T>::BaseNumberOpInto(*this, x, *this, MUL);
         return *this;
     }
 
     template <typename T>
     Matrix<T> &Matrix<T>::operator/=(T x) {
-        *this = *this / x;
+        Matrix<T>::BaseNumberOpInto(*this, x, *this, DIV);
         return *this;
     }
 
@@ -730,7 +895,7 @@ namespace linalg {
     Matrix<T> Matrix<T>::operator>(T x) const {
         Matrix<T> bools(this->shape);
         for (size_t i = 0; i<this->shape.N; i++) {
-            if (this->values[i] > x) {
+            if (this->data()[i] > x) {
                 bools.setElement(1, i);
             }
         }
@@ -741,7 +906,7 @@ namespace linalg {
     Matrix<T> Matrix<T>::operator<(T x) const {
         Matrix<T> bools(this->shape);
         for (size_t i = 0; i<this->shape.N; i++) {
-            if (this->values[i] < x) {
+            if (this->data()[i] < x) {
                 bools.setElement(1, i);
             }
         }
@@ -752,7 +917,7 @@ namespace linalg {
     Matrix<T> Matrix<T>::operator==(T x) const {
         Matrix<T> bools(this->shape);
         for (size_t i = 0; i<this->shape.N; i++) {
-            if (this->values[i] == x) {
+            if (this->data()[i] == x) {
                 bools.setElement(1, i);
             }
         }
@@ -763,7 +928,7 @@ namespace linalg {
     Matrix<int> Matrix<T>::operator==(const Matrix<T> &B) const {
         Matrix<int> bools(shape);
         for (size_t i = 0; i<shape.N; i++) {
-            bools.setElement((values[i] == B.getElement(i)), i);
+            bools.setElement((data()[i] == B.getElement(i)), i);
         }
         return bools;
     }
@@ -772,7 +937,7 @@ namespace linalg {
     Matrix<T> Matrix<T>::operator!=(T x) const {
         Matrix<T> bools(this->shape);
         for (size_t i = 0; i<this->shape.N; i++) {
-            if (this->values[i] != x) {
+            if (this->data()[i] != x) {
                 bools.setElement(1, i);
             }
         }
@@ -781,9 +946,9 @@ namespace linalg {
 
     template <typename T>
     Matrix<T>::operator bool() const {
-        return std::ranges::none_of(
-                this->values.cbegin(),
-                this->values.cend(),
+        return std::none_of(
+                this->data(),
+                this->data() + this->shape.N,
                 [](T x){return (x == 0);});
     }
 
@@ -800,7 +965,7 @@ namespace linalg {
     template <typename T>
     const T* Matrix<T>::operator()(size_t i) const {
         // if (i >= shape.rows) throw IndexError(i, shape);
-        return &values[i * shape.cols];
+        return data() + i * shape.cols;
     }
 
     template <typename T>
@@ -815,12 +980,12 @@ namespace linalg {
 
     template <typename T>
     T& Matrix<T>::operator[](size_t idx) {
-        return values[idx];
+        return data()[idx];
     }
 
     template <typename T>
     T Matrix<T>::operator[](size_t idx) const {
-        return values[idx];
+        return data()[idx];
     }
 
 
@@ -7,7 +7,9 @@
 
 
 #include <string>
+#include <vector>
 #include <format>
+#include <stdexcept>
 #include "Shape.h"
 
 namespace linalg {
@@ -58,6 +60,31 @@ namespace linalg {
                                     std::string(shape1), std::string(shape2))) {}
     };
 
+    /**
+     * @struct MismatchedDimensions
+     * @brief Exception thrown when tensor dimensions are incompatible.
+     * 
+     * N-dimensional counterpart of MismatchedShapes, raised by Tensor operations.
+     */
+    struct MismatchedDimensions : public MatrixError {
+        /**
+         * @brief Constructs error message from two incompatible dimension lists.
+         * @param dims1 First incompatible dimensions
+         * @param dims2 Second incompatible dimensions
+         */
+        MismatchedDimensions(const std::vector<size_t>& dims1, const std::vector<size_t>& dims2):
+            MatrixError(std::format("Mismatched dimensions: {} and {}", toString(dims1), toString(dims2))) {}
+
+    private:
+        static std::string toString(const std::vector<size_t>& dims) {
+            std::string s = "(";
+            for (size_t i = 0; i < dims.size(); i++) {
+                s += std::format("{}{}", i ? "," : "", dims[i]);
+            }
+            return s + ")";
+        }
+    };
+
     /**
      * @struct MismatchedNumberOfElements
      * @brief Exception when element counts don't match.
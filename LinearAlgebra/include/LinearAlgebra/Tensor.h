@@ -0,0 +1,306 @@
+#ifndef LINALG_CST_LIB_TENSOR_H
+#define LINALG_CST_LIB_TENSOR_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <initializer_list>
+#include "Matrix.h"
+
+namespace linalg {
+
+    /**
+     * @class Tensor
+     * @brief N-dimensional strided array generalizing Shape/Matrix to arbitrary rank.
+     *
+     * A Tensor is a lightweight handle made of a data pointer, a list of dimensions and
+     * a list of strides (in elements). Several tensors can share the same storage, which
+     * makes reshape, permute/transpose, slice and indexing O(1) views instead of copies.
+     *
+     * @tparam T Numeric type (float, double, etc.)
+     *
+     * ## Ownership
+     * - Tensors created from dimensions or values own a reference-counted buffer.
+     * - Copying a Tensor copies the *handle* (both share the buffer); use copy() for a deep copy.
+     * - view() borrows external memory (e.g. a Matrix) without taking ownership.
+     *
+     * ## Interoperability with Matrix
+     * - `Tensor(Matrix&&)` adopts the matrix buffer without copying.
+     * - asMatrix() exposes a contiguous rank-1/2 tensor as a Matrix view without copying.
+     * - `toMatrix() &&` hands an exclusively owned buffer back to a Matrix without copying.
+     *
+     * Element-wise operations, reductions and (batched) matrix products run on the same
+     * raw-pointer kernels as Matrix (see kernels::), with strided fallbacks for
+     * non-contiguous views.
+     *
+     * @see Matrix, Shape
+     */
+    template <typename T>
+    class Tensor {
+    protected:
+        std::vector<size_t> dims;
+        std::vector<size_t> strides;
+        std::shared_ptr<std::vector<T>> storage; // Null for borrowed views
+        T* data_ptr = nullptr;
+        size_t N = 0;
+
+        static std::vector<size_t> contiguousStrides(const std::vector<size_t>& dims);
+        static size_t numberOfElements(const std::vector<size_t>& dims);
+
+        /**
+         * @brief Calls func(offset1, offset2) for every index of `dims`, in row-major order,
+         * where each offset is computed with its own stride set.
+         * @private
+         */
+        template <typename Func>
+        static void forEachOffset(const std::vector<size_t>& dims,
+                                  const std::vector<size_t>& strides1,
+                                  const std::vector<size_t>& strides2,
+                                  Func func);
+
+    public:
+        // ========== CONSTRUCTORS ==========
+
+        /**
+         * @brief Default constructor. Creates an empty rank-0 tensor with no elements.
+         */
+        Tensor() = default;
+
+        /**
+         * @brief Constructs a zero-initialized tensor with the given dimensions.
+         * @param dims Size of each axis
+         */
+        explicit Tensor(std::vector<size_t> dims);
+
+        /**
+         * @brief Constructs a tensor from row-major flat values.
+         * @param values Flattened elements (row-major order)
+         * @param dims Size of each axis
+         * @throw MismatchedNumberOfElements if values.size() does not match the dims
+         */
+        Tensor(std::vector<T> values, std::vector<size_t> dims);
+
+        /**
+         * @brief Adopts the buffer of a matrix without copying it.
+         *
+         * The result is a rank-2 tensor (rows x cols). If `matrix` is itself a view,
+         * the tensor becomes a borrowed view of the same memory.
+         * @param matrix Matrix to consume
+         */
+        explicit Tensor(Matrix<T>&& matrix);
+
+        /**
+         * @brief Creates a borrowed, contiguous tensor view over external memory.
+         * @param data Pointer to the first element
+         * @param dims Size of each axis
+         * @warning The caller must keep `data` alive for as long as the view is used.
+         */
+        static Tensor<T> view(T* data, std::vector<size_t> dims);
+
+        /**
+         * @brief Creates a borrowed rank-2 view of a matrix (rows x cols) without copying.
+         * @param matrix Matrix to view
+         * @warning The matrix must outlive the view and must not be resized meanwhile.
+         */
+        static Tensor<T> view(Matrix<T>& matrix);
+
+        // ========== INITIALIZATION ==========
+        static Tensor<T> zeros(std::vector<size_t> dims);
+        static Tensor<T> ones(std::vector<size_t> dims);
+        static Tensor<T> random(std::vector<size_t> dims, T floor=0, T ceil=1);
+
+        // ========== SHAPE ==========
+
+        /**
+         * @brief Number of axes.
+         */
+        size_t rank() const;
+
+        /**
+         * @brief Total number of elements.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Size of a single axis.
+         * @throw IndexError if axis >= rank()
+         */
+        size_t dim(size_t axis) const;
+
+        const std::vector<size_t>& getDims() const;
+        const std::vector<size_t>& getStrides() const;
+
+        /**
+         * @brief Whether elements are laid out densely in row-major order.
+         */
+        bool isContiguous() const;
+
+        /**
+         * @brief Whether this tensor borrows memory it does not (co-)own.
+         */
+        bool isView() const;
+
+        /**
+         * @brief Pointer to the element at index (0, ..., 0).
+         */
+        T* data();
+        const T* data() const;
+
+        // ========== ELEMENT ACCESS ==========
+
+        /**
+         * @brief Element at a multi-dimensional index.
+         * @param index One coordinate per axis
+         * @throw MismatchedNumberOfElements if the index does not have one coordinate per axis
+         * @throw IndexError if any coordinate is out of range
+         */
+        T& at(const std::vector<size_t>& index);
+        T at(const std::vector<size_t>& index) const;
+
+        /**
+         * @brief Element at a multi-dimensional index, unchecked.
+         * @param index One coordinate per axis
+         */
+        template <typename... Index>
+        T& operator()(Index... index);
+        template <typename... Index>
+        T operator()(Index... index) const;
+
+        // ========== VIEWS ==========
+
+        /**
+         * @brief Reinterprets the elements with new dimensions (shares storage).
+         * @param dims New dimensions; their product must equal size()
+         * @throw MismatchedNumberOfElements if the element count differs
+         * @throw MatrixError if the tensor is not contiguous
+         */
+        Tensor<T> reshape(std::vector<size_t> dims) const;
+
+        /**
+         * @brief Reorders axes (shares storage, no data movement).
+         * @param axes Permutation of [0, rank())
+         */
+        Tensor<T> permute(const std::vector<size_t>& axes) const;
+
+        /**
+         * @brief Swaps two axes (shares storage). Defaults to the last two axes.
+         */
+        Tensor<T> transpose() const;
+        Tensor<T> transpose(size_t axis1, size_t axis2) const;
+
+        /**
+         * @brief Restricts one axis to the half-open range [start, end) (shares storage).
+         */
+        Tensor<T> slice(size_t axis, size_t start, size_t end) const;
+
+        /**
+         * @brief Selects index i along the first axis, dropping it (shares storage).
+         */
+        Tensor<T> operator[](size_t i) const;
+
+        /**
+         * @brief Returns *this if already contiguous, otherwise a dense row-major copy.
+         */
+        Tensor<T> contiguous() const;
+
+        /**
+         * @brief Deep copy into a new, contiguous, owning tensor.
+         */
+        Tensor<T> copy() const;
+
+        // ========== CONVERSION ==========
+
+        /**
+         * @brief Non-owning Matrix view of a contiguous rank-1 (N x 1) or rank-2 tensor.
+         * @throw MatrixError if the tensor is not contiguous or has rank > 2
+         */
+        Matrix<T> asMatrix();
+
+        /**
+         * @brief Moves the tensor into an owning Matrix.
+         *
+         * Zero-copy when the tensor is the sole owner of a contiguous buffer that it
+         * spans completely; otherwise the elements are copied.
+         * Rank-1 tensors become N x 1 matrices; higher ranks are flattened to
+         * (product of leading dims) x (last dim).
+         */
+        Matrix<T> toMatrix() &&;
+
+        /**
+         * @brief Copies the elements into an owning Matrix (same layout rules as toMatrix()).
+         */
+        Matrix<T> toMatrix() const &;
+
+        // ========== ELEMENT-WISE ==========
+
+        /**
+         * @brief New tensor with func applied to every element.
+         */
+        template <typename Func>
+        Tensor<T> map(Func func) const;
+
+        /**
+         * @brief New tensor with func applied to pairs of elements of two equally shaped tensors.
+         * @throw MismatchedNumberOfElements if the dimensions differ
+         */
+        template <typename Func>
+        Tensor<T> zip(const Tensor<T>& B, Func func) const;
+
+        Tensor<T> operator+(const Tensor<T>& B) const;
+        Tensor<T> operator-(const Tensor<T>& B) const;
+        Tensor<T> operator*(const Tensor<T>& B) const;
+        Tensor<T> operator/(const Tensor<T>& B) const;
+        Tensor<T> operator+(T x) const;
+        Tensor<T> operator-(T x) const;
+        Tensor<T> operator*(T x) const;
+        Tensor<T> operator/(T x) const;
+
+        /**
+         * @brief In-place element-wise operations (write through views into shared storage).
+         */
+        Tensor<T>& operator+=(const Tensor<T>& B);
+        Tensor<T>& operator-=(const Tensor<T>& B);
+        Tensor<T>& operator*=(T x);
+
+        /**
+         * @brief Fills every element with x (writes through views).
+         */
+        Tensor<T>& fill(T x);
+
+        // ========== REDUCTIONS ==========
+        [[nodiscard]] T sum() const;
+        [[nodiscard]] T mean() const;
+        [[nodiscard]] T max() const;
+
+        /**
+         * @brief Sums over one axis, removing it from the result.
+         */
+        Tensor<T> sum(size_t axis) const;
+
+        // ========== PRODUCTS ==========
+
+        /**
+         * @brief (Batched) matrix product over the last two axes.
+         *
+         * Supported operand ranks:
+         * - (M x K) . (K x N) -> (M x N)
+         * - (B x M x K) . (B x K x N) -> (B x M x N)
+         * - (B x M x K) . (K x N) -> (B x M x N) (right operand broadcast over the batch)
+         *
+         * Transposed views (from transpose()) are fed to the matching transposed kernel
+         * instead of being copied.
+         * @throw MismatchedDimensions if the inner or batch dimensions do not match
+         */
+        static Tensor<T> matmul(const Tensor<T>& A, const Tensor<T>& B);
+        [[nodiscard]] Tensor<T> matmul(const Tensor<T>& B) const;
+
+        // ========== OUTPUT ==========
+        void print() const;
+        explicit operator std::string() const;
+    };
+
+}
+
+#include "Tensor.tpp"
+
+#endif // LINALG_CST_LIB_TENSOR_H
@@ -0,0 +1,648 @@
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <format>
+#include "MatrixErrors.h"
+#include "Kernels.h"
+#include "Trace.h"
+#include "Tensor.h"
+
+namespace linalg {
+
+    /// Helpers
+    template <typename T>
+    std::vector<size_t> Tensor<T>::contiguousStrides(const std::vector<size_t>& dims) {
+        std::vector<size_t> strides(dims.size());
+        size_t stride = 1;
+        for (size_t axis = dims.size(); axis-- > 0;) {
+            strides[axis] = stride;
+            stride *= dims[axis];
+        }
+        return strides;
+    }
+
+    template <typename T>
+    size_t Tensor<T>::numberOfElements(const std::vector<size_t>& dims) {
+        return std::accumulate(dims.begin(), dims.end(), size_t(1), std::multiplies<size_t>());
+    }
+
+    template <typename T>
+    template <typename Func>
+    void Tensor<T>::forEachOffset(const std::vector<size_t>& dims,
+                                  const std::vector<size_t>& strides1,
+                                  const std::vector<size_t>& strides2,
+                                  Func func) {
+        const size_t R = dims.size();
+        if (R == 0) {
+            func(size_t(0), size_t(0));
+            return;
+        }
+        const size_t count = numberOfElements(dims);
+        if (count == 0) {
+            return;
+        }
+        // Innermost axis is walked directly, outer axes with an odometer-style carry
+        const size_t inner = dims[R-1];
+        const size_t inner_stride1 = strides1[R-1];
+        const size_t inner_stride2 = strides2[R-1];
+        std::vector<size_t> index(R, 0);
+        size_t offset1 = 0;
+        size_t offset2 = 0;
+        for (size_t outer = 0; outer < count / inner; outer++) {
+            for (size_t j = 0; j < inner; j++) {
+                func(offset1 + j*inner_stride1, offset2 + j*inner_stride2);
+            }
+            for (size_t axis = R - 1; axis-- > 0;) {
+                offset1 += strides1[axis];
+                offset2 += strides2[axis];
+                if (++index[axis] < dims[axis]) {
+                    break;
+                }
+                offset1 -= strides1[axis] * dims[axis];
+                offset2 -= strides2[axis] * dims[axis];
+                index[axis] = 0;
+            }
+        }
+    }
+
+
+    /// Constructors
+    template <typename T>
+    Tensor<T>::Tensor(std::vector<size_t> dims) :
+        dims(std::move(dims))
+    {
+        strides = contiguousStrides(this->dims);
+        N = numberOfElements(this->dims);
+        storage = std::make_shared<std::vector<T>>(N);
+        data_ptr = storage->data();
+    }
+
+    template <typename T>
+    Tensor<T>::Tensor(std::vector<T> values, std::vector<size_t> dims) :
+        dims(std::move(dims))
+    {
+        strides = contiguousStrides(this->dims);
+        N = numberOfElements(this->dims);
+        if (values.size() != N) {
+            throw MismatchedNumberOfElements(values.size(), N);
+        }
+        storage = std::make_shared<std::vector<T>>(std::move(values));
+        data_ptr = storage->data();
+    }
+
+    template <typename T>
+    Tensor<T>::Tensor(Matrix<T>&& matrix) {
+        const Shape& S = matrix.getShape();
+        dims = {S.rows, S.cols};
+        strides = contiguousStrides(dims);
+        N = S.N;
+        if (matrix.isView()) {
+            data_ptr = matrix.data();
+            return;
+        }
+        // Steal the buffer and leave the matrix empty
+        storage = std::make_shared<std::vector<T>>(std::move(matrix.getElements()));
+        data_ptr = storage->data();
+        matrix = Matrix<T>();
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::view(T* data, std::vector<size_t> dims) {
+        Tensor<T> t;
+        t.strides = contiguousStrides(dims);
+        t.N = numberOfElements(dims);
+        t.dims = std::move(dims);
+        t.data_ptr = data;
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::view(Matrix<T>& matrix) {
+        const Shape& S = matrix.getShape();
+        return view(matrix.data(), {S.rows, S.cols});
+    }
+
+
+    /// Initializers
+    template <typename T>
+    Tensor<T> Tensor<T>::zeros(std::vector<size_t> dims) {
+        return Tensor<T>(std::move(dims));
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::ones(std::vector<size_t> dims) {
+        Tensor<T> t(std::move(dims));
+        t.fill(1);
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::random(std::vector<size_t> dims, T floor, T ceil) {
+        std::random_device rnd_device;
+        std::mt19937 mersenne_engine {rnd_device()};
+        std::uniform_real_distribution<T> dist {floor, ceil};
+        Tensor<T> t(std::move(dims));
+        std::generate(t.data_ptr, t.data_ptr + t.N, [&](){ return dist(mersenne_engine); });
+        return t;
+    }
+
+
+    /// Shape
+    template <typename T>
+    size_t Tensor<T>::rank() const {
+        return dims.size();
+    }
+
+    template <typename T>
+    size_t Tensor<T>::size() const {
+        return N;
+    }
+
+    template <typename T>
+    size_t Tensor<T>::dim(size_t axis) const {
+        if (axis >= dims.size()) {
+            throw IndexError(axis, Shape(1, dims.size()));
+        }
+        return dims[axis];
+    }
+
+    template <typename T>
+    const std::vector<size_t>& Tensor<T>::getDims() const {
+        return dims;
+    }
+
+    template <typename T>
+    const std::vector<size_t>& Tensor<T>::getStrides() const {
+        return strides;
+    }
+
+    template <typename T>
+    bool Tensor<T>::isContiguous() const {
+        size_t expected = 1;
+        for (size_t axis = dims.size(); axis-- > 0;) {
+            // Axes of size 1 never move the pointer, so their stride is irrelevant
+            if (dims[axis] != 1 && strides[axis] != expected) {
+                return false;
+            }
+            expected *= dims[axis];
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool Tensor<T>::isView() const {
+        return !storage;
+    }
+
+    template <typename T>
+    T* Tensor<T>::data() {
+        return data_ptr;
+    }
+
+    template <typename T>
+    const T* Tensor<T>::data() const {
+        return data_ptr;
+    }
+
+
+    /// Element access
+    template <typename T>
+    T& Tensor<T>::at(const std::vector<size_t>& index) {
+        if (index.size() != dims.size()) {
+            throw MismatchedNumberOfElements(index.size(), dims.size());
+        }
+        size_t offset = 0;
+        for (size_t axis = 0; axis < dims.size(); axis++) {
+            if (index[axis] >= dims[axis]) {
+                throw IndexError(index[axis], Shape(1, dims[axis]));
+            }
+            offset += index[axis] * strides[axis];
+        }
+        return data_ptr[offset];
+    }
+
+    template <typename T>
+    T Tensor<T>::at(const std::vector<size_t>& index) const {
+        return const_cast<Tensor<T>*>(this)->at(index);
+    }
+
+    template <typename T>
+    template <typename... Index>
+    T& Tensor<T>::operator()(Index... index) {
+        const size_t idx[] = {static_cast<size_t>(index)...};
+        size_t offset = 0;
+        for (size_t axis = 0; axis < sizeof...(Index); axis++) {
+            offset += idx[axis] * strides[axis];
+        }
+        return data_ptr[offset];
+    }
+
+    template <typename T>
+    template <typename... Index>
+    T Tensor<T>::operator()(Index... index) const {
+        return const_cast<Tensor<T>*>(this)->operator()(index...);
+    }
+
+
+    /// Views
+    template <typename T>
+    Tensor<T> Tensor<T>::reshape(std::vector<size_t> dims) const {
+        if (numberOfElements(dims) != N) {
+            throw MismatchedNumberOfElements(numberOfElements(dims), N);
+        }
+        if (!isContiguous()) {
+            throw MatrixError("Cannot reshape a non-contiguous tensor. Call contiguous() first.");
+        }
+        Tensor<T> t = *this;
+        t.strides = contiguousStrides(dims);
+        t.dims = std::move(dims);
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::permute(const std::vector<size_t>& axes) const {
+        if (axes.size() != dims.size()) {
+            throw MismatchedNumberOfElements(axes.size(), dims.size());
+        }
+        std::vector<bool> seen(dims.size(), false);
+        Tensor<T> t = *this;
+        for (size_t i = 0; i < axes.size(); i++) {
+            if (axes[i] >= dims.size() || seen[axes[i]]) {
+                throw std::invalid_argument("permute() expects a permutation of the tensor axes.");
+            }
+            seen[axes[i]] = true;
+            t.dims[i] = dims[axes[i]];
+            t.strides[i] = strides[axes[i]];
+        }
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::transpose() const {
+        if (dims.size() < 2) {
+            return *this;
+        }
+        return transpose(dims.size() - 2, dims.size() - 1);
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::transpose(size_t axis1, size_t axis2) const {
+        if (axis1 >= dims.size() || axis2 >= dims.size()) {
+            throw IndexError(std::max(axis1, axis2), Shape(1, dims.size()));
+        }
+        Tensor<T> t = *this;
+        std::swap(t.dims[axis1], t.dims[axis2]);
+        std::swap(t.strides[axis1], t.strides[axis2]);
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::slice(size_t axis, size_t start, size_t end) const {
+        if (axis >= dims.size()) {
+            throw IndexError(axis, Shape(1, dims.size()));
+        }
+        if (start > end || end > dims[axis]) {
+            throw IndexError(end, Shape(1, dims[axis]));
+        }
+        Tensor<T> t = *this;
+        t.data_ptr += start * strides[axis];
+        t.dims[axis] = end - start;
+        t.N = numberOfElements(t.dims);
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator[](size_t i) const {
+        if (dims.empty() || i >= dims[0]) {
+            throw IndexError(i, Shape(1, dims.empty() ? 0 : dims[0]));
+        }
+        Tensor<T> t = *this;
+        t.data_ptr += i * strides[0];
+        t.dims.erase(t.dims.begin());
+        t.strides.erase(t.strides.begin());
+        t.N = numberOfElements(t.dims);
+        return t;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::contiguous() const {
+        if (isContiguous()) {
+            return *this;
+        }
+        return copy();
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::copy() const {
+        Tensor<T> t(dims);
+        if (isContiguous()) {
+            std::copy(data_ptr, data_ptr + N, t.data_ptr);
+            return t;
+        }
+        T* out = t.data_ptr;
+        forEachOffset(dims, strides, t.strides, [&](size_t src, size_t dst) { out[dst] = data_ptr[src]; });
+        return t;
+    }
+
+
+    /// Conversion
+    template <typename T>
+    Matrix<T> Tensor<T>::asMatrix() {
+        if (dims.size() > 2 || !isContiguous()) {
+            throw MatrixError("asMatrix() requires a contiguous tensor of rank 2 or lower.");
+        }
+        if (dims.size() == 2) {
+            return Matrix<T>::view(data_ptr, dims[0], dims[1]);
+        }
+        return Matrix<T>::view(data_ptr, N, 1);
+    }
+
+    template <typename T>
+    Matrix<T> Tensor<T>::toMatrix() && {
+        const size_t cols = dims.size() >= 2 ? dims.back() : 1;
+        const size_t rows = (cols == 0) ? 0 : N / cols;
+        const bool exclusive = storage && storage.use_count() == 1
+                               && data_ptr == storage->data() && storage->size() == N;
+        if (exclusive && isContiguous()) {
+            Matrix<T> M(std::move(*storage), rows, cols);
+            *this = Tensor<T>();
+            return M;
+        }
+        return static_cast<const Tensor<T>&>(*this).toMatrix();
+    }
+
+    template <typename T>
+    Matrix<T> Tensor<T>::toMatrix() const & {
+        const size_t cols = dims.size() >= 2 ? dims.back() : 1;
+        const size_t rows = (cols == 0) ? 0 : N / cols;
+        Matrix<T> M(rows, cols);
+        Tensor<T> dense = Tensor<T>::view(M.data(), dims);
+        forEachOffset(dims, strides, dense.strides, [&](size_t src, size_t dst) { dense.data_ptr[dst] = data_ptr[src]; });
+        return M;
+    }
+
+
+    /// Element-wise
+    template <typename T>
+    template <typename Func>
+    Tensor<T> Tensor<T>::map(Func func) const {
+        Tensor<T> result(dims);
+        if (isContiguous()) {
+            kernels::map(data_ptr, result.data_ptr, N, func);
+            return result;
+        }
+        T* out = result.data_ptr;
+        forEachOffset(dims, strides, result.strides, [&](size_t src, size_t dst) { out[dst] = func(data_ptr[src]); });
+        return result;
+    }
+
+    template <typename T>
+    template <typename Func>
+    Tensor<T> Tensor<T>::zip(const Tensor<T>& B, Func func) const {
+        if (dims != B.dims) {
+            throw MismatchedDimensions(dims, B.dims);
+        }
+        Tensor<T> result(dims);
+        if (isContiguous() && B.isContiguous()) {
+            kernels::zip(data_ptr, B.data_ptr, result.data_ptr, N, func);
+            return result;
+        }
+        // Walk A with its own strides and B with its own, writing densely into the result
+        const Tensor<T> dense_B = B.contiguous();
+        T* out = result.data_ptr;
+        const T* b = dense_B.data_ptr;
+        forEachOffset(dims, strides, result.strides, [&](size_t src, size_t dst) { out[dst] = func(data_ptr[src], b[dst]); });
+        return result;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator+(const Tensor<T>& B) const {
+        return zip(B, [](T a, T b) { return a + b; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator-(const Tensor<T>& B) const {
+        return zip(B, [](T a, T b) { return a - b; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator*(const Tensor<T>& B) const {
+        return zip(B, [](T a, T b) { return a * b; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator/(const Tensor<T>& B) const {
+        return zip(B, [](T a, T b) { return a / b; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator+(T x) const {
+        return map([x](T a) { return a + x; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator-(T x) const {
+        return map([x](T a) { return a - x; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator*(T x) const {
+        return map([x](T a) { return a * x; });
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::operator/(T x) const {
+        if (x == 0) {
+            throw DivisionByZero();
+        }
+        return map([x](T a) { return a / x; });
+    }
+
+    template <typename T>
+    Tensor<T>& Tensor<T>::operator+=(const Tensor<T>& B) {
+        if (dims != B.dims) {
+            throw MismatchedDimensions(dims, B.dims);
+        }
+        forEachOffset(dims, strides, B.strides, [&](size_t a, size_t b) { data_ptr[a] += B.data_ptr[b]; });
+        return *this;
+    }
+
+    template <typename T>
+    Tensor<T>& Tensor<T>::operator-=(const Tensor<T>& B) {
+        if (dims != B.dims) {
+            throw MismatchedDimensions(dims, B.dims);
+        }
+        forEachOffset(dims, strides, B.strides, [&](size_t a, size_t b) { data_ptr[a] -= B.data_ptr[b]; });
+        return *this;
+    }
+
+    template <typename T>
+    Tensor<T>& Tensor<T>::operator*=(T x) {
+        if (isContiguous()) {
+            kernels::map(data_ptr, data_ptr, N, [x](T a) { return a * x; });
+            return *this;
+        }
+        forEachOffset(dims, strides, strides, [&](size_t a, size_t) { data_ptr[a] *= x; });
+        return *this;
+    }
+
+    template <typename T>
+    Tensor<T>& Tensor<T>::fill(T x) {
+        if (isContiguous()) {
+            std::fill(data_ptr, data_ptr + N, x);
+            return *this;
+        }
+        forEachOffset(dims, strides, strides, [&](size_t a, size_t) { data_ptr[a] = x; });
+        return *this;
+    }
+
+
+    /// Reductions
+    template <typename T>
+    T Tensor<T>::sum() const {
+        if (isContiguous()) {
+            return kernels::sum(data_ptr, N);
+        }
+        T S = 0;
+        forEachOffset(dims, strides, strides, [&](size_t a, size_t) { S += data_ptr[a]; });
+        return S;
+    }
+
+    template <typename T>
+    T Tensor<T>::mean() const {
+        return sum() / (T)N;
+    }
+
+    template <typename T>
+    T Tensor<T>::max() const {
+        if (N == 0) {
+            throw MatrixError("max() of an empty tensor.");
+        }
+        if (isContiguous()) {
+            return kernels::max(data_ptr, N);
+        }
+        T M = data_ptr[0];
+        forEachOffset(dims, strides, strides, [&](size_t a, size_t) { M = std::max(M, data_ptr[a]); });
+        return M;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::sum(size_t axis) const {
+        if (axis >= dims.size()) {
+            throw IndexError(axis, Shape(1, dims.size()));
+        }
+        std::vector<size_t> outer_dims = dims;
+        std::vector<size_t> outer_strides = strides;
+        outer_dims.erase(outer_dims.begin() + axis);
+        outer_strides.erase(outer_strides.begin() + axis);
+        const size_t reduced = dims[axis];
+        const size_t reduced_stride = strides[axis];
+
+        Tensor<T> result(outer_dims);
+        T* out = result.data_ptr;
+        forEachOffset(outer_dims, outer_strides, result.strides, [&](size_t src, size_t dst) {
+            T S = 0;
+            for (size_t k = 0; k < reduced; k++) {
+                S += data_ptr[src + k*reduced_stride];
+            }
+            out[dst] = S;
+        });
+        return result;
+    }
+
+
+    /// Products
+    template <typename T>
+    Tensor<T> Tensor<T>::matmul(const Tensor<T>& A, const Tensor<T>& B) {
+        TRACE_SCOPE("Tensor::matmul");
+        const size_t ra = A.rank();
+        const size_t rb = B.rank();
+        if (ra < 2 || ra > 3 || rb < 2 || rb > 3 || (ra == 2 && rb == 3)) {
+            throw MismatchedDimensions(A.dims, B.dims);
+        }
+        const size_t M = A.dims[ra-2];
+        const size_t K = A.dims[ra-1];
+        const size_t N = B.dims[rb-1];
+        const size_t batches = (ra == 3) ? A.dims[0] : 1;
+        if (B.dims[rb-2] != K || (rb == 3 && B.dims[0] != batches)) {
+            throw MismatchedDimensions(A.dims, B.dims);
+        }
+
+        // Layout of the last two axes: row-major ('N'), transposed view ('T') or neither
+        auto layout = [](const Tensor<T>& X) {
+            const size_t r = X.rank();
+            const size_t rows = X.dims[r-2], cols = X.dims[r-1];
+            const size_t s_row = X.strides[r-2], s_col = X.strides[r-1];
+            if ((cols == 1 || s_col == 1) && (rows == 1 || s_row == cols)) return 'N';
+            if ((rows == 1 || s_row == 1) && (cols == 1 || s_col == rows)) return 'T';
+            return '?';
+        };
+        Tensor<T> left = A;
+        Tensor<T> right = B;
+        char layout_A = layout(left);
+        char layout_B = layout(right);
+        if (layout_A == '?' || (layout_A == 'T' && layout_B != 'N')) {
+            left = A.copy();
+            layout_A = 'N';
+        }
+        if (layout_B == '?') {
+            right = B.copy();
+            layout_B = 'N';
+        }
+
+        Tensor<T> result(ra == 3 ? std::vector<size_t>{batches, M, N} : std::vector<size_t>{M, N});
+        const size_t A_step = (ra == 3) ? left.strides[0] : 0;
+        const size_t B_step = (rb == 3) ? right.strides[0] : 0;
+        for (size_t batch = 0; batch < batches; batch++) {
+            const T* A_ptr = left.data_ptr + batch*A_step;
+            const T* B_ptr = right.data_ptr + batch*B_step;
+            T* C_ptr = result.data_ptr + batch*M*N;
+            if (layout_A == 'T') {
+                kernels::gemmTransposedA(A_ptr, B_ptr, C_ptr, M, K, N);
+            } else if (layout_B == 'T') {
+                kernels::gemmTransposedB(A_ptr, B_ptr, C_ptr, M, K, N);
+            } else {
+                kernels::gemm(A_ptr, B_ptr, C_ptr, M, K, N);
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Tensor<T> Tensor<T>::matmul(const Tensor<T>& B) const {
+        return matmul(*this, B);
+    }
+
+
+    /// Output
+    template <typename T>
+    void Tensor<T>::print() const {
+        std::cout << std::string(*this) << std::endl;
+    }
+
+    template <typename T>
+    Tensor<T>::operator std::string() const {
+        std::string s = "Tensor (";
+        for (size_t axis = 0; axis < dims.size(); axis++) {
+            s += std::format("{}{}", axis ? "x" : "", dims[axis]);
+        }
+        s += "):\n";
+        const size_t row = dims.empty() ? 1 : dims.back();
+        const size_t block = dims.size() >= 2 ? row * dims[dims.size()-2] : 0;
+        const Tensor<T> dense = contiguous();
+        for (size_t i = 0; i < N; i++) {
+            if (block && i && i % block == 0) s += "\n";
+            if (i % row == 0) s += " [ ";
+            s += std::format("{:>10.6f} ", dense.data_ptr[i]);
+            if ((i + 1) % row == 0) s += "]\n";
+        }
+        // Remove last "\n"
+        if (!s.empty()) {
+            s.pop_back();
+        }
+        return s;
+    }
+
+}
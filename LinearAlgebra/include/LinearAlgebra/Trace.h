@@ -0,0 +1,13 @@
+#ifndef LINALG_CST_LIB_TRACE_H
+#define LINALG_CST_LIB_TRACE_H
+
+// Tracing zones for the kernels. The library only depends on Utils/trace.h when
+// ENABLE_TRACING is defined; otherwise the macros expand to nothing.
+#ifdef ENABLE_TRACING
+    #include <Utils/trace.h>
+#else
+    #define TRACE_SCOPE(name) ((void)0)
+    #define TRACE_SCOPE_ID(name, id) ((void)0)
+#endif
+
+#endif // LINALG_CST_LIB_TRACE_H
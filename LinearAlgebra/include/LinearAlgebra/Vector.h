@@ -65,6 +65,16 @@ namespace linalg {
 
         Vector(Matrix<T>&& matrix);
 
+        /**
+         * @brief Creates a non-owning vector view over N contiguous external elements.
+         * @param data Pointer to the first element
+         * @param N Number of elements
+         * @return Vector viewing `data`
+         * @warning The caller must keep `data` alive for as long as the view is used.
+         * @see Matrix::view()
+         */
+        static Vector<T> view(T* data, size_t N);
+
 
         // ========== METHODS ============
         void setElements(std::vector<T> values);
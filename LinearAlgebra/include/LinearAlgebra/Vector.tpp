@@ -47,17 +47,26 @@ namespace linalg {
         this->class_name = "Vector";
     }
 
+    template <typename T>
+    Vector<T> Vector<T>::view(T* data, size_t N) {
+        return Vector<T>(Matrix<T>::view(data, N, 1));
+    }
+
     // Methods
     template <typename T> 
     void Vector<T>::setElements(std::vector<T> values) {
         setSize(values.size());
+        if (this->isView()) {
+            std::copy(values.begin(), values.end(), this->data());
+            return;
+        }
         this->values = std::move(values);
     }
     
     template <typename T>
     void Vector<T>::setElements(std::initializer_list<T> values) {
         setSize(values.size());
-        this->values = std::move(values);
+        std::copy(values.begin(), values.end(), this->data());
     }
 
     template <typename T>
@@ -93,19 +102,23 @@ namespace linalg {
     // }
     template <typename T>
     Vector<T> &Vector<T>::operator+=(const Vector<T> &B) {
-        return Vector<T>(Matrix<T>::operator+=(B));
+        Matrix<T>::operator+=(B);
+        return *this;
     }
     template <typename T>
     Vector<T> &Vector<T>::operator-=(const Vector<T> &B) {
-        return Vector<T>(Matrix<T>::operator-=(B));
+        Matrix<T>::operator-=(B);
+        return *this;
     }
     template <typename T>
     Vector<T> &Vector<T>::operator*=(const Vector<T> &B) {
-        return Vector<T>(Matrix<T>::operator*=(B));
+        Matrix<T>::operator*=(B);
+        return *this;
     }
     template <typename T>
     Vector<T> &Vector<T>::operator/=(const Vector<T> &B) {
-        return Vector<T>(Matrix<T>::operator/=(B));
+        Matrix<T>::operator/=(B);
+        return *this;
     }
 
     // ========== OPERATORS: SCALAR ==========
@@ -2,15 +2,27 @@
 #define NN_MODEL_ACTIVATION_FUNCTIONS_H
 
 #include <memory>
+#include <functional>
+#include <string>
 #include "BaseActivationFunction.h"
+#include "LinearActivationFunction.h"
 #include "SigmoidActivationFunction.h"
 #include "ReLUActivationFunction.h"
 #include "TanhActivationFunction.h"
+#include "SoftmaxActivationFunction.h"
+
+// Registry of activations by name (getName(), as stored in model files). The built-ins are always
+// known; a custom activation registers its factory before loading the models that use it.
+// Registration is not synchronized: register at startup, before any thread loads a model.
+using ActivationFactory = std::function<std::unique_ptr<BaseActivationFunction>()>;
+void registerActivationFunction(const std::string& name, ActivationFactory factory);
+std::unique_ptr<BaseActivationFunction> makeActivationFunction(const std::string& name); // Null if unknown
 
 // Convenience macros for shorter syntax
-#define LINEAR std::make_unique<BaseActivationFunction>()
+#define LINEAR std::make_unique<LinearActivationFunction>()
 #define SIGMOID std::make_unique<SigmoidActivationFunction>()
 #define RELU std::make_unique<ReLUActivationFunction>()
 #define TANH std::make_unique<TanhActivationFunction>()
+#define SOFTMAX std::make_unique<SoftmaxActivationFunction>()
 
 #endif //NN_MODEL_ACTIVATION_FUNCTIONS_H
\ No newline at end of file
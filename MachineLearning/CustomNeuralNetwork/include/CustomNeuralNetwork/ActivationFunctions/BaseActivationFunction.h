@@ -3,29 +3,79 @@
 
 // Standard lib includes
 #include <vector>
-#include <string>   
+#include <string>
 
 // Forward declarations
 #include <LinearAlgebra/LinAlgFwds.h>
+#include <LinearAlgebra/Epilogue.h>
+
+
+// Built-in activations are tagged, so a whole-buffer pass resolves the activation once (one switch
+// per layer call) and runs the linalg::epilogue stage inlined in its element loop. Softmax is not
+// element-wise: it runs the row-wise linalg::kernels softmax passes instead. Custom activations
+// only override the scalar call() and grad(), and their buffer passes call them per element.
+enum class ActivationType {Identity, ReLU, Sigmoid, Tanh, Softmax, Custom};
+
+// Calls f with the linalg::epilogue stage of an element-wise built-in activation, so f is instantiated
+// once per activation. Returns false for Softmax and Custom, which have no stage.
+template <typename F>
+bool dispatchActivation(ActivationType type, F&& f) {
+    switch (type) {
+        case ActivationType::Identity: f(linalg::epilogue::Identity{}); return true;
+        case ActivationType::ReLU:     f(linalg::epilogue::ReLU{}); return true;
+        case ActivationType::Sigmoid:  f(linalg::epilogue::Sigmoid{}); return true;
+        case ActivationType::Tanh:     f(linalg::epilogue::Tanh{}); return true;
+        default: return false;
+    }
+}
 
 
 // Implementation
 class BaseActivationFunction {
+private:
+    ActivationType type;
+
+    // Second pass of the softmax and custom forwards, over the product y = w*x + b
+    void finishForward(Matrix& y, Matrix* cache) const;
+
+protected:
+    // Built-in subclasses pass their tag
+    explicit BaseActivationFunction(ActivationType type);
+
 public:
-    BaseActivationFunction();
+    BaseActivationFunction(); // Custom: the buffer passes call the (overridden) scalar call() and grad()
     virtual ~BaseActivationFunction();
 
     virtual std::string getName() const;
+    ActivationType getType() const;
 
     virtual float call(float x) const;
     virtual float grad(float x) const;
     float operator()(float x) const;
-    
-    virtual Matrix call(const Matrix& x) const;
-    virtual Matrix grad(const Matrix& x) const;
+
+    Matrix call(const Matrix& x) const;
+    Matrix grad(const Matrix& x) const;
     Matrix operator()(const Matrix& x) const;
+    // Whole-buffer versions writing into an existing buffer of the same shape (out may be x).
+    // Softmax normalizes each row (one sample per row); a column vector is a single sample.
+    void callInto(const Matrix& x, Matrix& out) const;
+    void gradInto(const Matrix& x, Matrix& out) const;
+    // Derivatives from the outputs y = call(z) rather than z: no transcendental for sigmoid and tanh.
+    // Element-wise built-ins only (throws std::logic_error for softmax and custom activations).
+    void gradFromOutputInto(const Matrix& y, Matrix& out) const;
+
+    // Fused dense forward: y = call(w*x + b) computed inside the multiply kernel. Training also
+    // fills the cache that backwardInto() reads, in the same pass: dy/dz for the element-wise
+    // built-ins (from y, so the activation is evaluated once per step), the outputs y for softmax
+    // (its Jacobian-vector product only needs them), the pre-activation z for custom activations.
+    // Inference passes a null cache.
+    void forwardDense(const Matrix& w, const Matrix& x, const Matrix& b, Matrix& y, Matrix* cache) const;
+    // Same for a batch stored as rows: y = call(x*w^T + b), with x (batch x in) and y (batch x out)
+    void forwardDenseBatch(const Matrix& x, const Matrix& w, const Matrix& b, Matrix& y, Matrix* cache) const;
+    // Backward through the activation: delta = upstream * dy/dz, written into delta without allocating
+    void backwardInto(const Matrix& cache, const Matrix& upstream, Matrix& delta) const;
 };
 
 
 
-#endif //NN_MODEL_BASE_ACTIVATION_FUN_H
\ No newline at end of file
+#endif //NN_MODEL_BASE_ACTIVATION_FUN_H
@@ -0,0 +1,15 @@
+#ifndef NN_MODEL_LINEAR_ACTIVATION_FUN_H
+#define NN_MODEL_LINEAR_ACTIVATION_FUN_H
+
+#include "BaseActivationFunction.h"
+
+
+// Identity activation, tagged so its buffer passes skip the per-element virtual calls
+class LinearActivationFunction : public BaseActivationFunction {
+public:
+    // Constructor/Destructor
+    LinearActivationFunction();
+    // ~LinearActivationFunction() {};
+};
+
+#endif //NN_MODEL_LINEAR_ACTIVATION_FUN_H
@@ -7,15 +7,15 @@
 class ReLUActivationFunction : public BaseActivationFunction {
 public:
     // Constructor/Destructor
-    // ReLUActivationFunction() {};
+    ReLUActivationFunction();
     // ~ReLUActivationFunction() {};
 
-    // Override methods from base class
+    // Override methods from base class (the buffer versions dispatch on the ActivationType tag)
     std::string getName() const override;
     float call(float x) const override;
     float grad(float x) const override;
-    Matrix call(const Matrix& x) const override;
-    Matrix grad(const Matrix& x) const override;
+    using BaseActivationFunction::call;
+    using BaseActivationFunction::grad;
 };
 
 #endif //NN_MODEL_RELU_ACTIVATION_FUN_H
@@ -0,0 +1,25 @@
+#ifndef NN_MODEL_SOFTMAX_ACTIVATION_FUN_H
+#define NN_MODEL_SOFTMAX_ACTIVATION_FUN_H
+
+#include "BaseActivationFunction.h"
+
+
+// Output activation for multi-class probabilities: each sample's outputs are exponentiated and
+// normalized to sum to 1. It is not element-wise: the scalar call() and grad() throw, the layer
+// passes work on whole samples. To train on cross-entropy, keep a LINEAR output
+// layer with CROSS_ENTROPY, which applies the softmax itself on the logits.
+class SoftmaxActivationFunction : public BaseActivationFunction {
+public:
+    // Constructor/Destructor
+    SoftmaxActivationFunction();
+    // ~SoftmaxActivationFunction() {};
+
+    // Override methods from base class (the buffer versions dispatch on the ActivationType tag)
+    std::string getName() const override;
+    float call(float x) const override;
+    float grad(float x) const override;
+    using BaseActivationFunction::call;
+    using BaseActivationFunction::grad;
+};
+
+#endif //NN_MODEL_SOFTMAX_ACTIVATION_FUN_H
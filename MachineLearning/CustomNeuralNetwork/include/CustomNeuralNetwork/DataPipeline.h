@@ -0,0 +1,112 @@
+#ifndef NN_MODEL_DATA_PIPELINE_H
+#define NN_MODEL_DATA_PIPELINE_H
+
+// Standard lib includes
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Custom lib includes
+#include <LinearAlgebra/LinAlg.h>
+#include <Utils/queue.h>
+
+
+// Where the training samples come from: a file, a decoder, a generator or an in-memory Matrix.
+// read() may be called concurrently by several producer threads (for disjoint ranges), so
+// implementations must not share mutable state between calls without synchronizing it.
+class DataSource {
+public:
+    virtual ~DataSource() = default;
+
+    virtual size_t getSize() const = 0; // Samples per epoch
+    virtual size_t getInputSize() const = 0;
+    virtual size_t getOutputSize() const = 0;
+    // Writes samples [begin, begin + count) into the rows of x (count x input) and y (count x output)
+    virtual void read(size_t begin, size_t count, Matrix &x, Matrix &y) const = 0;
+};
+
+// Rows of in-memory matrices, which must outlive the source
+class MatrixDataSource : public DataSource {
+private:
+    const Matrix &x;
+    const Matrix &y;
+
+public:
+    MatrixDataSource(const Matrix &x, const Matrix &y);
+    size_t getSize() const override;
+    size_t getInputSize() const override;
+    size_t getOutputSize() const override;
+    void read(size_t begin, size_t count, Matrix &x_batch, Matrix &y_batch) const override;
+};
+
+
+struct PipelineOptions {
+    size_t batch_size = 32;
+    size_t producers = 1;   // Background threads reading batches; 0 reads each batch on the consumer thread
+    size_t depth = 2;       // Batches buffered per producer: 2 double-buffers, 3 triple-buffers
+};
+
+struct PipelineBatch {
+    Matrix x;               // count x input
+    Matrix y;               // count x output
+    size_t epoch = 0;
+    size_t begin = 0;       // First sample of the batch in its epoch
+    std::exception_ptr error; // Thrown by the source or the transform, rethrown by next()
+};
+
+// Runs on the producer thread after read(), e.g. decoding or normalization. Called concurrently
+// when there are several producers.
+using BatchTransform = std::function<void(Matrix &x, Matrix &y)>;
+
+
+// Prefetching stage between a DataSource and NN::fit.
+// The source is streamed as an endless sequence of epochs cut into batches of batch_size samples
+// (the last batch of an epoch may be shorter). Producer p reads and transforms batches p, p + P,
+// p + 2P, ... into its own bounded lock-free ring of `depth` preallocated batches, and the consumer
+// takes them back in order, round-robin over the rings: the sequence is the same for any number of
+// producers, and no batch is allocated once the rings are built. Producers run up to `depth`
+// batches ahead, across epoch boundaries, so reading overlaps with training.
+// The source must outlive the pipeline. next() and release() are for a single consumer thread.
+class DataPipeline {
+private:
+    DataSource &source;
+    PipelineOptions options;
+    BatchTransform transform;
+    size_t batches_per_epoch;
+
+    std::vector<std::unique_ptr<SpscRing<PipelineBatch>>> rings; // One per producer (one inline ring without)
+    size_t consumed = 0;    // Batches released by the consumer
+    size_t stalls = 0;      // next() calls that found their batch not ready yet
+    bool holding = false;   // Between next() and release()
+    std::atomic<bool> stopping{false};
+    std::vector<std::thread> producers; // Last: start once everything above is constructed
+
+    void fill(PipelineBatch &batch, size_t sequence) const;
+    void producerLoop(size_t producer);
+
+public:
+    // Constructor/Destructor
+    DataPipeline(DataSource &source, PipelineOptions options = PipelineOptions(), BatchTransform transform = nullptr);
+    ~DataPipeline(); // Stops the producers, dropping the batches they prefetched
+    DataPipeline(const DataPipeline&) = delete;
+    DataPipeline& operator=(const DataPipeline&) = delete;
+
+    // Getters
+    const PipelineOptions& getOptions() const;
+    size_t getSamples() const; // Per epoch
+    size_t getBatchesPerEpoch() const;
+    size_t getInputSize() const;
+    size_t getOutputSize() const;
+    size_t getStallCount() const; // How often training waited for data
+
+    // Methods
+    // Next batch in sequence, blocking until it is ready. Valid until release(), which hands its buffers back.
+    const PipelineBatch& next();
+    void release();
+};
+
+
+#endif //NN_MODEL_DATA_PIPELINE_H
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <cstddef>
 
 // Custom lib includes
 #include <LinearAlgebra/LinAlg.h>
@@ -13,6 +14,22 @@
 class BaseActivationFunction;
 class BaseInitializationFunction;
 class BaseOptimizer;
+struct ModelFileLayer;
+
+
+// Per-batch activations and gradients of a DenseLayer (one sample per row). The layer owns one
+// set; data-parallel training gives each worker thread its own, so workers only share the weights.
+struct DenseLayerBuffers {
+    const Matrix* x = nullptr; // Input of the last forwardBatch() (not owned, read in backwardBatch())
+    Matrix z;                  // Activation cache: dy/dz (z itself for custom activations)
+    Matrix y;
+    Matrix delta;
+    Matrix grad_input;
+    Matrix grad_w;
+    Vector grad_b;
+    Matrix shared_w;           // Hogwild: this worker's copy of the parameters other threads are updating
+    Vector shared_b;
+};
 
 
 // Implementation
@@ -22,12 +39,16 @@ private:
     int input_dim;
     int output_dim;
     std::unique_ptr<BaseActivationFunction> activation;
-    Vector x;    
+    const Vector* x = nullptr; // Input of the last forward() (not owned, read in backward())
     Matrix w; 
     Vector b;
-    Vector z;
+    Vector z; // Activation cache, as in DenseLayerBuffers
     Vector y;
     Vector delta;
+    Vector grad_input;
+    DenseLayerBuffers batch;
+    Matrix window_inputs;  // Per-sample gradient accumulation: input and delta of every sample
+    Matrix window_deltas;  // of the window, one per row
     void auxiliaryActivationGenerator(std::string &buffer);
     
 public:
@@ -50,21 +71,48 @@ public:
     const Vector& getCache() const;
     const Vector& getOutput() const;
     const Vector& getDelta() const;
-    Vector& getInput();
     Matrix& getWeights();
     Vector& getBiases();
     Vector& getCache();
     Vector& getOutput();
     Vector& getDelta();
+    const Matrix& getBatchOutput() const;
+    const Matrix& getWeightsGradient() const;
+    const Vector& getBiasesGradient() const;
 
     // Methods
     void preAllocate();
     void initialize(BaseInitializationFunction* initializer);
-    Vector forward(const Vector& x);
-    Vector backward(const Vector& last_grad);
+    // Parameter arena (see ParameterArena): the weights, biases and batch gradients become views of these buffers
+    void bindParameters(float* weights, float* biases, float* weights_gradient, float* biases_gradient);
+    void bindGradients(DenseLayerBuffers& buffers, float* weights_gradient, float* biases_gradient) const;
+    const Vector& forward(const Vector& x, bool store_preactivation=true);
+    // Inference only: writes the output to out and stores nothing, so threads can share the layer
+    void forward(const Vector& x, Vector& out) const;
+    const Vector& backward(const Vector& last_grad);
+    const Matrix& forwardBatch(const Matrix& x, bool store_preactivation=true);
+    // accumulate: the batch gradients are added to the stored ones (gradient accumulation) instead of replacing them
+    const Matrix& backwardBatch(const Matrix& last_grad, bool propagate=true, bool accumulate=false);
+    // Same, with caller-provided buffers: only reads the parameters, so threads can share the layer
+    const Matrix& forwardBatch(const Matrix& x, DenseLayerBuffers& buffers, bool store_preactivation=true) const;
+    const Matrix& backwardBatch(const Matrix& last_grad, DenseLayerBuffers& buffers, bool propagate=true, bool accumulate=false) const;
+    // Per-sample gradient accumulation: storeSample() keeps the input and delta of the last backward()
+    // as row `row` of a window of `window` samples; windowGradients() turns the first `rows` of them
+    // into the batch gradients (times scale) with one rank-k product, instead of one rank-1 weight
+    // update per sample
+    void storeSample(size_t row, size_t window);
+    void windowGradients(size_t rows, float scale);
+    // Hogwild: forwardBatch() on a copy of the parameters read with relaxed atomic loads, since other
+    // threads write them concurrently (BaseOptimizer::updateShared)
+    const Matrix& forwardShared(const Matrix& x, DenseLayerBuffers& buffers) const;
+    // Only the delta (and the gradient for the previous layer, through the weights forwardShared() read),
+    // for optimizers that apply delta and input directly
+    const Matrix& backwardDelta(const Matrix& last_grad, DenseLayerBuffers& buffers, bool propagate=true) const;
     void print() const;
     void save(std::ostream& output);
     void load(std::istream& input);
+    // Binary model format: the weights and biases become views into the mapped file (no copy)
+    void load(const ModelFileLayer& record, std::byte* file, const std::string& activation_name);
 };
 
 
@@ -0,0 +1,77 @@
+#ifndef NN_MODEL_DYNAMIC_BATCHER_H
+#define NN_MODEL_DYNAMIC_BATCHER_H
+
+// Standard lib includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+// Custom lib includes
+#include <LinearAlgebra/LinAlg.h>
+#include <CustomNeuralNetwork/InferenceSession.h>
+#include <Utils/queue.h>
+
+// Forward declarations
+class NN;
+
+
+// Throughput/latency trade-off of a DynamicBatcher
+struct BatchingOptions {
+    size_t max_batch_size = 32; // Larger batches: fewer, more efficient forward passes
+    size_t max_wait_us = 200;   // Longest the first request of a batch waits for others to join
+};
+
+
+// Batching front end for online inference.
+// Callers submit one feature vector at a time from any thread (lock-free MPSC queue) and get a
+// future. A scheduler thread groups the pending requests into one batch (until max_batch_size
+// requests or max_wait_us after the first one arrived), runs a single batched forward pass and
+// completes the futures. The model must outlive the batcher and must not be trained meanwhile.
+class DynamicBatcher {
+private:
+    struct Request {
+        Vector input;
+        std::promise<Vector> result;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    InferenceSession session;
+    BatchingOptions options;
+    MpscQueue<Request> queue;
+    std::vector<Request> batch;
+    Matrix batch_input;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> sleeping{false};
+    std::atomic<uint32_t> wake_signal{0};
+    std::atomic<size_t> batch_count{0};
+    std::atomic<size_t> request_count{0};
+    std::thread scheduler; // Last: starts once everything above is constructed
+
+    void schedulerLoop();
+    void waitForRequests();
+    void runBatch();
+    void wake();
+
+public:
+    // Constructor/Destructor
+    explicit DynamicBatcher(const NN& model, BatchingOptions options = BatchingOptions());
+    ~DynamicBatcher(); // Serves every submitted request, then stops. No submit() may run concurrently.
+    DynamicBatcher(const DynamicBatcher&) = delete;
+    DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+    // Getters
+    const BatchingOptions& getOptions() const;
+    size_t getBatchCount() const;
+    size_t getRequestCount() const;
+    double getMeanBatchSize() const;
+
+    // Methods
+    std::future<Vector> submit(Vector x);
+};
+
+
+#endif //NN_MODEL_DYNAMIC_BATCHER_H
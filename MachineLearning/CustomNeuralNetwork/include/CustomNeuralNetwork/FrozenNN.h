@@ -0,0 +1,68 @@
+#ifndef NN_MODEL_FROZEN_NN_H
+#define NN_MODEL_FROZEN_NN_H
+
+// Standard lib includes
+#include <vector>
+#include <string>
+#include <memory>
+#include <initializer_list>
+
+// Custom lib includes
+#include <LinearAlgebra/LinAlg.h>
+#include <CustomNeuralNetwork/ActivationFunctions/BaseActivationFunction.h>
+
+// Forward declarations
+class NN;
+
+
+// Immutable, inference-only compilation of a trained NN (see NN::freeze()).
+// Only the parameters are kept: the weights are re-packed for the packed GEMM micro-kernel
+// (linalg::kernels::packPanels), each layer runs as one product with bias and activation fused,
+// and all layers share two ping-pong activation buffers. No optimizer, loss, deltas or inputs.
+// The plan is independent of the source NN. Copies share the (read-only) plan and get their own
+// buffers, so one copy per thread predicts concurrently.
+class FrozenNN {
+private:
+    struct Layer {
+        size_t input_dim;
+        size_t output_dim;
+        ActivationType activation; // Fused into the layer's epilogue (softmax: a pass after it)
+        size_t weights_offset;  // Packed weights, in Plan::parameters
+        size_t biases_offset;
+    };
+    struct Plan {
+        size_t input_size = 0;
+        size_t output_size = 0;
+        size_t max_width = 0;   // Widest layer output: sizes the ping-pong buffers
+        std::vector<Layer> layers;
+        std::vector<float> parameters;
+    };
+
+    std::shared_ptr<const Plan> plan;
+    Matrix buffers[2];
+    Vector output;
+
+    static ActivationType fusedActivation(const BaseActivationFunction& function);
+    const float* run(const float* x, size_t rows);
+
+public:
+    // Constructor/Destructor
+    explicit FrozenNN(const NN& model);
+
+    // Getters
+    size_t getInputSize() const;
+    size_t getOutputSize() const;
+    size_t getLayerCount() const;
+    size_t getMemoryBytes() const; // Parameters and buffers of this copy
+
+    // Methods
+    // The returned output lives in this object and is overwritten by the next call
+    const Vector& predict(const Vector& x);
+    const Vector& predict(const float* x);
+    const Vector& predict(std::initializer_list<float> x);
+    // One sample per row: (batch x input) -> (batch x output)
+    const Matrix& predictBatch(const Matrix& x);
+};
+
+
+#endif //NN_MODEL_FROZEN_NN_H
@@ -0,0 +1,47 @@
+#ifndef NN_MODEL_INFERENCE_SESSION_H
+#define NN_MODEL_INFERENCE_SESSION_H
+
+// Standard lib includes
+#include <vector>
+#include <initializer_list>
+
+// Custom lib includes
+#include <LinearAlgebra/LinAlg.h>
+
+// Forward declarations
+class NN;
+struct DenseLayerBuffers;
+
+
+// Scratch buffers for running a trained NN without touching it.
+// The model is only read, so any number of sessions (one per thread) can predict concurrently
+// from one shared NN; each session holds activations only, never weights. The model must outlive
+// its sessions and must not be trained while they run.
+class InferenceSession {
+private:
+    const NN* model;
+    Vector input_buffer;
+    std::vector<Vector> activations;             // One output per layer
+    std::vector<DenseLayerBuffers> batch_buffers; // One per layer, for predictBatch()
+
+public:
+    // Constructor/Destructor
+    explicit InferenceSession(const NN& model);
+    ~InferenceSession();
+    InferenceSession(InferenceSession&&) noexcept;
+    InferenceSession& operator=(InferenceSession&&) noexcept;
+
+    // Getters
+    const NN& getModel() const;
+
+    // Methods
+    // The returned output lives in the session and is overwritten by the next call
+    const Vector& predict(const Vector& x);
+    const Vector& predict(const float* x);
+    const Vector& predict(std::initializer_list<float> x);
+    // One sample per row: (batch x input) -> (batch x output)
+    const Matrix& predictBatch(const Matrix& x);
+};
+
+
+#endif //NN_MODEL_INFERENCE_SESSION_H
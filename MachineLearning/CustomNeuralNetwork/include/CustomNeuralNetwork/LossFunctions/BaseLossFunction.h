@@ -23,6 +23,16 @@ public:
     virtual Vector call(const Vector &y_predict, const Vector &y_target) const;
     virtual Vector grad(const Vector &y_predict, const Vector &y_target) const;
     Vector operator()(const Vector &y_predict, const Vector &y_target) const;
+
+    // Element-wise over a batch (one sample per row)
+    virtual Matrix call(const Matrix &y_predict, const Matrix &y_target) const;
+    virtual Matrix grad(const Matrix &y_predict, const Matrix &y_target) const;
+
+    // Non-allocating variants for the training loop: the summed loss, and the gradient written into grad
+    virtual float value(const Matrix &y_predict, const Matrix &y_target) const;
+    virtual void gradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const;
+    // Both at once: returns the summed loss and writes the gradient (a single pass where the loss fuses them)
+    virtual float valueAndGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const;
 };
 
 #endif //NN_MODEL_BASE_LOSS_FUNCTION_H
\ No newline at end of file
@@ -4,8 +4,10 @@
 #include <memory>
 #include "BaseLossFunction.h"
 #include "MeanSquaredErrorLossFunction.h"
+#include "SoftmaxCrossEntropyLossFunction.h"
 
 // Convenience macros for shorter syntax
 #define MSE std::make_unique<MeanSquaredErrorLossFunction>()
+#define CROSS_ENTROPY std::make_unique<SoftmaxCrossEntropyLossFunction>()
 
 #endif //NN_MODEL_LOSS_FUNCTIONS_H
\ No newline at end of file
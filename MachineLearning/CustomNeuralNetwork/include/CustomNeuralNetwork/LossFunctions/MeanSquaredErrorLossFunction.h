@@ -10,6 +10,11 @@ public:
     float grad(float y_predict, float y_target) const override;
     Vector call(const Vector &y_predict, const Vector &y_target) const override;
     Vector grad(const Vector &y_predict, const Vector &y_target) const override;
+    Matrix call(const Matrix &y_predict, const Matrix &y_target) const override;
+    Matrix grad(const Matrix &y_predict, const Matrix &y_target) const override;
+    float value(const Matrix &y_predict, const Matrix &y_target) const override;
+    void gradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const override;
+    float valueAndGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const override;
 };
 
 #endif //NN_MODEL_MEAN_SQUARED_ERROR_LOSS_H
\ No newline at end of file
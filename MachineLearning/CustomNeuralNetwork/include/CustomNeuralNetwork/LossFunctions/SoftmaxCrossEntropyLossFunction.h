@@ -0,0 +1,25 @@
+#ifndef NN_MODEL_SOFTMAX_CROSS_ENTROPY_LOSS_H
+#define NN_MODEL_SOFTMAX_CROSS_ENTROPY_LOSS_H
+
+#include "BaseLossFunction.h"
+
+// Softmax + cross-entropy over the raw network outputs (logits): pair it with a LINEAR output layer.
+// The targets of each sample are class probabilities (usually one-hot). Loss and gradient come
+// from one log-sum-exp-stable kernel (linalg::kernels::softmaxCrossEntropy), and the gradient with
+// respect to the logits is simply softmax(z) - y. A per-sample Vector is one sample; batches hold
+// one sample per row. The scalar overloads throw: the loss is not element-wise.
+class SoftmaxCrossEntropyLossFunction : public BaseLossFunction {
+public:
+    std::string getName() const override;
+    float call(float y_predict, float y_target) const override;
+    float grad(float y_predict, float y_target) const override;
+    Vector call(const Vector &y_predict, const Vector &y_target) const override;
+    Vector grad(const Vector &y_predict, const Vector &y_target) const override;
+    Matrix call(const Matrix &y_predict, const Matrix &y_target) const override;
+    Matrix grad(const Matrix &y_predict, const Matrix &y_target) const override;
+    float value(const Matrix &y_predict, const Matrix &y_target) const override;
+    void gradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const override;
+    float valueAndGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const override;
+};
+
+#endif //NN_MODEL_SOFTMAX_CROSS_ENTROPY_LOSS_H
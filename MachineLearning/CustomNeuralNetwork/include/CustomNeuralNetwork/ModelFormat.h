@@ -0,0 +1,137 @@
+#ifndef NN_MODEL_FORMAT_H
+#define NN_MODEL_FORMAT_H
+
+// Standard lib includes
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+// Binary model file (little-endian), version 2:
+//
+//   [ModelFileHeader]                    128 bytes, at offset 0
+//   [ModelFileLayer x layer_count]       layer table, at header.layer_table_offset
+//   [string table]                       names, not NUL-terminated, referenced by ModelFileString
+//   [weights | biases] per layer         raw float32 blobs, each starting on a 64-byte boundary
+//
+// The blobs are used in place: NN::load() maps the file and the layers view their parameters
+// straight in the mapping. The checksum covers the whole file, read with the header's checksum
+// field zeroed, so corrupted sizes, offsets or hyperparameters are detected too.
+// Version 1 files (no optimizer hyperparameters, zeros in their place, a checksum of the bytes
+// after the header only) are still read.
+
+static_assert(std::endian::native == std::endian::little, "The binary model format is little-endian");
+
+inline constexpr char MODEL_FILE_MAGIC[8] = {'C', 'N', 'N', 'M', 'O', 'D', 'E', 'L'};
+inline constexpr uint32_t MODEL_FILE_VERSION = 2;
+inline constexpr uint32_t MODEL_FILE_MIN_VERSION = 1;
+inline constexpr uint64_t MODEL_FILE_ALIGNMENT = 64; // Cache line (and widest SIMD load)
+
+struct ModelFileString {
+    uint32_t offset = 0; // From the start of the string table
+    uint32_t length = 0;
+};
+
+struct ModelFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;           // sizeof(ModelFileHeader), for forward compatibility
+    uint64_t file_size;
+    uint64_t checksum;              // ModelChecksum of bytes [0, file_size), this field read as zero
+    int32_t input_size;
+    int32_t output_size;
+    uint32_t layer_count;
+    float learning_rate;
+    uint64_t layer_table_offset;
+    uint64_t string_table_offset;
+    uint64_t string_table_size;
+    ModelFileString model_name;
+    ModelFileString problem_type;
+    ModelFileString initializer;
+    ModelFileString loss;
+    ModelFileString optimizer;
+    float optimizer_hyperparameters[4]; // BaseOptimizer::getHyperparameters(), zero-padded
+};
+
+struct ModelFileLayer {
+    int32_t layer_id;
+    int32_t input_dim;
+    int32_t output_dim;
+    ModelFileString activation;
+    uint32_t reserved;
+    uint64_t weights_offset;        // output_dim x input_dim floats, row-major
+    uint64_t biases_offset;         // output_dim floats
+};
+
+static_assert(std::is_trivially_copyable_v<ModelFileHeader> && sizeof(ModelFileHeader) == 128);
+static_assert(std::is_trivially_copyable_v<ModelFileLayer> && sizeof(ModelFileLayer) == 40);
+
+inline uint64_t alignModelOffset(uint64_t offset) {
+    return (offset + MODEL_FILE_ALIGNMENT - 1) / MODEL_FILE_ALIGNMENT * MODEL_FILE_ALIGNMENT;
+}
+
+
+// Streaming 64-bit checksum (xxHash64-style rounds on 4 independent lanes of 8-byte words).
+// Detects truncated or corrupted files at memory speed; not a cryptographic hash.
+class ModelChecksum {
+private:
+    static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr size_t BLOCK = 32;
+
+    uint64_t lanes[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+    unsigned char pending[BLOCK];
+    size_t pending_size = 0;
+    uint64_t total = 0;
+
+    static uint64_t round(uint64_t lane, uint64_t word) {
+        return std::rotl(lane + word * PRIME2, 31) * PRIME1;
+    }
+
+    void block(const unsigned char* data) {
+        for (size_t k = 0; k < 4; k++) {
+            uint64_t word;
+            std::memcpy(&word, data + 8*k, 8);
+            lanes[k] = round(lanes[k], word);
+        }
+    }
+
+public:
+    void update(const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        total += bytes;
+        if (pending_size > 0) {
+            size_t take = std::min(bytes, BLOCK - pending_size);
+            std::memcpy(pending + pending_size, p, take);
+            pending_size += take;
+            p += take;
+            bytes -= take;
+            if (pending_size < BLOCK) return;
+            block(pending);
+            pending_size = 0;
+        }
+        for (; bytes >= BLOCK; p += BLOCK, bytes -= BLOCK) {
+            block(p);
+        }
+        std::memcpy(pending, p, bytes);
+        pending_size = bytes;
+    }
+
+    uint64_t digest() const {
+        uint64_t h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+        h ^= total;
+        for (size_t i = 0; i < pending_size; i++) {
+            h = std::rotl(h ^ (pending[i] * PRIME1), 11) * PRIME2;
+        }
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        return h;
+    }
+};
+
+
+#endif //NN_MODEL_FORMAT_H
@@ -4,9 +4,14 @@
 // Standard lib includes
 #include <vector>
 #include <string>
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include <random>
 
 // Custom lib includes
 #include <LinearAlgebra/LinAlg.h>
+#include <CustomNeuralNetwork/ParameterArena.h>
 
 // Forward declarations
 class BaseActivationFunction;
@@ -14,6 +19,65 @@ class BaseInitializationFunction;
 class BaseLossFunction;
 class BaseOptimizer;
 class DenseLayer;
+struct DenseLayerBuffers;
+class WorkerPool;
+class MappedFile;
+class FrozenNN;
+class QuantizedNN;
+struct QuantizationOptions;
+class DataPipeline;
+
+
+// How fit() uses several threads (see NN::setThreads)
+enum class ParallelMode {
+    SYNCHRONOUS,    // Mini-batches split across threads, gradients all-reduced before one update
+    HOGWILD         // Threads train disjoint samples and update the shared weights without locks
+};
+
+// Which epochs of fit() compute the training loss (see NN::setLossReporting)
+enum class LossReporting {
+    EVERY_EPOCH,    // Every epoch, fused with the output gradient
+    LOGGED_EPOCHS   // Only the printed epochs (and every epoch while an epoch callback is set)
+};
+
+// When fit() stops before its requested epochs (see NN::setEarlyStopping). Every criterion is
+// checked after each epoch; a zero (or null) field disables its criterion.
+struct EarlyStopping {
+    size_t patience = 0;                    // Epochs without improvement of the monitored metric before stopping
+    float min_delta = 0.0f;                 // Smallest change of the metric counted as an improvement
+    float target_loss = 0.0f;               // Stops once the mean training loss is at or below it
+    double time_budget = 0.0;               // Seconds of training, checked at the end of each epoch
+    // Held-out set monitored with evaluate() (the loss for regression, the accuracy for classification)
+    // instead of the training loss; needs a REGRESSION or CLASSIFICATION NN. Not copied: both must outlive fit()
+    const Matrix* x_validation = nullptr;
+    const Matrix* y_validation = nullptr;
+    bool restore_best = true;               // Ends fit() with the parameters of the best monitored epoch
+};
+
+enum class StopReason {
+    EPOCHS,         // Ran every requested epoch
+    PLATEAU,
+    TARGET_LOSS,
+    TIME_BUDGET
+};
+
+// Outcome of the last fit()
+struct FitSummary {
+    size_t epochs = 0;              // Epochs actually run
+    StopReason reason = StopReason::EPOCHS;
+    size_t best_epoch = 0;          // Epoch with the best monitored metric (0-based)
+    float best_metric = 0;          // Training loss, or the validation metric if a validation set is given
+    bool restored = false;          // Whether the parameters were rolled back to best_epoch
+};
+
+// Staleness and throughput of one epoch of Hogwild training
+struct AsyncEpochStats {
+    size_t updates = 0;             // Parameter updates (one per sample)
+    double mean_staleness = 0;      // Updates by other threads between reading the weights and writing the update
+    size_t max_staleness = 0;
+    double samples_per_second = 0;
+    float loss = 0;                 // Mean training loss of the epoch (NaN if the epoch did not compute it)
+};
 
 
 // Implementation
@@ -26,22 +90,59 @@ private:
     int layers_num = 0;
     // int HL;
 
+    std::shared_ptr<MappedFile> mapped_file; // Holds the parameters of a model loaded from a binary file
     std::vector<DenseLayer> layers;
+    ParameterArena arena; // Bound by fit(): until then the parameters stay where they are (e.g. a mapped file)
     std::vector<float> loss_history;
+    std::vector<float> allocation_history; // Allocations per sample (LINALG_INSTRUMENTATION only)
     bool initialized = false;
 
     std::unique_ptr<BaseInitializationFunction> initializer;
     std::unique_ptr<BaseActivationFunction> activation;
     std::unique_ptr<BaseLossFunction> loss;
     std::unique_ptr<BaseOptimizer> optimizer;
+    std::function<void(size_t epoch, float loss)> epoch_callback;
 
-    Vector y_predict;
     Vector input_buffer;
     Vector target_buffer;
+    Vector output_grad;
+    Matrix batch_grad;
+    // Data-parallel training: each worker thread has its own activations and gradients
+    struct alignas(64) WorkerStats { // One cache line per worker: no false sharing
+        float loss = 0;
+        uint64_t staleness = 0;
+        uint64_t max_staleness = 0;
+    };
+    size_t accumulation_steps = 1;
+    size_t threads = 1;
+    ParallelMode parallel_mode = ParallelMode::SYNCHRONOUS;
+    LossReporting loss_reporting = LossReporting::EVERY_EPOCH;
+    bool track_loss = true; // Whether the training passes return the loss: cleared by fit() on unreported epochs
+    EarlyStopping early_stopping;
+    FitSummary fit_summary;
+    std::vector<float> best_parameters; // Arena snapshot of the best epoch, reused from one improvement to the next
+    std::vector<std::vector<DenseLayerBuffers>> worker_buffers; // Gradients bound to the arena set of the worker
+    std::vector<Matrix> worker_grad;
+    std::vector<WorkerStats> worker_stats;
+    std::vector<AsyncEpochStats> async_history;
     const float* input_ptr;
     const float* target_ptr;
+    // Epoch shuffling: the matrices stay in place, fit() visits their rows through a permutation
+    bool shuffle = false;
+    std::mt19937_64 shuffle_rng;
+    std::vector<size_t> epoch_order;
+    Matrix x_gather;    // Shuffled mini-batch, gathered into one contiguous buffer
+    Matrix y_gather;
+
+    void shuffleEpoch(size_t samples); // Next permutation of [0, samples) in epoch_order
 
-    float accuracy;
+    // Epoch loop shared by both fit(): setup, logging and early stopping around train_epoch, which
+    // trains one epoch (on the pool, if the mode uses one) and returns its summed loss
+    void trainEpochs(size_t samples, size_t epochs, int print_count, size_t batch_size,
+                     const std::function<float(WorkerPool *pool)> &train_epoch);
+    // One mini-batch of a window: gradients scaled by `scale`, optimizer step if `step`
+    float trainMiniBatch(const Matrix &x_batch, const Matrix &y_batch, WorkerPool *pool,
+                         float scale, bool accumulate, bool step);
 
 public:
     // Constructor/Destructor
@@ -60,33 +161,79 @@ public:
     // Getters/Setters
     const Vector& getOutput() const;
     const std::vector<float>& getLossHistory() const;
+    const std::vector<float>& getAllocationHistory() const;
     std::vector<DenseLayer>& getLayers();
+    const std::vector<DenseLayer>& getLayers() const;
+    ParameterArena& getParameterArena();
+    const ParameterArena& getParameterArena() const;
+    int getInputSize() const;
+    int getOutputSize() const;
     void setActivationFunction(std::unique_ptr<BaseActivationFunction> function);
     void setInitializationFunction(std::unique_ptr<BaseInitializationFunction> init);
     void setLossFunction(std::unique_ptr<BaseLossFunction> function);
     void setOptimizer(std::unique_ptr<BaseOptimizer> opt, float learning_rate=1e-3);
+    const BaseOptimizer* getOptimizer() const;
+    void setEpochCallback(std::function<void(size_t epoch, float loss)> callback); // Called after every epoch of fit()
+    void setThreads(size_t threads, ParallelMode mode=ParallelMode::SYNCHRONOUS); // 0 uses every hardware thread
+    size_t getThreads() const;
+    // Gradients of `steps` samples (batch_size = 1) or mini-batches are accumulated before each optimizer step
+    void setGradientAccumulation(size_t steps);
+    size_t getGradientAccumulation() const;
+    ParallelMode getParallelMode() const;
+    const std::vector<AsyncEpochStats>& getAsyncHistory() const; // One entry per Hogwild epoch
+    // Every epoch of the Matrix fit() visits the samples in a new random order, drawn from `seed`
+    void setShuffle(bool enabled, uint64_t seed=0);
+    bool getShuffle() const;
+    void setLossReporting(LossReporting mode);
+    LossReporting getLossReporting() const;
+    void setEarlyStopping(const EarlyStopping &criteria); // EarlyStopping{} disables it
+    const EarlyStopping& getEarlyStopping() const;
+    const FitSummary& getFitSummary() const;
 
     // Methods
     void addLayer(DenseLayer &layer);
     void initialize();
-    void forward(const float *input);
-    void forward(const Vector &x);
-    void backward(const float *target);
-    void backward(const Vector &y_target);
-    void fit(const Matrix &x_train, const Matrix &y_train, size_t epochs=100, int print_count=20);
+    void forward(const float *input, bool training=true);
+    void forward(const Vector &x, bool training=true);
+    // The backward passes return the summed loss of their samples, computed with the output gradient
+    float backward(const float *target);
+    float backward(const Vector &y_target);
+    void forwardBatch(const Matrix &x_batch, bool training=true);
+    float backwardBatch(const Matrix &y_batch);
+    // Gradients only: the loss gradient is scaled by `scale` and added to the stored gradients if accumulate
+    float accumulateBatch(const Matrix &y_batch, float scale, bool accumulate);
+    float accumulateSample(const Vector &y_target, size_t row); // Kept as row `row` of the window (see DenseLayer::storeSample)
+    // Writes the loss gradient into grad, and returns the summed loss while the loss is tracked (0 otherwise)
+    float lossGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const;
+    void applyGradients(); // One optimizer step with the stored gradients
+    float trainBatchParallel(const Matrix &x_batch, const Matrix &y_batch, WorkerPool &pool,
+                             float scale, bool accumulate=false, bool step=true);
+    float trainEpochHogwild(const Matrix &x_train, const Matrix &y_train, WorkerPool &pool);
+    void fit(const Matrix &x_train, const Matrix &y_train, size_t epochs=100, int print_count=20, size_t batch_size=1);
+    // Mini-batches streamed from a prefetching pipeline (its batch size), so reading overlaps with training
+    void fit(DataPipeline &pipeline, size_t epochs=100, int print_count=20);
     float evaluate(const Matrix &x_test, const Matrix &y_test);
+    float score(const Matrix &y_predict, const Matrix &y_test) const; // Metric of evaluate() for precomputed predictions
     Vector& predict(Vector &x);
     Vector& predict(const std::initializer_list<float> &x);
+    FrozenNN freeze() const; // Immutable inference-only plan with packed weights
+    QuantizedNN quantize(const Matrix &calibration) const; // Post-training int8 quantization
+    QuantizedNN quantize(const Matrix &calibration, const QuantizationOptions &options) const;
 
     void validateNetwork(const std::string &caller) const;
     void print() const;
-    void save();
-    void save(const std::string &file_name);
+    void save(); // Binary format, to Model_{name}_{date}.cnn
+    void save(const std::string &file_name); // Text format for a .txt extension, binary format otherwise
+    void saveText(const std::string &file_name);
+    void saveBinary(const std::string &file_name);
     void auxiliaryInitializerGenerator(std::string &buffer);
     void auxiliaryLossGenerator(std::string &buffer);
     void auxiliaryOptimizerGenerator(std::string &buffer, float lr);
     void auxiliaryPreAllocatorFunction();
-    void load(const std::string &file_name);
+    void bindParameterArena(size_t gradient_sets);
+    void load(const std::string &file_name, bool verify_checksum=true); // Detects the format
+    void loadText(const std::string &file_name);
+    void loadBinary(const std::string &file_name, bool verify_checksum=true);
 };
 
 
@@ -2,23 +2,44 @@
 #define NN_MODEL_ADAM_OPTIMIZER_H
 
 #include "BaseOptimizer.h"
-#include <unordered_map>
-#include <cmath>
+#include <LinearAlgebra/LinAlg.h>
+#include <vector>
 
+
+// Adam, or AdamW when weight_decay > 0 (decoupled decay of the weights, not the biases).
+// The first and second moments of every parameter tensor are dense buffers shaped like it, and
+// one fused pass per tensor updates m, v and the parameters. Each tensor is updated once per
+// training step, so its own step count drives the bias correction, computed once per update.
+// With a ParameterArena, one step covers every tensor of the network in a single pass.
+// The moments are found by the address of the layer's weights: the NN calls reset() whenever it
+// moves its parameters (arena binding, initialization), so a reused address never inherits them.
 class AdaptativeMomentOptimizer : public BaseOptimizer {
 private:
-    float learning_rate, beta1, beta2, epsilon;
-    int t; // Time step
-    
-    // Maps to store the first and second moments for each weight's memory address
-    std::unordered_map<float*, float> m; 
-    std::unordered_map<float*, float> v;
+    float beta1, beta2, epsilon, weight_decay;
+
+    struct Moments {
+        const float* parameters = nullptr; // Weights of the layer this state belongs to
+        size_t t = 0;                      // Time step
+        Matrix m_w, v_w;
+        Vector m_b, v_b;
+    };
+    std::vector<Moments> moments; // One per layer: found by a linear scan, not a per-parameter lookup
+    Moments flat;                 // Multi-tensor steps: the moments of the whole arena, in m_w and v_w
+
+    Moments& momentsFor(const Matrix& w, const Vector& b);
 
 public:
-    AdaptativeMomentOptimizer(float lr = 0.001f, float b1 = 0.9f, float b2 = 0.999f, float eps = 1e-8f);
+    AdaptativeMomentOptimizer(float lr = 0.001f, float b1 = 0.9f, float b2 = 0.999f, float eps = 1e-8f, float weight_decay = 0.0f);
     std::string getName() const override;
-    // void update(float& weight, float gradient) override;
+    float getWeightDecay() const;
+    std::vector<float> getHyperparameters() const override; // beta1, beta2, epsilon, weight_decay
+    void setHyperparameters(const std::vector<float>& values) override;
+    void reset() override; // Drops the moments and step counts
+    void update(Matrix& w, Vector& b, float grad, const float* input, int signal_size) override;
+    void update(Matrix& w, Vector& b, const Vector& delta, const Vector& input) override;
+    void update(Matrix& w, Vector& b, const Matrix& grad_w, const Vector& grad_b) override;
+    void update(const ParameterSpan& span) override;
 };
 
 
-#endif //NN_MODEL_ADAM_OPTIMIZER_H
\ No newline at end of file
+#endif //NN_MODEL_ADAM_OPTIMIZER_H
@@ -3,11 +3,23 @@
 
 // Std lib includes
 #include <string>
+#include <cstddef>
+#include <vector>
 
 // Forward Declarations
 #include <LinearAlgebra/LinAlgFwds.h>
 
 
+// Every parameter of a network as one flat array, with its gradients in the same layout (see
+// ParameterArena). The weights come first, so decay-only-on-weights is a prefix of the array.
+struct ParameterSpan {
+    float* parameters;
+    const float* gradients;
+    size_t size;
+    size_t weight_count;
+};
+
+
 class BaseOptimizer {
 protected:
     float learning_rate;
@@ -22,11 +34,23 @@ public:
     virtual std::string getName() const;
     void setLearningRate(float lr);
     float getLearningRate() const;
+    // Hyperparameters besides the learning rate, in a fixed order: saved and restored with the model
+    virtual std::vector<float> getHyperparameters() const;
+    virtual void setHyperparameters(const std::vector<float>& values);
+    // Drops any state tied to the current parameter buffers (called when the network rebinds them)
+    virtual void reset();
     // void setParameters(Matrix& weights, Vector& biases);
 
     // Updates a single weight given its gradient
     virtual void update(Matrix& w, Vector& b, float grad, const float* input, int signal_size) = 0;
     virtual void update(Matrix& weights, Vector& b, const Vector& delta, const Vector& input) = 0;
+    // Applies dense gradients (e.g. averaged over a mini-batch)
+    virtual void update(Matrix& w, Vector& b, const Matrix& grad_w, const Vector& grad_b) = 0;
+    // Multi-tensor step: one pass over all the parameters of the network
+    virtual void update(const ParameterSpan& span) = 0;
+    // Lock-free update of parameters shared by several training threads (Hogwild): w -= lr * delta * input^T,
+    // with delta and input stored flat. Throws if the optimizer keeps state that cannot be updated this way.
+    virtual void updateShared(Matrix& w, Vector& b, const Matrix& delta, const Matrix& input);
 };
 
 
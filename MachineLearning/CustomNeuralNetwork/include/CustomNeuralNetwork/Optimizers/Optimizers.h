@@ -8,5 +8,6 @@
 // Convenience macros for shorter syntax
 #define SGD std::make_unique<StochasticGDOptimizer>()
 #define ADAM std::make_unique<AdaptativeMomentOptimizer>()
+#define ADAMW std::make_unique<AdaptativeMomentOptimizer>(1e-3f, 0.9f, 0.999f, 1e-8f, 1e-2f)
 
 #endif //NN_MODEL_OPTIMIZERS_H
\ No newline at end of file
@@ -11,6 +11,9 @@ public:
     std::string getName() const override;
     void update(Matrix& w, Vector& b, float grad, const float* input, int signal_size) override;
     void update(Matrix& w, Vector& b, const Vector& delta, const Vector& input) override;
+    void update(Matrix& w, Vector& b, const Matrix& grad_w, const Vector& grad_b) override;
+    void update(const ParameterSpan& span) override;
+    void updateShared(Matrix& w, Vector& b, const Matrix& delta, const Matrix& input) override;
 };
 
 
@@ -0,0 +1,60 @@
+#ifndef NN_MODEL_PARAMETER_ARENA_H
+#define NN_MODEL_PARAMETER_ARENA_H
+
+// Standard lib includes
+#include <vector>
+#include <cstddef>
+
+// Forward declarations
+class DenseLayer;
+struct DenseLayerBuffers;
+struct ParameterSpan;
+
+
+// All the trainable parameters of a network in one contiguous, cache-line aligned buffer, followed
+// by gradient sets with the same layout (one per training worker). Every weight matrix comes first,
+// then every bias vector, each tensor starting on a cache line; the padding stays zero. The layers
+// keep their Matrix/Vector members, rebound as views into the arena, so an optimizer step, a
+// gradient all-reduce or a checkpoint is one pass or one memcpy over the whole model.
+class ParameterArena {
+private:
+    static constexpr size_t ALIGNMENT = 16; // Floats per cache line
+
+    struct Slot {
+        size_t weights_offset;
+        size_t biases_offset;
+    };
+    std::vector<float> storage;     // Over-allocated by one cache line, so the arena can start on one
+    float* parameters = nullptr;    // Gradient set s starts at parameters + (s + 1) * size
+    size_t size = 0;                // Floats per set, padding included
+    size_t weight_count = 0;        // Weights end here, biases follow
+    size_t gradient_sets = 0;
+    std::vector<Slot> slots;
+
+public:
+    // Getters
+    // Whether the layers are views into this arena, with at least `gradient_sets` gradient sets
+    bool isBound(const std::vector<DenseLayer>& layers, size_t gradient_sets=1) const;
+    size_t getSize() const;
+    size_t getWeightCount() const;
+    size_t getGradientSets() const;
+    float* getParameters();
+    const float* getParameters() const;
+    float* getGradients(size_t set=0);
+    const float* getGradients(size_t set=0) const;
+    ParameterSpan getSpan(size_t set=0); // Parameters with the gradients of `set`, for BaseOptimizer::update()
+
+    // Methods
+    // Copies the parameters of the layers into a new arena and makes their weights, biases and
+    // batch gradients (set 0) views of it. Views bound to a previous layout are left dangling.
+    void bind(std::vector<DenseLayer>& layers, size_t gradient_sets=1);
+    // Makes the gradients of one worker's buffers views of gradient set `set`
+    void bindGradients(const std::vector<DenseLayer>& layers, std::vector<DenseLayerBuffers>& buffers, size_t set);
+    void zeroGradients(size_t set=0);
+    void accumulateGradients(size_t target, size_t source); // Set target += set source
+    void snapshot(std::vector<float>& out) const; // Every parameter, in one copy
+    void restore(const std::vector<float>& in);
+};
+
+
+#endif //NN_MODEL_PARAMETER_ARENA_H
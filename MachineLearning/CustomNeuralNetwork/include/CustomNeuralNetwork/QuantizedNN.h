@@ -0,0 +1,88 @@
+#ifndef NN_MODEL_QUANTIZED_NN_H
+#define NN_MODEL_QUANTIZED_NN_H
+
+// Standard lib includes
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <initializer_list>
+
+// Custom lib includes
+#include <LinearAlgebra/LinAlg.h>
+#include <CustomNeuralNetwork/ActivationFunctions/BaseActivationFunction.h>
+
+// Forward declarations
+class NN;
+
+
+// How the range of each layer's input is measured on the calibration data
+enum class CalibrationMethod {
+    MIN_MAX,        // Largest absolute value: nothing is clipped
+    PERCENTILE      // Percentile of the absolute values: outliers are clipped, the rest gets finer steps
+};
+
+struct QuantizationOptions {
+    CalibrationMethod method = CalibrationMethod::MIN_MAX;
+    float percentile = 99.99f;      // PERCENTILE only, in (0, 100]
+};
+
+
+// Post-training int8 quantization of a trained NN (see NN::quantize()), for inference only.
+// Weights are quantized symmetrically with one scale per output channel (row). The input of every
+// layer is quantized with one scale, calibrated by running the fp32 model over a calibration Matrix.
+// Each layer is one int8 product with int32 accumulation (linalg::kernels::gemmInt8Epilogue),
+// dequantized with bias and activation fused before the float store; the next layer re-quantizes it.
+// Like FrozenNN, copies share the read-only plan and get their own buffers.
+class QuantizedNN {
+private:
+    struct Layer {
+        size_t input_dim;
+        size_t output_dim;
+        ActivationType activation; // Fused into the layer's epilogue (softmax: a pass after it)
+        float input_scale;
+        size_t weights_offset;  // In Plan::weights
+        size_t scales_offset;   // Input scale times channel scale, in Plan::parameters
+        size_t biases_offset;
+    };
+    struct Plan {
+        size_t input_size = 0;
+        size_t output_size = 0;
+        size_t max_width = 0;
+        size_t max_input = 0;   // Widest layer input: sizes the quantized input buffer
+        std::vector<Layer> layers;
+        std::vector<int8_t> weights;
+        std::vector<float> parameters;
+    };
+
+    std::shared_ptr<const Plan> plan;
+    std::vector<int8_t> quantized_input;
+    Matrix buffers[2];
+    Vector output;
+
+    static ActivationType fusedActivation(const BaseActivationFunction& function);
+    const float* run(const float* x, size_t rows);
+
+public:
+    // Constructor/Destructor
+    QuantizedNN(const NN& model, const Matrix& calibration, const QuantizationOptions& options = {});
+
+    // Getters
+    size_t getInputSize() const;
+    size_t getOutputSize() const;
+    size_t getLayerCount() const;
+    size_t getParameterBytes() const; // Weights, scales and biases
+    size_t getMemoryBytes() const;    // Parameters and buffers of this copy
+    std::vector<float> getInputScales() const; // One per layer
+
+    // Methods
+    // The returned output lives in this object and is overwritten by the next call
+    const Vector& predict(const Vector& x);
+    const Vector& predict(const float* x);
+    const Vector& predict(std::initializer_list<float> x);
+    // One sample per row: (batch x input) -> (batch x output)
+    const Matrix& predictBatch(const Matrix& x);
+};
+
+
+#endif //NN_MODEL_QUANTIZED_NN_H
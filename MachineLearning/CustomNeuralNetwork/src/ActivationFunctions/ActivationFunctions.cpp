@@ -0,0 +1,40 @@
+#include <CustomNeuralNetwork/ActivationFunctions/ActivationFunctions.h>
+
+#include <unordered_map>
+#include <stdexcept>
+#include <format>
+
+
+namespace {
+    std::unordered_map<std::string, ActivationFactory>& registry() {
+        static std::unordered_map<std::string, ActivationFactory> factories = {
+            {"LINEAR",  [] { return LINEAR; }},
+            {"SIGMOID", [] { return SIGMOID; }},
+            {"RELU",    [] { return RELU; }},
+            {"TANH",    [] { return TANH; }},
+            {"SOFTMAX", [] { return SOFTMAX; }},
+        };
+        return factories;
+    }
+}
+
+void registerActivationFunction(const std::string& name, ActivationFactory factory) {
+    if (!factory) {
+        throw std::invalid_argument(std::format("Null factory for activation function: {}", name));
+    }
+    // A tag other than Custom would route the buffer passes to a built-in kernel, ignoring the overrides
+    std::unique_ptr<BaseActivationFunction> sample = factory();
+    if (!sample || sample->getType() != ActivationType::Custom || sample->getName() != name) {
+        throw std::invalid_argument(std::format(
+            "Activation function {} must be named after its registry entry and tagged ActivationType::Custom", name));
+    }
+    registry()[name] = std::move(factory);
+}
+
+std::unique_ptr<BaseActivationFunction> makeActivationFunction(const std::string& name) {
+    auto it = registry().find(name);
+    if (it == registry().end()) {
+        return nullptr;
+    }
+    return it->second();
+}
@@ -1,9 +1,26 @@
 #include <CustomNeuralNetwork/ActivationFunctions/BaseActivationFunction.h>
 #include <LinearAlgebra/LinAlg.h>
 
+#include <stdexcept>
+#include <format>
 
-// Constructor/Destructor 
-BaseActivationFunction::BaseActivationFunction() {
+
+namespace {
+    // Softmax rows of a buffer: a per-sample Vector is one column, batches hold a sample per row
+    size_t softmaxSamples(const Matrix& m) {
+        return m.getShape().cols == 1 ? 1 : m.getShape().rows;
+    }
+
+    size_t softmaxClasses(const Matrix& m) {
+        return m.getShape().cols == 1 ? m.getShape().rows : m.getShape().cols;
+    }
+}
+
+// Constructor/Destructor
+BaseActivationFunction::BaseActivationFunction() : type(ActivationType::Custom) {
+}
+
+BaseActivationFunction::BaseActivationFunction(ActivationType type) : type(type) {
 }
 
 BaseActivationFunction::~BaseActivationFunction() {
@@ -14,6 +31,10 @@ std::string BaseActivationFunction::getName() const {
     return "LINEAR";
 }
 
+ActivationType BaseActivationFunction::getType() const {
+    return type;
+}
+
 // Methods
 float BaseActivationFunction::call(float x) const {
     return x;
@@ -24,11 +45,88 @@ float BaseActivationFunction::grad(float x) const {
 }
 
 Matrix BaseActivationFunction::call(const Matrix& x) const {
-    return x;
+    Matrix out(x.getShape().rows, x.getShape().cols);
+    callInto(x, out);
+    return out;
 }
 
 Matrix BaseActivationFunction::grad(const Matrix& x) const {
-    return Matrix();
+    Matrix out(x.getShape().rows, x.getShape().cols);
+    gradInto(x, out);
+    return out;
+}
+
+void BaseActivationFunction::callInto(const Matrix& x, Matrix& out) const {
+    if (type == ActivationType::Softmax) {
+        if (out.getShape() != x.getShape()) out.resize(x.getShape().rows, x.getShape().cols);
+        linalg::kernels::softmaxRows(x.data(), out.data(), softmaxSamples(x), softmaxClasses(x));
+    } else if (!dispatchActivation(type, [&](auto act) { linalg::transformInto(x, out, act); })) {
+        linalg::transformInto(x, out, [this](float v) { return this->call(v); });
+    }
+}
+
+void BaseActivationFunction::gradInto(const Matrix& x, Matrix& out) const {
+    if (type == ActivationType::Softmax) {
+        throw std::logic_error("Softmax has no element-wise derivative: use backwardInto()");
+    }
+    if (!dispatchActivation(type, [&](auto act) { linalg::transformInto(x, out, [act](float v) { return act.grad(v); }); })) {
+        linalg::transformInto(x, out, [this](float v) { return this->grad(v); });
+    }
+}
+
+void BaseActivationFunction::gradFromOutputInto(const Matrix& y, Matrix& out) const {
+    if (!dispatchActivation(type, [&](auto act) {
+            linalg::transformInto(y, out, [act](float v) { return act.gradFromOutput(v); });
+        })) {
+        throw std::logic_error(std::format("Activation function {} has no element-wise derivative in terms of its output", getName()));
+    }
+}
+
+void BaseActivationFunction::forwardDense(const Matrix& w, const Matrix& x, const Matrix& b, Matrix& y, Matrix* cache) const {
+    if (!dispatchActivation(type, [&](auto act) {
+            Matrix::dotFusedInto(w, x, y, linalg::epilogue::RowBias<float>{b.data()},
+                                 linalg::epilogue::WithGrad<decltype(act)>{}, cache);
+        })) {
+        // Softmax and custom: the bias is fused, the activation is a second pass over y
+        Matrix::dotFusedInto(w, x, y, linalg::epilogue::RowBias<float>{b.data()}, linalg::epilogue::Identity{},
+                             type == ActivationType::Custom ? cache : nullptr);
+        finishForward(y, cache);
+    }
+}
+
+void BaseActivationFunction::forwardDenseBatch(const Matrix& x, const Matrix& w, const Matrix& b, Matrix& y, Matrix* cache) const {
+    if (!dispatchActivation(type, [&](auto act) {
+            Matrix::dotTransposedFusedInto(x, w, y, linalg::epilogue::ColBias<float>{b.data()},
+                                           linalg::epilogue::WithGrad<decltype(act)>{}, cache);
+        })) {
+        Matrix::dotTransposedFusedInto(x, w, y, linalg::epilogue::ColBias<float>{b.data()}, linalg::epilogue::Identity{},
+                                       type == ActivationType::Custom ? cache : nullptr);
+        finishForward(y, cache);
+    }
+}
+
+void BaseActivationFunction::finishForward(Matrix& y, Matrix* cache) const {
+    callInto(y, y);
+    // Custom activations cached z in the product; softmax keeps its outputs
+    if (cache && type == ActivationType::Softmax) {
+        linalg::transformInto(y, *cache, [](float p) { return p; });
+    }
+}
+
+void BaseActivationFunction::backwardInto(const Matrix& cache, const Matrix& upstream, Matrix& delta) const {
+    if (type == ActivationType::Custom) {
+        linalg::transformInto(cache, upstream, delta, [this](float z, float g) { return g * this->grad(z); });
+    } else if (type == ActivationType::Softmax) {
+        if (cache.getShape() != upstream.getShape()) {
+            throw linalg::MismatchedShapes(cache.getShape(), upstream.getShape());
+        }
+        if (delta.getShape() != cache.getShape()) delta.resize(cache.getShape().rows, cache.getShape().cols);
+        linalg::kernels::softmaxBackwardRows(cache.data(), upstream.data(), delta.data(),
+                                             softmaxSamples(cache), softmaxClasses(cache));
+    } else {
+        // The cache already holds dy/dz: a plain multiply, whatever the activation
+        linalg::transformInto(cache, upstream, delta, [](float d, float g) { return g * d; });
+    }
 }
 
 
@@ -0,0 +1,5 @@
+#include <CustomNeuralNetwork/ActivationFunctions/LinearActivationFunction.h>
+
+
+LinearActivationFunction::LinearActivationFunction() : BaseActivationFunction(ActivationType::Identity) {
+}
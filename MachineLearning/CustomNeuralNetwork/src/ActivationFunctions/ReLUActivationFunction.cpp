@@ -2,6 +2,9 @@
 #include <LinearAlgebra/LinAlg.h>
 
 
+ReLUActivationFunction::ReLUActivationFunction() : BaseActivationFunction(ActivationType::ReLU) {
+}
+
 std::string ReLUActivationFunction::getName() const {
     return "RELU";
 }
@@ -15,18 +18,3 @@ float ReLUActivationFunction::grad(float x) const {
     if (x>0) return 1.0f;
     else return 0.0f;
 }
-
-Matrix ReLUActivationFunction::call(const Matrix& x) const {
-    // Manually implemented to be faster than (x>0)*x
-    Matrix result = x;
-    for (size_t i = 0; i<result.getShape().N; i++) {
-        if (result[i] < 0) {
-            result.setElement(0, i);
-        }
-    }
-    return result;
-}
-
-Matrix ReLUActivationFunction::grad(const Matrix& x) const {
-    return (x>0);
-}
\ No newline at end of file
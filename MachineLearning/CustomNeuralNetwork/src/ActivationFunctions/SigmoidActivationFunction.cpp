@@ -3,6 +3,9 @@
 #include <cmath>
 
 
+SigmoidActivationFunction::SigmoidActivationFunction() : BaseActivationFunction(ActivationType::Sigmoid) {
+}
+
 std::string SigmoidActivationFunction::getName() const {
     return "SIGMOID";
 }
@@ -15,11 +18,3 @@ float SigmoidActivationFunction::grad(float x) const {
     float aux = call(x);
     return aux * (1 - aux);
 }
-
-Matrix SigmoidActivationFunction::call(const Matrix& m) const {
-    return linalg::transform(m, [this](float x) { return this->call(x); });
-}
-
-Matrix SigmoidActivationFunction::grad(const Matrix& m) const {
-    return linalg::transform(m, [this](float x) { return this->grad(x); });
-}
\ No newline at end of file
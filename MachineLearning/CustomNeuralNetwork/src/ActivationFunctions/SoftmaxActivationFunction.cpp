@@ -0,0 +1,21 @@
+#include <CustomNeuralNetwork/ActivationFunctions/SoftmaxActivationFunction.h>
+#include <LinearAlgebra/LinAlg.h>
+
+#include <stdexcept>
+
+
+SoftmaxActivationFunction::SoftmaxActivationFunction() : BaseActivationFunction(ActivationType::Softmax) {
+}
+
+std::string SoftmaxActivationFunction::getName() const {
+    return "SOFTMAX";
+}
+
+// Softmax normalizes over a whole sample: a single value has no meaningful result
+float SoftmaxActivationFunction::call(float) const {
+    throw std::logic_error("Softmax is not element-wise: use the buffer call()/callInto()");
+}
+
+float SoftmaxActivationFunction::grad(float) const {
+    throw std::logic_error("Softmax has no element-wise derivative: use backwardInto()");
+}
@@ -3,6 +3,9 @@
 #include <cmath>
 
 
+TanhActivationFunction::TanhActivationFunction() : BaseActivationFunction(ActivationType::Tanh) {
+}
+
 std::string TanhActivationFunction::getName() const {
     return "TANH";
 }
@@ -14,11 +17,3 @@ float TanhActivationFunction::call(float x) const {
 float TanhActivationFunction::grad(float x) const {
     return 1 - pow(tanh(x),2);
 }
-
-Matrix TanhActivationFunction::call(const Matrix& m) const {
-    return linalg::transform(m, [this](float x) { return this->call(x); });
-}
-
-Matrix TanhActivationFunction::grad(const Matrix& m) const {
-    return linalg::transform(m, [this](float x) { return this->grad(x); });
-}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include <CustomNeuralNetwork/DataPipeline.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <format>
+
+
+// MatrixDataSource
+MatrixDataSource::MatrixDataSource(const Matrix &x, const Matrix &y) : x(x), y(y) {
+    if (x.getShape().rows != y.getShape().rows) {
+        throw std::invalid_argument(std::format("{} input rows but {} target rows", x.getShape().rows, y.getShape().rows));
+    }
+}
+
+size_t MatrixDataSource::getSize() const {
+    return x.getShape().rows;
+}
+
+size_t MatrixDataSource::getInputSize() const {
+    return x.getShape().cols;
+}
+
+size_t MatrixDataSource::getOutputSize() const {
+    return y.getShape().cols;
+}
+
+void MatrixDataSource::read(size_t begin, size_t count, Matrix &x_batch, Matrix &y_batch) const {
+    // Consecutive rows are contiguous: one copy per matrix
+    std::copy(x.getRow(begin), x.getRow(begin) + count*x.getShape().cols, x_batch.data());
+    std::copy(y.getRow(begin), y.getRow(begin) + count*y.getShape().cols, y_batch.data());
+}
+
+
+// Constructor/Destructor
+DataPipeline::DataPipeline(DataSource &source, PipelineOptions options, BatchTransform transform) :
+    source(source),
+    options(options),
+    transform(std::move(transform))
+{
+    if (options.batch_size == 0) {
+        throw std::invalid_argument("Batch size must be at least 1");
+    }
+    if (options.depth == 0) {
+        throw std::invalid_argument("A pipeline needs at least one buffered batch per producer");
+    }
+    if (source.getSize() == 0) {
+        throw std::invalid_argument("The data source has no samples");
+    }
+    batches_per_epoch = (source.getSize() + options.batch_size - 1) / options.batch_size;
+
+    // Every slot holds a full batch: shorter last batches shrink it without reallocating
+    PipelineBatch prototype;
+    prototype.x.resize(options.batch_size, source.getInputSize());
+    prototype.y.resize(options.batch_size, source.getOutputSize());
+    size_t ring_count = std::max<size_t>(options.producers, 1);
+    size_t depth = options.producers ? options.depth : 1;
+    rings.reserve(ring_count);
+    for (size_t r = 0; r < ring_count; r++) {
+        rings.push_back(std::make_unique<SpscRing<PipelineBatch>>(depth, prototype));
+    }
+    producers.reserve(options.producers);
+    for (size_t p = 0; p < options.producers; p++) {
+        producers.emplace_back(&DataPipeline::producerLoop, this, p);
+    }
+}
+
+DataPipeline::~DataPipeline() {
+    stopping.store(true, std::memory_order_seq_cst);
+    for (auto &ring : rings) {
+        ring->notify();
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+}
+
+// Getters
+const PipelineOptions& DataPipeline::getOptions() const {
+    return options;
+}
+
+size_t DataPipeline::getSamples() const {
+    return source.getSize();
+}
+
+size_t DataPipeline::getBatchesPerEpoch() const {
+    return batches_per_epoch;
+}
+
+size_t DataPipeline::getInputSize() const {
+    return source.getInputSize();
+}
+
+size_t DataPipeline::getOutputSize() const {
+    return source.getOutputSize();
+}
+
+size_t DataPipeline::getStallCount() const {
+    return stalls;
+}
+
+// Methods
+void DataPipeline::fill(PipelineBatch &batch, size_t sequence) const {
+    TRACE_SCOPE("DataPipeline::fill");
+    batch.epoch = sequence / batches_per_epoch;
+    batch.begin = (sequence % batches_per_epoch) * options.batch_size;
+    size_t count = std::min(options.batch_size, source.getSize() - batch.begin);
+    batch.x.resize(count, source.getInputSize());
+    batch.y.resize(count, source.getOutputSize());
+    batch.error = nullptr;
+    try {
+        source.read(batch.begin, count, batch.x, batch.y);
+        if (transform) {
+            transform(batch.x, batch.y);
+        }
+    } catch (...) {
+        batch.error = std::current_exception();
+    }
+}
+
+void DataPipeline::producerLoop(size_t producer) {
+    SpscRing<PipelineBatch> &ring = *rings[producer];
+    for (size_t sequence = producer; ; sequence += options.producers) {
+        PipelineBatch* batch = ring.writeSlot();
+        while (!batch) {
+            // Full ring: sleep until the consumer releases a batch (or the pipeline stops)
+            uint32_t observed = ring.observe();
+            if (stopping.load(std::memory_order_seq_cst)) return;
+            batch = ring.writeSlot();
+            if (!batch) ring.wait(observed);
+        }
+        if (stopping.load(std::memory_order_relaxed)) return;
+        fill(*batch, sequence);
+        ring.commit();
+    }
+}
+
+const PipelineBatch& DataPipeline::next() {
+    if (holding) {
+        throw std::logic_error("The previous batch must be released before taking the next one");
+    }
+    SpscRing<PipelineBatch> &ring = *rings[consumed % rings.size()];
+    PipelineBatch* batch = ring.readSlot();
+    if (!batch && producers.empty()) {
+        fill(*ring.writeSlot(), consumed);
+        ring.commit();
+        batch = ring.readSlot();
+    }
+    if (!batch) {
+        TRACE_SCOPE("DataPipeline::stall");
+        stalls++;
+        while (!batch) {
+            uint32_t observed = ring.observe();
+            batch = ring.readSlot();
+            if (!batch) ring.wait(observed);
+        }
+    }
+    holding = true;
+    if (batch->error) {
+        // The batch is lost, the sequence goes on with the next one
+        std::exception_ptr error = batch->error;
+        release();
+        std::rethrow_exception(error);
+    }
+    return *batch;
+}
+
+void DataPipeline::release() {
+    if (!holding) {
+        throw std::logic_error("No batch to release: call next() first");
+    }
+    rings[consumed % rings.size()]->release();
+    consumed++;
+    holding = false;
+}
@@ -2,7 +2,10 @@
 #include <CustomNeuralNetwork/ActivationFunctions/ActivationFunctions.h>
 #include <CustomNeuralNetwork/InitializationFunctions/InitializationFunctions.h>
 #include <CustomNeuralNetwork/Optimizers/Optimizers.h>
+#include <CustomNeuralNetwork/ModelFormat.h>
+#include <Utils/trace.h>
 #include <iomanip>
+#include <atomic>
 
 
 // Constructors
@@ -56,7 +59,7 @@ int DenseLayer::getOutputDim() const {
     return output_dim; 
 }
 const Vector &DenseLayer::getInput() const {
-    return x;
+    return *x;
 }
 const Matrix &DenseLayer::getWeights() const {
     return w;
@@ -73,9 +76,6 @@ const Vector &DenseLayer::getOutput() const {
 const Vector &DenseLayer::getDelta() const {
     return delta;
 }
-Vector &DenseLayer::getInput() {
-    return x;
-}
 Matrix &DenseLayer::getWeights() {
     return w;
 }
@@ -91,29 +91,146 @@ Vector &DenseLayer::getOutput() {
 Vector &DenseLayer::getDelta() {
     return delta;
 }
+const Matrix &DenseLayer::getBatchOutput() const {
+    return batch.y;
+}
+const Matrix &DenseLayer::getWeightsGradient() const {
+    return batch.grad_w;
+}
+const Vector &DenseLayer::getBiasesGradient() const {
+    return batch.grad_b;
+}
 
 // Methods
 void DenseLayer::preAllocate() {
-    x.setSize(input_dim);
     z.setSize(output_dim);
     y.setSize(output_dim);
     delta.setSize(output_dim);
+    grad_input.setSize(input_dim);
 }
 
 void DenseLayer::initialize(BaseInitializationFunction* initializer) {
     initializer->initialize(w, b);
 }
 
-Vector DenseLayer::forward(const Vector& x) {
-    this->x = x;
-    z = w.dotAdd(x, b);
-    y = activation->call(z);
+void DenseLayer::bindParameters(float* weights, float* biases, float* weights_gradient, float* biases_gradient) {
+    w.rebind(weights);
+    b.rebind(biases);
+    bindGradients(batch, weights_gradient, biases_gradient);
+}
+
+void DenseLayer::bindGradients(DenseLayerBuffers& buffers, float* weights_gradient, float* biases_gradient) const {
+    // Shaped first, so backwardBatch() never needs to resize the views
+    buffers.grad_w.resize(output_dim, input_dim);
+    buffers.grad_b.setSize(output_dim);
+    buffers.grad_w.rebind(weights_gradient);
+    buffers.grad_b.rebind(biases_gradient);
+}
+
+const Vector& DenseLayer::forward(const Vector& x, bool store_preactivation) {
+    TRACE_SCOPE_ID("DenseLayer::forward", layer_id);
+    // The input (the network input buffer or the previous layer output) outlives backward(): no copy
+    this->x = &x;
+    // Bias and activation are fused into the product; the cache (dy/dz, see BaseActivationFunction)
+    // is only filled when backward() will need it
+    activation->forwardDense(w, x, b, y, store_preactivation ? &z : nullptr);
     return y;
 }
 
-Vector DenseLayer::backward(const Vector& last_grad) {
-    delta = last_grad * activation->grad(z);
-    return w.transposedDot(delta);
+void DenseLayer::forward(const Vector& x, Vector& out) const {
+    TRACE_SCOPE_ID("DenseLayer::forward", layer_id);
+    activation->forwardDense(w, x, b, out, nullptr);
+}
+
+const Vector& DenseLayer::backward(const Vector& last_grad) {
+    TRACE_SCOPE_ID("DenseLayer::backward", layer_id);
+    // Both results go to buffers sized by preAllocate(), so the steady state does not allocate
+    activation->backwardInto(z, last_grad, delta);
+    Matrix::transposedDotInto(w, delta, grad_input);
+    return grad_input;
+}
+
+const Matrix& DenseLayer::forwardBatch(const Matrix& x, bool store_preactivation) {
+    return forwardBatch(x, batch, store_preactivation);
+}
+
+const Matrix& DenseLayer::backwardBatch(const Matrix& last_grad, bool propagate, bool accumulate) {
+    return backwardBatch(last_grad, batch, propagate, accumulate);
+}
+
+const Matrix& DenseLayer::forwardBatch(const Matrix& x, DenseLayerBuffers& buffers, bool store_preactivation) const {
+    TRACE_SCOPE_ID("DenseLayer::forwardBatch", layer_id);
+    // The input (a view into the training data or the previous layer output) outlives backwardBatch()
+    buffers.x = &x;
+    activation->forwardDenseBatch(x, w, b, buffers.y, store_preactivation ? &buffers.z : nullptr);
+    return buffers.y;
+}
+
+const Matrix& DenseLayer::backwardBatch(const Matrix& last_grad, DenseLayerBuffers& buffers, bool propagate, bool accumulate) const {
+    TRACE_SCOPE_ID("DenseLayer::backwardBatch", layer_id);
+    activation->backwardInto(buffers.z, last_grad, buffers.delta);
+    // Gradients summed over the batch: last_grad already carries the 1/batch factor
+    if (accumulate) {
+        Matrix::rankUpdateInto(buffers.delta, *buffers.x, buffers.grad_w);
+        Matrix::addColumnSumsInto(buffers.delta, buffers.grad_b);
+    } else {
+        Matrix::transposedDotInto(buffers.delta, *buffers.x, buffers.grad_w);
+        Matrix::sumColumnsInto(buffers.delta, buffers.grad_b);
+    }
+    // The first layer has no one to propagate to
+    if (propagate) {
+        Matrix::dotInto(buffers.delta, w, buffers.grad_input);
+    }
+    return buffers.grad_input;
+}
+
+void DenseLayer::storeSample(size_t row, size_t window) {
+    if (window_inputs.getShape().rows != window) {
+        window_inputs.resize(window, input_dim);
+        window_deltas.resize(window, output_dim);
+    }
+    std::copy(x->data(), x->data() + input_dim, window_inputs.data() + row*input_dim);
+    std::copy(delta.data(), delta.data() + output_dim, window_deltas.data() + row*output_dim);
+}
+
+void DenseLayer::windowGradients(size_t rows, float scale) {
+    TRACE_SCOPE_ID("DenseLayer::windowGradients", layer_id);
+    const Matrix inputs = Matrix::view(window_inputs.data(), rows, input_dim);
+    Matrix deltas = Matrix::view(window_deltas.data(), rows, output_dim);
+    // Scaling the deltas (rows x output) is cheaper than scaling the gradients (output x input)
+    deltas *= scale;
+    Matrix::transposedDotInto(deltas, inputs, batch.grad_w);
+    Matrix::sumColumnsInto(deltas, batch.grad_b);
+}
+
+// Element-wise relaxed atomic loads: pairs with the relaxed stores of BaseOptimizer::updateShared()
+static void loadShared(const Matrix& source, Matrix& copy) {
+    if (copy.getShape() != source.getShape()) {
+        copy.resize(source.getShape().rows, source.getShape().cols);
+    }
+    float* shared = const_cast<float*>(source.data());
+    float* out = copy.data();
+    for (size_t i = 0; i < source.getShape().N; i++) {
+        out[i] = std::atomic_ref<float>(shared[i]).load(std::memory_order_relaxed);
+    }
+}
+
+const Matrix& DenseLayer::forwardShared(const Matrix& x, DenseLayerBuffers& buffers) const {
+    TRACE_SCOPE_ID("DenseLayer::forwardShared", layer_id);
+    loadShared(w, buffers.shared_w);
+    loadShared(b, buffers.shared_b);
+    buffers.x = &x;
+    activation->forwardDenseBatch(x, buffers.shared_w, buffers.shared_b, buffers.y, &buffers.z);
+    return buffers.y;
+}
+
+const Matrix& DenseLayer::backwardDelta(const Matrix& last_grad, DenseLayerBuffers& buffers, bool propagate) const {
+    TRACE_SCOPE_ID("DenseLayer::backwardDelta", layer_id);
+    activation->backwardInto(buffers.z, last_grad, buffers.delta);
+    if (propagate) {
+        Matrix::dotInto(buffers.delta, buffers.shared_w, buffers.grad_input);
+    }
+    return buffers.grad_input;
 }
 
 void DenseLayer::print() const {
@@ -148,11 +265,8 @@ void DenseLayer::save(std::ostream &output) {
 }
 
 inline void DenseLayer::auxiliaryActivationGenerator(std::string& buffer) {
-    // Handle activation (MAY BE MOVED TO ITS OWN GENERATOR CLASS)
-    if (buffer == "LINEAR") setActivationFunction(LINEAR);
-    else if (buffer == "SIGMOID") setActivationFunction(SIGMOID);
-    else if (buffer == "TANH") setActivationFunction(TANH);
-    else if (buffer == "RELU") setActivationFunction(RELU);
+    // Handle activation: built-in names and registered custom activations (null if unknown)
+    setActivationFunction(makeActivationFunction(buffer));
 }
 
 void DenseLayer::load(std::istream &input) {    
@@ -163,6 +277,9 @@ void DenseLayer::load(std::istream &input) {
     // Summary: LAYER {ID} {TYPE} {INPUT_DIM} {OUTPUT_DIM} {ACTIVATION}
     input >> buffer >> layer_id >> buffer >> input_dim >> output_dim >> buffer;
     auxiliaryActivationGenerator(buffer);
+    if (!activation) {
+        throw std::runtime_error(std::format("Unknown activation function: {}", buffer));
+    }
 
     // Weights: WEIGHTS {ROWS} {COLS}
     size_t rows, cols;
@@ -184,4 +301,21 @@ void DenseLayer::load(std::istream &input) {
     }
 
     preAllocate();
-}
\ No newline at end of file
+}
+
+void DenseLayer::load(const ModelFileLayer &record, std::byte *file, const std::string &activation_name) {
+    layer_id = record.layer_id;
+    input_dim = record.input_dim;
+    output_dim = record.output_dim;
+    std::string buffer = activation_name;
+    auxiliaryActivationGenerator(buffer);
+    if (!activation) {
+        throw std::runtime_error(std::format("Unknown activation function: {}", activation_name));
+    }
+
+    // Used in place: pages are only read from disk when touched, and writes (training) stay private
+    w = Matrix::view(reinterpret_cast<float*>(file + record.weights_offset), output_dim, input_dim);
+    b = Vector::view(reinterpret_cast<float*>(file + record.biases_offset), output_dim);
+
+    preAllocate();
+}
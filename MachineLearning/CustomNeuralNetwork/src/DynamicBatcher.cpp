@@ -0,0 +1,135 @@
+#include <CustomNeuralNetwork/DynamicBatcher.h>
+#include <CustomNeuralNetwork/NN.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+
+
+namespace {
+    // Polls of an empty queue before the scheduler sleeps: under load the next request is
+    // usually microseconds away, and a futex wake-up would cost more than that
+    constexpr size_t SPIN_LIMIT = 1 << 12;
+}
+
+// Constructor/Destructor
+DynamicBatcher::DynamicBatcher(const NN& model, BatchingOptions options) :
+    session(model),
+    options(options)
+{
+    if (options.max_batch_size == 0) {
+        throw std::invalid_argument("The maximum batch size must be at least 1");
+    }
+    batch.reserve(options.max_batch_size);
+    batch_input.resize(options.max_batch_size, model.getInputSize());
+    scheduler = std::thread(&DynamicBatcher::schedulerLoop, this);
+}
+
+DynamicBatcher::~DynamicBatcher() {
+    stopping.store(true, std::memory_order_seq_cst);
+    wake();
+    scheduler.join();
+}
+
+// Getters
+const BatchingOptions& DynamicBatcher::getOptions() const {
+    return options;
+}
+
+size_t DynamicBatcher::getBatchCount() const {
+    return batch_count.load(std::memory_order_relaxed);
+}
+
+size_t DynamicBatcher::getRequestCount() const {
+    return request_count.load(std::memory_order_relaxed);
+}
+
+double DynamicBatcher::getMeanBatchSize() const {
+    size_t batches = getBatchCount();
+    return batches ? static_cast<double>(getRequestCount()) / batches : 0.0;
+}
+
+// Methods
+std::future<Vector> DynamicBatcher::submit(Vector x) {
+    if (x.getSize() != static_cast<size_t>(session.getModel().getInputSize())) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    Request request{std::move(x), std::promise<Vector>(), std::chrono::steady_clock::now()};
+    std::future<Vector> result = request.result.get_future();
+    queue.push(std::move(request));
+    // Pairs with the fence in waitForRequests(): either the scheduler sees the request, or we see it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        wake();
+    }
+    return result;
+}
+
+void DynamicBatcher::wake() {
+    wake_signal.fetch_add(1, std::memory_order_release);
+    wake_signal.notify_one();
+}
+
+void DynamicBatcher::waitForRequests() {
+    for (size_t spin = 0; spin < SPIN_LIMIT; spin++) {
+        if (!queue.empty() || stopping.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+    }
+    uint32_t signal = wake_signal.load(std::memory_order_acquire);
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue.empty() && !stopping.load(std::memory_order_relaxed)) {
+        wake_signal.wait(signal, std::memory_order_acquire);
+    }
+    sleeping.store(false, std::memory_order_relaxed);
+}
+
+void DynamicBatcher::schedulerLoop() {
+    while (true) {
+        std::optional<Request> first = queue.pop();
+        if (!first) {
+            if (stopping.load(std::memory_order_acquire) && queue.empty()) return;
+            waitForRequests();
+            continue;
+        }
+        // The batch closes when full, or max_wait_us after its oldest request arrived
+        auto deadline = first->arrival + std::chrono::microseconds(options.max_wait_us);
+        batch.push_back(std::move(*first));
+        while (batch.size() < options.max_batch_size) {
+            if (std::optional<Request> next = queue.pop()) {
+                batch.push_back(std::move(*next));
+                continue;
+            }
+            if (stopping.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline) break;
+            std::this_thread::yield();
+        }
+        runBatch();
+    }
+}
+
+void DynamicBatcher::runBatch() {
+    TRACE_SCOPE("DynamicBatcher::runBatch");
+    size_t rows = batch.size();
+    size_t cols = session.getModel().getInputSize();
+    // Fits in the buffer reserved for max_batch_size rows: no reallocation
+    batch_input.resize(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        std::copy(batch[i].input.data(), batch[i].input.data() + cols, batch_input.data() + i*cols);
+    }
+    try {
+        const Matrix& output = session.predictBatch(batch_input);
+        size_t output_size = output.getShape().cols;
+        for (size_t i = 0; i < rows; i++) {
+            Vector result(output_size);
+            std::copy(output.getRow(i), output.getRow(i) + output_size, result.data());
+            batch[i].result.set_value(std::move(result));
+        }
+    } catch (...) {
+        for (Request& request : batch) {
+            request.result.set_exception(std::current_exception());
+        }
+    }
+    batch_count.fetch_add(1, std::memory_order_relaxed);
+    request_count.fetch_add(rows, std::memory_order_relaxed);
+    batch.clear();
+}
@@ -0,0 +1,141 @@
+#include <CustomNeuralNetwork/FrozenNN.h>
+#include <CustomNeuralNetwork/NN.h>
+#include <CustomNeuralNetwork/DenseLayer.h>
+#include <CustomNeuralNetwork/ActivationFunctions/BaseActivationFunction.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <format>
+
+
+namespace {
+    // One template instantiation per activation: the epilogue is inlined into the micro-kernel
+    template <typename Act>
+    void denseLayer(const float* x, const float* packed, const float* bias, float* y,
+                    size_t rows, size_t input_dim, size_t output_dim, Act act) {
+        linalg::kernels::gemmPackedEpilogue(x, packed, y, rows, input_dim, output_dim,
+            linalg::epilogue::ColBias<float>{bias}, act);
+    }
+}
+
+ActivationType FrozenNN::fusedActivation(const BaseActivationFunction& function) {
+    // Softmax is not fused but runs as a row-wise pass over the layer output
+    if (function.getType() == ActivationType::Custom) {
+        throw std::invalid_argument(std::format("Cannot freeze a layer with activation function: {}", function.getName()));
+    }
+    return function.getType();
+}
+
+// Constructor/Destructor
+FrozenNN::FrozenNN(const NN& model) {
+    model.validateNetwork("freeze");
+    const std::vector<DenseLayer>& layers = model.getLayers();
+    auto frozen = std::make_shared<Plan>();
+    frozen->input_size = model.getInputSize();
+    frozen->output_size = model.getOutputSize();
+
+    size_t total = 0;
+    for (const DenseLayer& layer : layers) {
+        Layer step;
+        step.input_dim = layer.getInputDim();
+        step.output_dim = layer.getOutputDim();
+        step.activation = fusedActivation(*layer.getActivationFunction());
+        step.weights_offset = total;
+        total += linalg::kernels::packedPanelsSize(step.output_dim, step.input_dim);
+        step.biases_offset = total;
+        total += step.output_dim;
+        frozen->layers.push_back(step);
+        frozen->max_width = std::max(frozen->max_width, step.output_dim);
+    }
+    frozen->parameters.resize(total);
+    for (size_t l = 0; l < layers.size(); l++) {
+        const Layer& step = frozen->layers[l];
+        linalg::kernels::packPanels(layers[l].getWeights().data(), frozen->parameters.data() + step.weights_offset,
+                                    step.output_dim, step.input_dim);
+        const Vector& b = layers[l].getBiases();
+        std::copy(b.data(), b.data() + step.output_dim, frozen->parameters.data() + step.biases_offset);
+    }
+    plan = std::move(frozen);
+    buffers[0].resize(1, plan->max_width);
+    buffers[1].resize(1, plan->max_width);
+    output.setSize(plan->output_size);
+}
+
+// Getters
+size_t FrozenNN::getInputSize() const {
+    return plan->input_size;
+}
+
+size_t FrozenNN::getOutputSize() const {
+    return plan->output_size;
+}
+
+size_t FrozenNN::getLayerCount() const {
+    return plan->layers.size();
+}
+
+size_t FrozenNN::getMemoryBytes() const {
+    size_t floats = plan->parameters.size() + buffers[0].getShape().N + buffers[1].getShape().N + output.getSize();
+    return floats * sizeof(float);
+}
+
+// Methods
+const float* FrozenNN::run(const float* x, size_t rows) {
+    // Each buffer must hold `rows` samples of the widest layer (a batch output may have shrunk one)
+    for (Matrix& buffer : buffers) {
+        if (buffer.getShape().N < rows * plan->max_width) {
+            buffer.resize(rows, plan->max_width);
+        }
+    }
+    // Layer l reads the buffer layer l-1 wrote and writes the other one
+    const float* input = x;
+    for (size_t l = 0; l < plan->layers.size(); l++) {
+        const Layer& step = plan->layers[l];
+        const float* packed = plan->parameters.data() + step.weights_offset;
+        const float* bias = plan->parameters.data() + step.biases_offset;
+        float* y = buffers[l % 2].data();
+        if (!dispatchActivation(step.activation, [&](auto act) {
+                denseLayer(input, packed, bias, y, rows, step.input_dim, step.output_dim, act);
+            })) {
+            denseLayer(input, packed, bias, y, rows, step.input_dim, step.output_dim, linalg::epilogue::Identity{});
+            linalg::kernels::softmaxRows(y, y, rows, step.output_dim);
+        }
+        input = y;
+    }
+    return input;
+}
+
+const Vector& FrozenNN::predict(const float* x) {
+    TRACE_SCOPE("FrozenNN::predict");
+    const float* y = run(x, 1);
+    std::copy(y, y + plan->output_size, output.data());
+    return output;
+}
+
+const Vector& FrozenNN::predict(const Vector& x) {
+    if (x.getSize() != plan->input_size) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    return predict(x.data());
+}
+
+const Vector& FrozenNN::predict(std::initializer_list<float> x) {
+    if (x.size() != plan->input_size) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    return predict(x.begin());
+}
+
+const Matrix& FrozenNN::predictBatch(const Matrix& x) {
+    TRACE_SCOPE("FrozenNN::predictBatch");
+    if (x.getShape().cols != plan->input_size) {
+        throw std::invalid_argument("Matrix columns must match NN input size 'n'");
+    }
+    size_t rows = x.getShape().rows;
+    run(x.data(), rows);
+    // The last layer wrote its rows contiguously at the start of its buffer: only the shape changes
+    Matrix& last = buffers[(plan->layers.size() - 1) % 2];
+    last.resize(rows, plan->output_size);
+    return last;
+}
@@ -0,0 +1,66 @@
+#include <CustomNeuralNetwork/InferenceSession.h>
+#include <CustomNeuralNetwork/NN.h>
+#include <CustomNeuralNetwork/DenseLayer.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+
+
+// Constructor/Destructor
+InferenceSession::InferenceSession(const NN& model) : model(&model) {
+    model.validateNetwork("InferenceSession");
+    const std::vector<DenseLayer>& layers = model.getLayers();
+    input_buffer.setSize(model.getInputSize());
+    activations.resize(layers.size());
+    for (size_t l = 0; l < layers.size(); l++) {
+        activations[l].setSize(layers[l].getOutputDim());
+    }
+    batch_buffers.resize(layers.size());
+}
+
+InferenceSession::~InferenceSession() = default;
+InferenceSession::InferenceSession(InferenceSession&&) noexcept = default;
+InferenceSession& InferenceSession::operator=(InferenceSession&&) noexcept = default;
+
+// Getters
+const NN& InferenceSession::getModel() const {
+    return *model;
+}
+
+// Methods
+const Vector& InferenceSession::predict(const Vector& x) {
+    TRACE_SCOPE("InferenceSession::predict");
+    if (x.getSize() != static_cast<size_t>(model->getInputSize())) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    const std::vector<DenseLayer>& layers = model->getLayers();
+    layers[0].forward(x, activations[0]);
+    for (size_t l = 1; l < layers.size(); l++) {
+        layers[l].forward(activations[l-1], activations[l]);
+    }
+    return activations.back();
+}
+
+const Vector& InferenceSession::predict(const float* x) {
+    std::copy(x, x + model->getInputSize(), input_buffer.data());
+    return predict(input_buffer);
+}
+
+const Vector& InferenceSession::predict(std::initializer_list<float> x) {
+    input_buffer = x;
+    return predict(input_buffer);
+}
+
+const Matrix& InferenceSession::predictBatch(const Matrix& x) {
+    TRACE_SCOPE("InferenceSession::predictBatch");
+    if (x.getShape().cols != static_cast<size_t>(model->getInputSize())) {
+        throw std::invalid_argument("Matrix columns must match NN input size 'n'");
+    }
+    const std::vector<DenseLayer>& layers = model->getLayers();
+    const Matrix* output = &layers[0].forwardBatch(x, batch_buffers[0], false);
+    for (size_t l = 1; l < layers.size(); l++) {
+        output = &layers[l].forwardBatch(*output, batch_buffers[l], false);
+    }
+    return *output;
+}
@@ -32,3 +32,24 @@ Vector BaseLossFunction::grad(const Vector& y_predict, const Vector& y_target) c
 Vector BaseLossFunction::operator()(const Vector& y_predict, const Vector& y_target) const {
   return call(y_predict, y_target);
 }
+
+Matrix BaseLossFunction::call(const Matrix& y_predict, const Matrix& y_target) const {
+  return linalg::transform(y_predict, y_target, [this](float p, float t) { return this->call(p, t); });
+}
+
+Matrix BaseLossFunction::grad(const Matrix& y_predict, const Matrix& y_target) const {
+  return linalg::transform(y_predict, y_target, [this](float p, float t) { return this->grad(p, t); });
+}
+
+float BaseLossFunction::value(const Matrix& y_predict, const Matrix& y_target) const {
+  return linalg::transformSum(y_predict, y_target, [this](float p, float t) { return this->call(p, t); });
+}
+
+void BaseLossFunction::gradInto(const Matrix& y_predict, const Matrix& y_target, Matrix& grad) const {
+  linalg::transformInto(y_predict, y_target, grad, [this](float p, float t) { return this->grad(p, t); });
+}
+
+float BaseLossFunction::valueAndGradInto(const Matrix& y_predict, const Matrix& y_target, Matrix& grad) const {
+  gradInto(y_predict, y_target, grad);
+  return value(y_predict, y_target);
+}
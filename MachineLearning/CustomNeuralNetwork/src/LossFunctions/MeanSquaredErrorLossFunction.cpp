@@ -23,3 +23,26 @@ Vector MeanSquaredErrorLossFunction::call(const Vector &y_predict, const Vector
 Vector MeanSquaredErrorLossFunction::grad(const Vector &y_predict, const Vector &y_target) const {
     return linalg::transform(y_predict, y_target, [](float p, float t) { return 2.0f*(p - t); });
 }
+
+Matrix MeanSquaredErrorLossFunction::call(const Matrix &y_predict, const Matrix &y_target) const {
+    return linalg::transform(y_predict, y_target, [](float p, float t) { return (t - p)*(t - p); });
+}
+
+Matrix MeanSquaredErrorLossFunction::grad(const Matrix &y_predict, const Matrix &y_target) const {
+    return linalg::transform(y_predict, y_target, [](float p, float t) { return 2.0f*(p - t); });
+}
+
+float MeanSquaredErrorLossFunction::value(const Matrix &y_predict, const Matrix &y_target) const {
+    return linalg::transformSum(y_predict, y_target, [](float p, float t) { return (t - p)*(t - p); });
+}
+
+void MeanSquaredErrorLossFunction::gradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const {
+    linalg::transformInto(y_predict, y_target, grad, [](float p, float t) { return 2.0f*(p - t); });
+}
+
+float MeanSquaredErrorLossFunction::valueAndGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const {
+    // One pass over the outputs: the residual gives both the squared error and the gradient
+    return linalg::transformSumInto(y_predict, y_target, grad,
+                                    [](float p, float t) { return 2.0f*(p - t); },
+                                    [](float p, float t) { return (t - p)*(t - p); });
+}
@@ -0,0 +1,100 @@
+#include <CustomNeuralNetwork/LossFunctions/SoftmaxCrossEntropyLossFunction.h>
+#include <LinearAlgebra/LinAlg.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+    // Samples and classes of a buffer: a column vector is a single sample, otherwise one per row
+    struct Layout {
+        size_t samples;
+        size_t classes;
+    };
+
+    Layout layoutOf(const Matrix &y_predict, const Matrix &y_target) {
+        const Shape &shape = y_predict.getShape();
+        if (shape != y_target.getShape()) {
+            throw linalg::MismatchedShapes(shape, y_target.getShape());
+        }
+        return shape.cols == 1 ? Layout{1, shape.rows} : Layout{shape.rows, shape.cols};
+    }
+
+    // Per-class terms t_j * (lse - z_j), which sum to the loss of the sample
+    void lossTermsInto(const Matrix &y_predict, const Matrix &y_target, Matrix &out) {
+        Layout layout = layoutOf(y_predict, y_target);
+        if (out.getShape() != y_predict.getShape()) {
+            out.resize(y_predict.getShape().rows, y_predict.getShape().cols);
+        }
+        for (size_t i = 0; i < layout.samples; i++) {
+            const float* z = y_predict.data() + i*layout.classes;
+            const float* t = y_target.data() + i*layout.classes;
+            float* terms = out.data() + i*layout.classes;
+            const float m = *std::max_element(z, z + layout.classes);
+            float total = 0.0f;
+            for (size_t j = 0; j < layout.classes; j++) {
+                total += std::exp(z[j] - m);
+            }
+            const float lse = m + std::log(total);
+            for (size_t j = 0; j < layout.classes; j++) {
+                terms[j] = t[j] * (lse - z[j]);
+            }
+        }
+    }
+}
+
+std::string SoftmaxCrossEntropyLossFunction::getName() const {
+    return "CROSS_ENTROPY";
+}
+
+// The loss couples every class of a sample: there is no per-element value
+float SoftmaxCrossEntropyLossFunction::call(float, float) const {
+    throw std::logic_error("Softmax cross-entropy is not element-wise: use the Vector or Matrix overloads");
+}
+
+float SoftmaxCrossEntropyLossFunction::grad(float, float) const {
+    throw std::logic_error("Softmax cross-entropy has no element-wise gradient: use the Vector or Matrix overloads");
+}
+
+Vector SoftmaxCrossEntropyLossFunction::call(const Vector &y_predict, const Vector &y_target) const {
+    Vector terms(y_predict.getSize());
+    lossTermsInto(y_predict, y_target, terms);
+    return terms;
+}
+
+Vector SoftmaxCrossEntropyLossFunction::grad(const Vector &y_predict, const Vector &y_target) const {
+    Vector result(y_predict.getSize());
+    gradInto(y_predict, y_target, result);
+    return result;
+}
+
+Matrix SoftmaxCrossEntropyLossFunction::call(const Matrix &y_predict, const Matrix &y_target) const {
+    Matrix terms;
+    lossTermsInto(y_predict, y_target, terms);
+    return terms;
+}
+
+Matrix SoftmaxCrossEntropyLossFunction::grad(const Matrix &y_predict, const Matrix &y_target) const {
+    Matrix result;
+    gradInto(y_predict, y_target, result);
+    return result;
+}
+
+float SoftmaxCrossEntropyLossFunction::value(const Matrix &y_predict, const Matrix &y_target) const {
+    Layout layout = layoutOf(y_predict, y_target);
+    return linalg::kernels::softmaxCrossEntropy(y_predict.data(), y_target.data(), static_cast<float*>(nullptr),
+                                                layout.samples, layout.classes);
+}
+
+void SoftmaxCrossEntropyLossFunction::gradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const {
+    valueAndGradInto(y_predict, y_target, grad);
+}
+
+float SoftmaxCrossEntropyLossFunction::valueAndGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const {
+    Layout layout = layoutOf(y_predict, y_target);
+    if (grad.getShape() != y_predict.getShape()) {
+        grad.resize(y_predict.getShape().rows, y_predict.getShape().cols);
+    }
+    return linalg::kernels::softmaxCrossEntropy(y_predict.data(), y_target.data(), grad.data(),
+                                                layout.samples, layout.classes);
+}
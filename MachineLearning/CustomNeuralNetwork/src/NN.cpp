@@ -4,22 +4,56 @@
 #include <CustomNeuralNetwork/InitializationFunctions/InitializationFunctions.h>
 #include <CustomNeuralNetwork/LossFunctions/LossFunctions.h>
 #include <CustomNeuralNetwork/Optimizers/Optimizers.h>
+#include <CustomNeuralNetwork/ModelFormat.h>
+#include <CustomNeuralNetwork/FrozenNN.h>
+#include <CustomNeuralNetwork/QuantizedNN.h>
+#include <CustomNeuralNetwork/DataPipeline.h>
 #include <LinearAlgebra/LinAlg.h>
+#include <Utils/trace.h>
+#include <Utils/parallel.h>
+#include <Utils/mapped_file.h>
 
 #include <iostream>
 #include <stdlib.h>
 #include <stdexcept>
 #include <fstream>
+#include <sstream>
 #include <chrono>
 #include <algorithm>
 #include <cctype>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
 
 
+namespace {
+    // A classification prediction is correct if its arg max matches the target's (one output: threshold at 0.5)
+    bool isCorrectClass(const float* y_predict, const float* y_target, size_t n) {
+        if (n > 1) {
+            return std::max_element(y_predict, y_predict + n) - y_predict == std::max_element(y_target, y_target + n) - y_target;
+        }
+        return (y_predict[0] >= 0.5f ? 1.0f : 0.0f) == y_target[0];
+    }
+
+    const char* stopReasonName(StopReason reason) {
+        switch (reason) {
+            case StopReason::PLATEAU:     return "plateau";
+            case StopReason::TARGET_LOSS: return "target loss reached";
+            case StopReason::TIME_BUDGET: return "time budget exhausted";
+            default:                      return "epochs";
+        }
+    }
+}
+
 // Constructor/Destructor
 NN::NN(int input_size, int output_size) : input_size(input_size), output_size(output_size)
 {
     input_buffer.setSize(input_size);
     target_buffer.setSize(output_size);
+    output_grad.setSize(output_size);
 }
 
 NN::NN(int input_size, int hidden_layers_num, int hidden_layers_dim, int output_size) :
@@ -27,17 +61,18 @@ NN::NN(int input_size, int hidden_layers_num, int hidden_layers_dim, int output_
     output_size(output_size),
     layers_num(hidden_layers_num+1),
     // HL(hidden_layers_dim),
-    activation(std::make_unique<BaseActivationFunction>()) 
+    activation(std::make_unique<LinearActivationFunction>()) 
 {
     input_buffer.setSize(input_size);
     target_buffer.setSize(output_size);
+    output_grad.setSize(output_size);
 
     int i = 0;
     layers.push_back(DenseLayer(input_size, hidden_layers_dim, SIGMOID, 1));
     layers[0].preAllocate();
     for(; i < hidden_layers_num - 1; ++i) {
         layers.push_back(DenseLayer(hidden_layers_dim, hidden_layers_dim, SIGMOID, i+2));
-        layers[i].preAllocate();
+        layers[i+1].preAllocate();
     }
     layers.push_back(DenseLayer(hidden_layers_dim, output_size, SIGMOID, i+2));
     layers.back().preAllocate();
@@ -98,17 +133,42 @@ NN::NN(const std::string &model_name, int input_size, int hidden_layers_num, int
 
 // Getters/Setters
 const Vector& NN::getOutput() const {
-  return y_predict;
+  // The output lives in the last layer: forward() does not copy it
+  return layers.back().getOutput();
 }
 
 const std::vector<float> &NN::getLossHistory() const {
     return loss_history;
 }
 
+const std::vector<float> &NN::getAllocationHistory() const {
+    return allocation_history;
+}
+
 std::vector<DenseLayer> &NN::getLayers() {
     return layers;
 }
 
+ParameterArena &NN::getParameterArena() {
+    return arena;
+}
+
+const ParameterArena &NN::getParameterArena() const {
+    return arena;
+}
+
+const std::vector<DenseLayer> &NN::getLayers() const {
+    return layers;
+}
+
+int NN::getInputSize() const {
+    return input_size;
+}
+
+int NN::getOutputSize() const {
+    return output_size;
+}
+
 void NN::setActivationFunction(std::unique_ptr<BaseActivationFunction> function) {
     activation = std::move(function);
 }
@@ -121,12 +181,100 @@ void NN::setLossFunction(std::unique_ptr<BaseLossFunction> function) {
     loss = std::move(function);
 }
 
+void NN::setEpochCallback(std::function<void(size_t epoch, float loss)> callback) {
+    epoch_callback = std::move(callback);
+}
+
+void NN::setThreads(size_t threads, ParallelMode mode) {
+    this->threads = threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+    parallel_mode = mode;
+}
+
+size_t NN::getThreads() const {
+    return threads;
+}
+
+void NN::setGradientAccumulation(size_t steps) {
+    if (steps == 0) {
+        throw std::invalid_argument("Gradient accumulation needs at least one step per update");
+    }
+    accumulation_steps = steps;
+}
+
+size_t NN::getGradientAccumulation() const {
+    return accumulation_steps;
+}
+
+ParallelMode NN::getParallelMode() const {
+    return parallel_mode;
+}
+
+const std::vector<AsyncEpochStats> &NN::getAsyncHistory() const {
+    return async_history;
+}
+
+void NN::setShuffle(bool enabled, uint64_t seed) {
+    shuffle = enabled;
+    shuffle_rng.seed(seed);
+    // The sequence of permutations restarts from the identity
+    epoch_order.clear();
+}
+
+bool NN::getShuffle() const {
+    return shuffle;
+}
+
+void NN::setLossReporting(LossReporting mode) {
+    loss_reporting = mode;
+}
+
+LossReporting NN::getLossReporting() const {
+    return loss_reporting;
+}
+
+void NN::setEarlyStopping(const EarlyStopping &criteria) {
+    if ((criteria.x_validation == nullptr) != (criteria.y_validation == nullptr)) {
+        throw std::invalid_argument("Early stopping needs both the validation inputs and their targets");
+    }
+    if (criteria.x_validation) {
+        // evaluate() only scores these two: any other problem type would monitor a constant metric
+        if (problem_type != "REGRESSION" && problem_type != "CLASSIFICATION") {
+            throw std::invalid_argument(std::format(
+                "Validation monitoring needs a REGRESSION or CLASSIFICATION problem type, not '{}'", problem_type));
+        }
+        const Shape &x_shape = criteria.x_validation->getShape();
+        const Shape &y_shape = criteria.y_validation->getShape();
+        if (x_shape.cols != static_cast<size_t>(input_size) || y_shape.cols != static_cast<size_t>(output_size)
+            || x_shape.rows != y_shape.rows || x_shape.rows == 0) {
+            throw std::invalid_argument(std::format(
+                "Validation set of shapes ({}, {}) and ({}, {}) does not match the NN sizes {} -> {}",
+                x_shape.rows, x_shape.cols, y_shape.rows, y_shape.cols, input_size, output_size));
+        }
+    }
+    if (criteria.min_delta < 0 || criteria.target_loss < 0 || criteria.time_budget < 0) {
+        throw std::invalid_argument("Early stopping thresholds cannot be negative");
+    }
+    early_stopping = criteria;
+}
+
+const EarlyStopping &NN::getEarlyStopping() const {
+    return early_stopping;
+}
+
+const FitSummary &NN::getFitSummary() const {
+    return fit_summary;
+}
+
 void NN::setOptimizer(std::unique_ptr<BaseOptimizer> opt, float learning_rate) {
     optimizer = std::move(opt);
     optimizer->setLearningRate(learning_rate);
     // optimizer->setParameters(w, b);
 }
 
+const BaseOptimizer* NN::getOptimizer() const {
+    return optimizer.get();
+}
+
 
 // Network Methods
 void NN::addLayer(DenseLayer &layer) {
@@ -148,44 +296,235 @@ void NN::initialize() {
     for (auto &layer : layers) {
         layer.initialize(initializer.get());
     }
+    // Fresh parameters start from fresh optimizer state
+    if (optimizer) {
+        optimizer->reset();
+    }
     initialized = true;
 }   
 
-void NN::forward(const float *input) {
-    std::copy(input, input + input_size, input_buffer.getElements().begin());
-    this->forward(input_buffer); 
+void NN::forward(const float *input, bool training) {
+    std::copy(input, input + input_size, input_buffer.data());
+    this->forward(input_buffer, training); 
 }
 
-void NN::backward(const float *target) {
-    std::copy(target, target + output_size, target_buffer.getElements().begin());
-    this->backward(target_buffer); 
+float NN::backward(const float *target) {
+    std::copy(target, target + output_size, target_buffer.data());
+    return this->backward(target_buffer); 
 }
 
-void NN::forward(const Vector &x) {
-    layers[0].forward(x);
+void NN::forward(const Vector &x, bool training) {
+    TRACE_SCOPE("NN::forward");
+    const Vector* input = &x;
+    if (training && input != &input_buffer) {
+        // The first layer reads its input again in backward(): keep it in a buffer the network owns
+        input_buffer = x;
+        input = &input_buffer;
+    }
+    const Vector* output = &layers[0].forward(*input, training);
     for (int l = 1; l<layers_num; l++) {
-        layers[l].forward(layers[l-1].getOutput());
+        output = &layers[l].forward(*output, training);
     }
-    y_predict = layers[layers_num-1].getOutput();
 }
 
-void NN::backward(const Vector &y_target) {  
+float NN::backward(const Vector &y_target) {  
+    TRACE_SCOPE("NN::backward");
     // Vector delta2 = loss->grad(y_predict, y_target) * activation->grad(layers[1].getCache());
     // optimizer->update(layers[1].getWeights(), layers[1].getBiases(), delta2, layers[1].getInput());
     // Vector delta1 = layers[1].getWeights().transposedDot(delta2) * activation->grad(layers[0].getCache());
     // optimizer->update(layers[0].getWeights(), layers[0].getBiases(), delta1, layers[0].getInput());
-    Vector grad = loss->grad(y_predict, y_target);
+    float sample_loss = lossGradInto(layers.back().getOutput(), y_target, output_grad);
+    const Vector* grad = &output_grad;
     for (int l=layers_num-1; l>=0; l--) {
-        grad = layers[l].backward(grad);
+        grad = &layers[l].backward(*grad);
         optimizer->update(
             layers[l].getWeights(), layers[l].getBiases(), 
             layers[l].getDelta(), layers[l].getInput()
         );
     }
+    return sample_loss;
+}
+
+void NN::forwardBatch(const Matrix &x_batch, bool training) {
+    TRACE_SCOPE("NN::forwardBatch");
+    const Matrix* output = &layers[0].forwardBatch(x_batch, training);
+    for (int l = 1; l<layers_num; l++) {
+        output = &layers[l].forwardBatch(*output, training);
+    }
+}
+
+float NN::backwardBatch(const Matrix &y_batch) {
+    // Mean loss over the batch: the 1/batch factor is applied once, at the top
+    float batch_loss = accumulateBatch(y_batch, 1.0f / y_batch.getShape().rows, false);
+    applyGradients();
+    return batch_loss;
+}
+
+float NN::accumulateBatch(const Matrix &y_batch, float scale, bool accumulate) {
+    TRACE_SCOPE("NN::backwardBatch");
+    float batch_loss = lossGradInto(layers.back().getBatchOutput(), y_batch, batch_grad);
+    batch_grad *= scale;
+    const Matrix* grad = &batch_grad;
+    for (int l=layers_num-1; l>=0; l--) {
+        grad = &layers[l].backwardBatch(*grad, l > 0, accumulate);
+    }
+    return batch_loss;
+}
+
+float NN::accumulateSample(const Vector &y_target, size_t row) {
+    TRACE_SCOPE("NN::accumulateSample");
+    // Same deltas as backward(), kept for the rank-k product at the end of the window instead of applied
+    float sample_loss = lossGradInto(layers.back().getOutput(), y_target, output_grad);
+    const Vector* grad = &output_grad;
+    for (int l=layers_num-1; l>=0; l--) {
+        grad = &layers[l].backward(*grad);
+        layers[l].storeSample(row, accumulation_steps);
+    }
+    return sample_loss;
+}
+
+float NN::lossGradInto(const Matrix &y_predict, const Matrix &y_target, Matrix &grad) const {
+    // The loss comes from the same pass as its gradient: no second pass over the outputs
+    if (track_loss) {
+        return loss->valueAndGradInto(y_predict, y_target, grad);
+    }
+    loss->gradInto(y_predict, y_target, grad);
+    return 0.0f;
+}
+
+void NN::applyGradients() {
+    TRACE_SCOPE("NN::applyGradients");
+    // Bound arena: every gradient is in one buffer and a single optimizer pass updates all layers.
+    // The gradients were all computed before any weight changed, so both paths compute the same step.
+    if (arena.isBound(layers)) {
+        optimizer->update(arena.getSpan());
+        return;
+    }
+    for (int l=layers_num-1; l>=0; l--) {
+        optimizer->update(
+            layers[l].getWeights(), layers[l].getBiases(),
+            layers[l].getWeightsGradient(), layers[l].getBiasesGradient()
+        );
+    }
 }
 
-void NN::fit(const Matrix &x_train, const Matrix &y_train, size_t epochs, int print_count) {
+float NN::trainBatchParallel(const Matrix &x_batch, const Matrix &y_batch, WorkerPool &pool,
+                             float scale, bool accumulate, bool step) {
+    TRACE_SCOPE("NN::trainBatchParallel");
+    size_t rows = x_batch.getShape().rows;
+    // A short (last) batch uses fewer workers: every active worker gets at least one sample
+    size_t workers = std::min(pool.size(), rows);
+
+    pool.run([&](size_t worker) {
+        if (worker < workers) {
+            auto [begin, end] = chunkRange(rows, workers, worker);
+            const Matrix x_shard = Matrix::view(const_cast<float*>(x_batch.getRow(begin)), end - begin, input_size);
+            const Matrix y_shard = Matrix::view(const_cast<float*>(y_batch.getRow(begin)), end - begin, output_size);
+            std::vector<DenseLayerBuffers>& buffers = worker_buffers[worker];
+
+            const Matrix* output = &layers[0].forwardBatch(x_shard, buffers[0]);
+            for (int l = 1; l<layers_num; l++) {
+                output = &layers[l].forwardBatch(*output, buffers[l]);
+            }
+            // Scaled by the whole batch (or accumulation window): the shard gradients then simply add up
+            worker_stats[worker].loss = lossGradInto(*output, y_shard, worker_grad[worker]);
+            worker_grad[worker] *= scale;
+            const Matrix* grad = &worker_grad[worker];
+            for (int l=layers_num-1; l>=0; l--) {
+                grad = &layers[l].backwardBatch(*grad, buffers[l], l > 0, accumulate);
+            }
+        } else if (!accumulate) {
+            // Idle on this batch, but its set still joins the reduction of the window
+            arena.zeroGradients(worker);
+        }
+        if (!step) {
+            return;
+        }
+        // Tree all-reduce into worker 0: at each round, worker w adds the gradient set of w + stride.
+        // Each pair is one pass over two contiguous arena sets, and the fixed pairing and order keep
+        // the sum deterministic for a given thread count.
+        size_t sets = accumulate ? pool.size() : workers;
+        for (size_t stride = 1; stride < sets; stride *= 2) {
+            pool.barrier();
+            if (worker % (2*stride) == 0 && worker + stride < sets) {
+                arena.accumulateGradients(worker, worker + stride);
+            }
+        }
+    });
+
+    // One optimizer step over every parameter with the reduced gradients
+    if (step) {
+        optimizer->update(arena.getSpan(0));
+    }
+    float total_loss = 0;
+    for (size_t worker = 0; worker < workers; worker++) {
+        total_loss += worker_stats[worker].loss;
+    }
+    return total_loss;
+}
+
+float NN::trainEpochHogwild(const Matrix &x_train, const Matrix &y_train, WorkerPool &pool) {
+    TRACE_SCOPE("NN::trainEpochHogwild");
+    size_t rows = x_train.getShape().rows;
+    size_t workers = std::min(pool.size(), rows);
+    bool shuffled = shuffle && epoch_order.size() == rows; // fit() drew this epoch's permutation
+    // Counts the updates of the epoch: the staleness of an update is how many updates other
+    // workers applied between reading the weights (forward) and writing the new ones
+    std::atomic<uint64_t> update_clock{0};
+    auto start = std::chrono::steady_clock::now();
+
+    pool.run([&](size_t worker) {
+        if (worker >= workers) return;
+        auto [begin, end] = chunkRange(rows, workers, worker);
+        std::vector<DenseLayerBuffers>& buffers = worker_buffers[worker];
+        WorkerStats stats;
+        for (size_t i = begin; i < end; i++) {
+            size_t row = shuffled ? epoch_order[i] : i;
+            const Matrix x_sample = Matrix::view(const_cast<float*>(x_train.getRow(row)), 1, input_size);
+            const Matrix y_sample = Matrix::view(const_cast<float*>(y_train.getRow(row)), 1, output_size);
+            uint64_t read_clock = update_clock.load(std::memory_order_relaxed);
+
+            // Other workers write the weights meanwhile: each layer reads its own (possibly stale) copy of them
+            const Matrix* output = &layers[0].forwardShared(x_sample, buffers[0]);
+            for (int l = 1; l<layers_num; l++) {
+                output = &layers[l].forwardShared(*output, buffers[l]);
+            }
+            stats.loss += lossGradInto(*output, y_sample, worker_grad[worker]);
+            const Matrix* grad = &worker_grad[worker];
+            for (int l=layers_num-1; l>=0; l--) {
+                grad = &layers[l].backwardDelta(*grad, buffers[l], l > 0);
+                optimizer->updateShared(layers[l].getWeights(), layers[l].getBiases(), buffers[l].delta, *buffers[l].x);
+            }
+
+            uint64_t staleness = update_clock.fetch_add(1, std::memory_order_relaxed) - read_clock;
+            stats.staleness += staleness;
+            stats.max_staleness = std::max(stats.max_staleness, staleness);
+        }
+        worker_stats[worker] = stats;
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    AsyncEpochStats epoch;
+    float total_loss = 0;
+    uint64_t total_staleness = 0;
+    for (size_t worker = 0; worker < workers; worker++) {
+        total_loss += worker_stats[worker].loss;
+        total_staleness += worker_stats[worker].staleness;
+        epoch.max_staleness = std::max<size_t>(epoch.max_staleness, worker_stats[worker].max_staleness);
+    }
+    epoch.updates = rows;
+    epoch.mean_staleness = rows ? static_cast<double>(total_staleness) / rows : 0.0;
+    epoch.samples_per_second = seconds > 0 ? rows / seconds : 0.0;
+    epoch.loss = !track_loss ? std::numeric_limits<float>::quiet_NaN() : rows ? total_loss / rows : 0.0f;
+    async_history.push_back(epoch);
+    return total_loss;
+}
+
+void NN::fit(const Matrix &x_train, const Matrix &y_train, size_t epochs, int print_count, size_t batch_size) {
     validateNetwork("fit");
+    if (batch_size == 0) {
+        throw std::invalid_argument("Batch size must be at least 1");
+    }
 
     // Verify if the matrix matches the NN input size
     const Shape& sample_shape = x_train.getShape();
@@ -193,31 +532,241 @@ void NN::fit(const Matrix &x_train, const Matrix &y_train, size_t epochs, int pr
         throw std::invalid_argument("Matrix columns must match NN input size 'n'");
     }   
 
+    trainEpochs(sample_shape.rows, epochs, print_count, batch_size, [&](WorkerPool *pool) {
+        float sample_loss = 0;
+        // Shuffled epochs read row epoch_order[i] instead of row i: a new permutation, no copy of the data
+        if (shuffle) {
+            shuffleEpoch(sample_shape.rows);
+        }
+        auto row = [&](size_t i) { return shuffle ? epoch_order[i] : i; };
+        if (parallel_mode == ParallelMode::HOGWILD) {
+            sample_loss = trainEpochHogwild(x_train, y_train, *pool);
+        } else if (batch_size == 1 && accumulation_steps == 1) {
+            for (size_t i = 0; i < sample_shape.rows; i++) {
+                input_ptr = x_train.getRow(row(i));
+                target_ptr = y_train.getRow(row(i));
+                forward(input_ptr);
+                sample_loss += backward(target_ptr);
+            }
+        } else if (batch_size == 1) {
+            // Per-sample forward and backward, one optimizer step per window: the step is the mean of the window
+            for (size_t start = 0; start < sample_shape.rows; start += accumulation_steps) {
+                size_t window = std::min(accumulation_steps, sample_shape.rows - start);
+                for (size_t k = 0; k < window; k++) {
+                    forward(x_train.getRow(row(start + k)));
+                    target_ptr = y_train.getRow(row(start + k));
+                    std::copy(target_ptr, target_ptr + output_size, target_buffer.data());
+                    sample_loss += accumulateSample(target_buffer, k);
+                }
+                for (DenseLayer &layer : layers) {
+                    layer.windowGradients(window, 1.0f / window);
+                }
+                applyGradients();
+            }
+        } else {
+            // Mini-batches accumulate into the same gradients and the last one of each window applies
+            // them: the step is the mean over the whole window, as for one batch of that size
+            size_t window_rows = accumulation_steps * batch_size;
+            for (size_t start = 0; start < sample_shape.rows; start += batch_size) {
+                size_t count = std::min(batch_size, sample_shape.rows - start);
+                size_t step = (start / batch_size) % accumulation_steps;
+                size_t window = std::min(window_rows, sample_shape.rows - (start - step*batch_size));
+                bool last = step + 1 == accumulation_steps || start + count == sample_shape.rows;
+                if (shuffle) {
+                    // Scattered rows: gathered into contiguous buffers sized once (shorter batches fit in them)
+                    x_gather.resize(count, input_size);
+                    y_gather.resize(count, output_size);
+                    linalg::kernels::gatherRows(x_train.data(), epoch_order.data() + start, count, input_size, x_gather.data());
+                    linalg::kernels::gatherRows(y_train.data(), epoch_order.data() + start, count, output_size, y_gather.data());
+                    sample_loss += trainMiniBatch(x_gather, y_gather, pool, 1.0f / window, step > 0, last);
+                    continue;
+                }
+                // Consecutive rows are contiguous: batches are read-only views, no copy
+                const Matrix x_batch = Matrix::view(const_cast<float*>(x_train.getRow(start)), count, input_size);
+                const Matrix y_batch = Matrix::view(const_cast<float*>(y_train.getRow(start)), count, output_size);
+                sample_loss += trainMiniBatch(x_batch, y_batch, pool, 1.0f / window, step > 0, last);
+            }
+        }
+        return sample_loss;
+    });
+}
+
+void NN::fit(DataPipeline &pipeline, size_t epochs, int print_count) {
+    validateNetwork("fit");
+    if (pipeline.getInputSize() != static_cast<size_t>(input_size) || pipeline.getOutputSize() != static_cast<size_t>(output_size)) {
+        throw std::invalid_argument(std::format("Pipeline samples ({} -> {}) do not match the NN sizes {} -> {}",
+            pipeline.getInputSize(), pipeline.getOutputSize(), input_size, output_size));
+    }
+    if (parallel_mode == ParallelMode::HOGWILD) {
+        throw std::invalid_argument("Hogwild training reads in-memory matrices: use the Matrix overload of fit()");
+    }
+
+    // Same windows as the in-memory mini-batch path; every batch is a contiguous buffer of the pipeline
+    size_t samples = pipeline.getSamples();
+    size_t batch_size = pipeline.getOptions().batch_size;
+    trainEpochs(samples, epochs, print_count, batch_size, [&](WorkerPool *pool) {
+        float sample_loss = 0;
+        size_t window_rows = accumulation_steps * batch_size;
+        for (size_t start = 0; start < samples; start += batch_size) {
+            size_t count = std::min(batch_size, samples - start);
+            size_t step = (start / batch_size) % accumulation_steps;
+            size_t window = std::min(window_rows, samples - (start - step*batch_size));
+            bool last = step + 1 == accumulation_steps || start + count == samples;
+            const PipelineBatch &batch = pipeline.next();
+            sample_loss += trainMiniBatch(batch.x, batch.y, pool, 1.0f / window, step > 0, last);
+            pipeline.release();
+        }
+        return sample_loss;
+    });
+}
+
+void NN::shuffleEpoch(size_t samples) {
+    // Each epoch shuffles the previous permutation: still uniform, and no pass to reset it
+    if (epoch_order.size() != samples) {
+        epoch_order.resize(samples);
+        std::iota(epoch_order.begin(), epoch_order.end(), size_t(0));
+    }
+    std::shuffle(epoch_order.begin(), epoch_order.end(), shuffle_rng);
+}
+
+float NN::trainMiniBatch(const Matrix &x_batch, const Matrix &y_batch, WorkerPool *pool,
+                         float scale, bool accumulate, bool step) {
+    if (pool) {
+        return trainBatchParallel(x_batch, y_batch, *pool, scale, accumulate, step);
+    }
+    forwardBatch(x_batch);
+    float batch_loss = accumulateBatch(y_batch, scale, accumulate);
+    if (step) {
+        applyGradients();
+    }
+    return batch_loss;
+}
+
+void NN::trainEpochs(size_t samples, size_t epochs, int print_count, size_t batch_size,
+                     const std::function<float(WorkerPool *pool)> &train_epoch) {
+    // Early stopping monitors the validation metric if there is one, the training loss otherwise.
+    // Classification is validated by its accuracy: scores are negated so that lower is always better
+    const EarlyStopping &stopping = early_stopping;
+    bool validating = stopping.x_validation != nullptr;
+    bool monitoring = validating || stopping.patience > 0 || stopping.target_loss > 0 || stopping.time_budget > 0;
+    bool restoring = monitoring && stopping.restore_best;
+    float direction = validating && problem_type == "CLASSIFICATION" ? -1.0f : 1.0f;
+    float best_score = std::numeric_limits<float>::infinity();
+    size_t stale_epochs = 0;
+    fit_summary = FitSummary{};
+    auto fit_start = std::chrono::steady_clock::now();
+
     float average_loss;
     size_t print_interval = (epochs <= print_count) ? 1 : (epochs / print_count);
-    loss_history.reserve(print_count+1);
+    // Reserve every logged epoch up front (and the one an early stop logs), so the history never grows inside the loop
+    size_t logged_epochs = epochs == 0 ? 0 : (epochs - 1) / print_interval + 1 + ((epochs - 1) % print_interval != 0) + monitoring;
+    loss_history.reserve(loss_history.size() + logged_epochs);
+    if constexpr (linalg::instrumentation::enabled) {
+        allocation_history.reserve(allocation_history.size() + logged_epochs);
+    }
+
+    bool hogwild = parallel_mode == ParallelMode::HOGWILD;
+    if (hogwild && batch_size != 1) {
+        throw std::invalid_argument("Hogwild training updates the weights after every sample: use a batch size of 1");
+    }
+    if (hogwild && accumulation_steps > 1) {
+        throw std::invalid_argument("Hogwild training updates the weights after every sample: it cannot accumulate gradients");
+    }
+
+    // Parallel modes: the pool and the per-worker buffers live for the whole fit
+    std::unique_ptr<WorkerPool> pool;
+    bool synchronous = !hogwild && threads > 1 && batch_size > 1;
+    // Restoring the best epoch is one copy of the arena: bound even for per-sample training
+    if (batch_size > 1 || accumulation_steps > 1 || restoring) {
+        bindParameterArena(synchronous ? threads : 1);
+    }
+    if (hogwild || synchronous) {
+        pool = std::make_unique<WorkerPool>(threads);
+        // Fresh buffers: views bound by an earlier fit may belong to another layout
+        worker_buffers.clear();
+        worker_buffers.resize(threads);
+        for (size_t worker = 0; worker < threads; worker++) {
+            worker_buffers[worker].resize(layers_num);
+            if (synchronous) {
+                arena.bindGradients(layers, worker_buffers[worker], worker);
+            }
+        }
+        worker_grad.resize(threads);
+        worker_stats.resize(threads);
+        if (hogwild) {
+            async_history.reserve(async_history.size() + epochs);
+        }
+    }
 
     // Training loop
     std::cout << "Training:" << "\n";
     for (size_t e = 0; e < epochs; e++) {
-        float sample_loss = 0;
-        for (size_t i = 0; i < sample_shape.rows; i++) {
-            input_ptr = x_train.getRow(i);
-            target_ptr = y_train.getRow(i);
-            forward(input_ptr);
-            backward(target_ptr);
-            sample_loss += (loss->call(y_predict, target_buffer)).accumulate();
-        }
-        average_loss = sample_loss / sample_shape.rows;
-        if (e % print_interval == 0 || e == epochs - 1) { 
+        TRACE_SCOPE_ID("NN::fit epoch", e);
+        linalg::instrumentation::ScopedSnapshot epoch_counters;
+        // Unreported epochs skip the loss unless a stopping criterion reads it: the passes only write its gradient
+        bool logged = e % print_interval == 0 || e == epochs - 1;
+        track_loss = logged || epoch_callback || loss_reporting == LossReporting::EVERY_EPOCH
+                     || (monitoring && !validating) || stopping.target_loss > 0;
+        float sample_loss = train_epoch(pool.get());
+        average_loss = sample_loss / samples;
+        fit_summary.epochs = e + 1;
+
+        if (monitoring) {
+            float metric = validating ? evaluate(*stopping.x_validation, *stopping.y_validation) : average_loss;
+            if (direction * metric < best_score - stopping.min_delta) {
+                best_score = direction * metric;
+                fit_summary.best_epoch = e;
+                fit_summary.best_metric = metric;
+                stale_epochs = 0;
+                // One copy of the contiguous arena, into a buffer reused across improvements
+                if (restoring) {
+                    arena.snapshot(best_parameters);
+                }
+            } else {
+                stale_epochs++;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - fit_start).count();
+            if (stopping.target_loss > 0 && average_loss <= stopping.target_loss) {
+                fit_summary.reason = StopReason::TARGET_LOSS;
+            } else if (stopping.patience > 0 && stale_epochs >= stopping.patience) {
+                fit_summary.reason = StopReason::PLATEAU;
+            } else if (stopping.time_budget > 0 && elapsed >= stopping.time_budget) {
+                fit_summary.reason = StopReason::TIME_BUDGET;
+            }
+        }
+        bool stop = fit_summary.reason != StopReason::EPOCHS;
+
+        if (logged || (stop && track_loss)) { 
             loss_history.push_back(average_loss);
             std::cout << "Epoch: " << (e + 1) << "/" << epochs 
-                      << " | Loss: " << average_loss << "\n";
+                      << " | Loss: " << average_loss;
+            if constexpr (linalg::instrumentation::enabled) {
+                float allocations = epoch_counters.delta().allocationsPer(samples);
+                allocation_history.push_back(allocations);
+                std::cout << " | Allocations/sample: " << allocations;
+            }
+            std::cout << "\n";
+        }
+        if (epoch_callback) {
+            epoch_callback(e, average_loss);
+        }
+        if (stop) {
+            std::cout << std::format("Early stopping at epoch {}/{} ({})\n", e + 1, epochs, stopReasonName(fit_summary.reason));
+            break;
         }
     }       
+    track_loss = true;
+
+    if (restoring && fit_summary.epochs > 0 && fit_summary.best_epoch + 1 != fit_summary.epochs) {
+        arena.restore(best_parameters);
+        fit_summary.restored = true;
+        std::cout << std::format("Restored the parameters of epoch {} (best metric: {})\n",
+                                 fit_summary.best_epoch + 1, fit_summary.best_metric);
+    }
 }
 
 float NN::evaluate(const Matrix &x_test, const Matrix &y_test) { 
+    TRACE_SCOPE("NN::evaluate");
     validateNetwork("evaluate");
 
     size_t N = x_test.getShape().rows;
@@ -226,28 +775,38 @@ float NN::evaluate(const Matrix &x_test, const Matrix &y_test) {
         for (size_t i = 0; i < N; i++) {
             input_ptr = x_test.getRow(i);
             target_ptr = y_test.getRow(i);
-            forward(input_ptr);
-            std::copy(target_ptr, target_ptr + output_size, target_buffer.getElements().begin());
-            total_loss += (loss->call(y_predict, target_buffer)).accumulate();
+            forward(input_ptr, false);
+            std::copy(target_ptr, target_ptr + output_size, target_buffer.data());
+            total_loss += loss->value(layers.back().getOutput(), target_buffer);
         }
         return total_loss/N;
     }
     else if (problem_type == "CLASSIFICATION") {
+        float correct = 0;
         for (size_t i = 0; i < N; i++) {
             input_ptr = x_test.getRow(i);
-            target_ptr = y_test.getRow(i);
-            forward(input_ptr);
-            std::copy(target_ptr, target_ptr + output_size, target_buffer.getElements().begin());
-            if (output_size > 1) {
-                if (linalg::argmax(y_predict) == linalg::argmax(target_buffer)) {
-                    accuracy+=1;
-                }
-            } else if ((y_predict[0] >= 0.5f ? 1.0f : 0.0f) == target_buffer[0]) {
-                accuracy+=1;
-            }
-    
+            forward(input_ptr, false);
+            correct += isCorrectClass(layers.back().getOutput().data(), y_test.getRow(i), output_size);
+        }
+        return correct/N;
+    }
+    return 0.0f;
+}
+
+float NN::score(const Matrix &y_predict, const Matrix &y_test) const {
+    if (y_predict.getShape() != y_test.getShape() || y_test.getShape().cols != static_cast<size_t>(output_size)) {
+        throw std::invalid_argument("Predictions and targets must both have one row of NN output size per sample");
+    }
+    size_t N = y_test.getShape().rows;
+    if (problem_type == "REGRESSION") {
+        return loss->value(y_predict, y_test)/N;
+    }
+    else if (problem_type == "CLASSIFICATION") {
+        float correct = 0;
+        for (size_t i = 0; i < N; i++) {
+            correct += isCorrectClass(y_predict.getRow(i), y_test.getRow(i), output_size);
         }
-        return accuracy/N;
+        return correct/N;
     }
     return 0.0f;
 }
@@ -257,8 +816,8 @@ Vector& NN::predict(Vector &x) {
     if (x.getSize() != input_size) {
         throw std::invalid_argument("Input size does not match NN dimension!");
     }
-    forward(x);
-    return y_predict;
+    forward(x, false);
+    return layers.back().getOutput();
 }
 
 Vector& NN::predict(const std::initializer_list<float> &x) { // For tests only
@@ -266,6 +825,18 @@ Vector& NN::predict(const std::initializer_list<float> &x) { // For tests only
     return this->predict(input_buffer);
 }
 
+FrozenNN NN::freeze() const {
+    return FrozenNN(*this);
+}
+
+QuantizedNN NN::quantize(const Matrix &calibration) const {
+    return QuantizedNN(*this, calibration);
+}
+
+QuantizedNN NN::quantize(const Matrix &calibration, const QuantizationOptions &options) const {
+    return QuantizedNN(*this, calibration, options);
+}
+
 // Other methods
 void NN::validateNetwork(const std::string &caller) const {
     if (layers.empty()) {
@@ -296,6 +867,22 @@ void NN::validateNetwork(const std::string &caller) const {
             std::format("Optimizer function has not been set yet! Use setOptimizer() before calling {}().", caller)
         );
     }
+    // Softmax works across the outputs of a sample: it needs several, and CROSS_ENTROPY already applies it
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (layers[i].getActivationFunction()->getType() == ActivationType::Softmax && layers[i].getOutputDim() < 2) {
+            throw std::invalid_argument(std::format("Layer {} applies softmax to a single output", i));
+        }
+    }
+    if (loss->getName() == "CROSS_ENTROPY") {
+        if (output_size < 2) {
+            throw std::invalid_argument("CROSS_ENTROPY needs at least two output classes");
+        }
+        if (layers.back().getActivationFunction()->getType() != ActivationType::Identity) {
+            throw std::invalid_argument(std::format(
+                "CROSS_ENTROPY applies the softmax to the logits itself: the output layer must be LINEAR, not {}",
+                layers.back().getActivationFunction()->getName()));
+        }
+    }
 }
 
 void NN::print() const {
@@ -325,23 +912,36 @@ void NN::print() const {
 
 void NN::save() {
     auto now = std::chrono::system_clock::now();
-    std::string file_name = std::format("Model_{}_{:%Y%m%d_%H%M}.txt", this->model_name, now);
+    std::string file_name = std::format("Model_{}_{:%Y%m%d_%H%M}.cnn", this->model_name, now);
     this->save(file_name);
 }
 
 void NN::save(const std::string &file_name) {
+    if (file_name.ends_with(".txt")) {
+        saveText(file_name);
+    } else {
+        saveBinary(file_name);
+    }
+}
+
+void NN::saveText(const std::string &file_name) {
     validateNetwork("save");
     std::ofstream file(file_name);
     if (!file.is_open()) {
         std::cerr << "Error: Could not open file for saving!" << std::endl;
     } else {
         file << std::format("MODEL {}\n", this->model_name);
-        file << std::format("PROBLEM {}\n", this->model_name, this->problem_type);
+        // Models built without a problem type still need a token, or the reader shifts every field after it
+        file << std::format("PROBLEM {}\n", this->problem_type.empty() ? "NONE" : this->problem_type);
         file << std::format("I/O DIM {} {}\n", this->input_size, this->output_size);
         file << std::format("LAYER COUNT {}\n", this->layers_num);
         file << std::format("INITIALIZER {}\n", initializer->getName());
         file << std::format("LOSS {}\n", loss->getName());
-        file << std::format("OPTIMIZER {} {}\n", optimizer->getName(), optimizer->getLearningRate());
+        file << std::format("OPTIMIZER {} {}", optimizer->getName(), optimizer->getLearningRate());
+        for (float value : optimizer->getHyperparameters()) {
+            file << std::format(" {}", value);
+        }
+        file << "\n";
         file << "------\n";
         for (auto& layer : layers) {
             layer.save(file);
@@ -351,6 +951,91 @@ void NN::save(const std::string &file_name) {
     }
 }
 
+void NN::saveBinary(const std::string &file_name) {
+    validateNetwork("save");
+    std::ofstream file(file_name, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Could not open file for saving: {}", file_name));
+    }
+
+    // Names go to the string table, referenced by offset and length
+    std::string strings;
+    auto addString = [&strings](const std::string &text) {
+        ModelFileString reference{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size())};
+        strings += text;
+        return reference;
+    };
+    ModelFileHeader header{};
+    std::memcpy(header.magic, MODEL_FILE_MAGIC, sizeof(header.magic));
+    header.version = MODEL_FILE_VERSION;
+    header.header_size = sizeof(ModelFileHeader);
+    header.input_size = input_size;
+    header.output_size = output_size;
+    header.layer_count = layers_num;
+    header.learning_rate = optimizer->getLearningRate();
+    std::vector<float> hyperparameters = optimizer->getHyperparameters();
+    if (hyperparameters.size() > std::size(header.optimizer_hyperparameters)) {
+        throw std::runtime_error(std::format("The {} optimizer has more hyperparameters than the model file stores", optimizer->getName()));
+    }
+    std::copy(hyperparameters.begin(), hyperparameters.end(), header.optimizer_hyperparameters);
+    header.model_name = addString(model_name);
+    header.problem_type = addString(problem_type);
+    header.initializer = addString(initializer->getName());
+    header.loss = addString(loss->getName());
+    header.optimizer = addString(optimizer->getName());
+
+    // Layout: the layer table, the string table, then one aligned blob per weights/biases array
+    std::vector<ModelFileLayer> table(layers_num);
+    for (int l = 0; l < layers_num; l++) {
+        table[l] = ModelFileLayer{};
+        table[l].layer_id = l + 1;
+        table[l].input_dim = layers[l].getInputDim();
+        table[l].output_dim = layers[l].getOutputDim();
+        table[l].activation = addString(layers[l].getActivationFunction()->getName());
+    }
+    header.layer_table_offset = sizeof(ModelFileHeader);
+    header.string_table_offset = header.layer_table_offset + table.size() * sizeof(ModelFileLayer);
+    header.string_table_size = strings.size();
+    uint64_t offset = header.string_table_offset + strings.size();
+    for (int l = 0; l < layers_num; l++) {
+        table[l].weights_offset = alignModelOffset(offset);
+        offset = table[l].weights_offset + layers[l].getWeights().getShape().N * sizeof(float);
+        table[l].biases_offset = alignModelOffset(offset);
+        offset = table[l].biases_offset + layers[l].getBiases().getSize() * sizeof(float);
+    }
+    header.file_size = offset;
+
+    // The header (with a zero checksum field) and everything after it are checksummed while the
+    // payload is written; the header itself goes last, once the digest is known
+    ModelChecksum checksum;
+    checksum.update(&header, sizeof(header));
+    uint64_t position = sizeof(ModelFileHeader);
+    const char padding[MODEL_FILE_ALIGNMENT] = {};
+    auto write = [&](const void *data, uint64_t bytes) {
+        checksum.update(data, bytes);
+        file.write(static_cast<const char*>(data), bytes);
+        position += bytes;
+    };
+    auto writeAligned = [&](uint64_t target, const float *data, uint64_t count) {
+        write(padding, target - position);
+        write(data, count * sizeof(float));
+    };
+    file.seekp(sizeof(ModelFileHeader));
+    write(table.data(), table.size() * sizeof(ModelFileLayer));
+    write(strings.data(), strings.size());
+    for (int l = 0; l < layers_num; l++) {
+        writeAligned(table[l].weights_offset, layers[l].getWeights().data(), layers[l].getWeights().getShape().N);
+        writeAligned(table[l].biases_offset, layers[l].getBiases().data(), layers[l].getBiases().getSize());
+    }
+    header.checksum = checksum.digest();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file) {
+        throw std::runtime_error(std::format("Could not write file: {}", file_name));
+    }
+    std::cout << "Model saved to: " << file_name << std::endl;
+}
+
 
 inline void NN::auxiliaryInitializerGenerator(std::string &buffer) {
     // Handle activation (MAY BE MOVED TO ITS OWN GENERATOR CLASS)
@@ -362,21 +1047,45 @@ inline void NN::auxiliaryInitializerGenerator(std::string &buffer) {
 inline void NN::auxiliaryLossGenerator(std::string &buffer) {
     // Handle activation (MAY BE MOVED TO ITS OWN GENERATOR CLASS)
     if (buffer == "MSE") setLossFunction(MSE);
+    else if (buffer == "CROSS_ENTROPY") setLossFunction(CROSS_ENTROPY);
 }
 
 inline void NN::auxiliaryOptimizerGenerator(std::string &buffer, float lr) {
     // Handle activation (MAY BE MOVED TO ITS OWN GENERATOR CLASS)
     if (buffer == "SGD") setOptimizer(SGD, lr);
-    // else if (buffer == "ADAM") setOptimizer(ADAM);
+    else if (buffer == "ADAM") setOptimizer(ADAM, lr);
+    else if (buffer == "ADAMW") setOptimizer(ADAMW, lr);
 }
 
 inline void NN::auxiliaryPreAllocatorFunction() {
     input_buffer.setSize(input_size);
     target_buffer.setSize(output_size);
-    y_predict.setSize(output_size);
+    output_grad.setSize(output_size);
+}
+
+void NN::bindParameterArena(size_t gradient_sets) {
+    // Rebinding copies every parameter: only done when the layers or the worker count changed
+    if (!arena.isBound(layers, gradient_sets)) {
+        arena.bind(layers, gradient_sets);
+        // The parameters moved: state keyed by their old buffers must not outlive them
+        optimizer->reset();
+    }
 }
 
-void NN::load(const std::string &file_name) {
+void NN::load(const std::string &file_name, bool verify_checksum) {
+    // Binary files start with the magic bytes; anything else is parsed as text
+    char magic[sizeof(MODEL_FILE_MAGIC)] = {};
+    std::ifstream file(file_name, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    file.close();
+    if (std::memcmp(magic, MODEL_FILE_MAGIC, sizeof(magic)) == 0) {
+        loadBinary(file_name, verify_checksum);
+    } else {
+        loadText(file_name);
+    }
+}
+
+void NN::loadText(const std::string &file_name) {
     std::ifstream file(file_name);
     if (!file.is_open()) {
         throw std::runtime_error(std::format("Could not load file: {}", file_name));
@@ -388,6 +1097,7 @@ void NN::load(const std::string &file_name) {
     // Summary
     file >> buffer >> model_name; // MODEL {NAME}
     file >> buffer >> problem_type; // PROBLEM {TYPE}
+    if (problem_type == "NONE") problem_type.clear();
     file >> buffer >> buffer >> input_size >> output_size; // I/O DIM {} {}
     file >> buffer >> buffer >> layers_num; // LAYER COUNT {NUMBER}
     auxiliaryPreAllocatorFunction();
@@ -403,12 +1113,23 @@ void NN::load(const std::string &file_name) {
     
     // Optimizer
     float lr;
-    file >> buffer >> buffer >> lr; // OPTIMIZER {OPTIMIZER} {LR}
+    file >> buffer >> buffer >> lr; // OPTIMIZER {OPTIMIZER} {LR} {HYPERPARAMETERS...}
     auxiliaryOptimizerGenerator(buffer, lr);
+    // The rest of the line: absent for SGD and in files written before they were saved
+    std::getline(file, buffer);
+    std::istringstream hyperparameter_stream(buffer);
+    std::vector<float> hyperparameters;
+    for (float value; hyperparameter_stream >> value;) {
+        hyperparameters.push_back(value);
+    }
+    if (optimizer && !hyperparameters.empty()) {
+        optimizer->setHyperparameters(hyperparameters);
+    }
     
     // Layers
     file >> buffer; // Separator '-----'
     layers.clear();
+    mapped_file.reset();
     for (int i = 0; i < layers_num; i++) {
         DenseLayer layer;
         layer.load(file);
@@ -416,4 +1137,109 @@ void NN::load(const std::string &file_name) {
         file >> buffer; // Separator '-----'
     }
     std::cout << "Model loaded: " << model_name << "\n";
-}
\ No newline at end of file
+}
+
+void NN::loadBinary(const std::string &file_name, bool verify_checksum) {
+    TRACE_SCOPE("NN::loadBinary");
+    auto file = std::make_shared<MappedFile>(file_name);
+    std::byte* data = file->data();
+    uint64_t size = file->size();
+
+    // Header
+    ModelFileHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error(std::format("Truncated model file: {}", file_name));
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MODEL_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(std::format("Not a binary model file: {}", file_name));
+    }
+    if (header.version < MODEL_FILE_MIN_VERSION || header.version > MODEL_FILE_VERSION) {
+        throw std::runtime_error(std::format(
+            "Unsupported model file version {} in {} (expected {} to {})",
+            header.version, file_name, MODEL_FILE_MIN_VERSION, MODEL_FILE_VERSION));
+    }
+    if (header.header_size < sizeof(header) || header.header_size > size || header.file_size != size) {
+        throw std::runtime_error(std::format("Truncated or corrupted model file: {}", file_name));
+    }
+    // Touches every page once; skipping it makes loading independent of the model size
+    if (verify_checksum) {
+        // Version 1 only covered the payload; later versions hash the header with its checksum zeroed first
+        ModelChecksum checksum;
+        if (header.version >= 2) {
+            ModelFileHeader hashed = header;
+            hashed.checksum = 0;
+            checksum.update(&hashed, sizeof(hashed));
+            checksum.update(data + sizeof(hashed), header.header_size - sizeof(hashed));
+        }
+        checksum.update(data + header.header_size, size - header.header_size);
+        if (checksum.digest() != header.checksum) {
+            throw std::runtime_error(std::format("Checksum mismatch, corrupted model file: {}", file_name));
+        }
+    }
+
+    // Every offset is checked against the file before it is used
+    auto inside = [size](uint64_t offset, uint64_t bytes) {
+        return offset <= size && bytes <= size - offset;
+    };
+    if (!inside(header.layer_table_offset, uint64_t(header.layer_count) * sizeof(ModelFileLayer))
+        || !inside(header.string_table_offset, header.string_table_size)) {
+        throw std::runtime_error(std::format("Corrupted model file tables: {}", file_name));
+    }
+    auto readString = [&](ModelFileString reference) {
+        if (uint64_t(reference.offset) + reference.length > header.string_table_size) {
+            throw std::runtime_error(std::format("Corrupted model file string table: {}", file_name));
+        }
+        return std::string(reinterpret_cast<const char*>(data + header.string_table_offset + reference.offset), reference.length);
+    };
+
+    // Summary
+    layers.clear();
+    model_name = readString(header.model_name);
+    problem_type = readString(header.problem_type);
+    input_size = header.input_size;
+    output_size = header.output_size;
+    layers_num = header.layer_count;
+    auxiliaryPreAllocatorFunction();
+
+    std::string buffer = readString(header.initializer);
+    auxiliaryInitializerGenerator(buffer);
+    this->initialized = true;
+    buffer = readString(header.loss);
+    auxiliaryLossGenerator(buffer);
+    buffer = readString(header.optimizer);
+    auxiliaryOptimizerGenerator(buffer, header.learning_rate);
+    // Version 1 files did not store them: the optimizer keeps the defaults of its name
+    size_t hyperparameter_count = optimizer ? optimizer->getHyperparameters().size() : 0;
+    if (header.version >= 2 && hyperparameter_count > 0) {
+        optimizer->setHyperparameters(std::vector<float>(
+            header.optimizer_hyperparameters, header.optimizer_hyperparameters + hyperparameter_count));
+    }
+
+    // Layers
+    layers.reserve(layers_num);
+    int previous_dim = input_size;
+    for (int i = 0; i < layers_num; i++) {
+        ModelFileLayer record;
+        std::memcpy(&record, data + header.layer_table_offset + i * sizeof(ModelFileLayer), sizeof(record));
+        if (record.input_dim != previous_dim || record.output_dim <= 0) {
+            throw std::runtime_error(std::format("Layer {} dimensions do not chain in: {}", i + 1, file_name));
+        }
+        uint64_t weights_bytes = uint64_t(record.input_dim) * record.output_dim * sizeof(float);
+        uint64_t biases_bytes = uint64_t(record.output_dim) * sizeof(float);
+        if (record.weights_offset % MODEL_FILE_ALIGNMENT != 0 || record.biases_offset % MODEL_FILE_ALIGNMENT != 0
+            || !inside(record.weights_offset, weights_bytes) || !inside(record.biases_offset, biases_bytes)) {
+            throw std::runtime_error(std::format("Layer {} parameters out of bounds in: {}", i + 1, file_name));
+        }
+        DenseLayer layer;
+        layer.load(record, data, readString(record.activation));
+        layers.push_back(std::move(layer));
+        previous_dim = record.output_dim;
+    }
+    if (previous_dim != output_size) {
+        throw std::runtime_error(std::format("Output layer does not match the model output size in: {}", file_name));
+    }
+    // Released last: the previous model's layers (and their views) are already gone
+    mapped_file = std::move(file);
+    std::cout << "Model loaded: " << model_name << "\n";
+}
@@ -1,27 +1,158 @@
 #include <CustomNeuralNetwork/Optimizers/AdaptativeMomentOptimizer.h>
+#include <Utils/trace.h>
+#include <cmath>
+#include <stdexcept>
+#include <format>
 
 
-AdaptativeMomentOptimizer::AdaptativeMomentOptimizer(float lr, float b1, float b2, float eps) : 
-    learning_rate(lr), 
-    beta1(b1), 
-    beta2(b2), 
-    epsilon(eps), 
-    t(0) 
+namespace {
+    // Per-update constants: the bias corrections are folded into the step size and epsilon,
+    // so the element loop is p -= step * m / (sqrt(v) + eps_hat), without a division by (1 - beta^t)
+    struct AdamStep {
+        float beta1, beta2;
+        float step;
+        float eps_hat;
+        float decay;    // 1 - lr * weight_decay for weights, 1 for biases
+    };
+
+    AdamStep makeStep(float lr, float beta1, float beta2, float epsilon, size_t t) {
+        const float correction1 = 1.0f - std::pow(beta1, static_cast<float>(t));
+        const float correction2 = std::sqrt(1.0f - std::pow(beta2, static_cast<float>(t)));
+        return {beta1, beta2, lr * correction2 / correction1, epsilon * correction2, 1.0f};
+    }
+
+    // One fused pass over a tensor: grad(i) yields the gradient of p[i] (stored or computed on the fly)
+    template <typename Grad>
+    void adamUpdate(float* p, float* m, float* v, size_t n, const AdamStep& s, Grad grad) {
+        for (size_t i = 0; i < n; i++) {
+            const float g = grad(i);
+            m[i] = s.beta1 * m[i] + (1.0f - s.beta1) * g;
+            v[i] = s.beta2 * v[i] + (1.0f - s.beta2) * g * g;
+            p[i] = s.decay * p[i] - s.step * m[i] / (std::sqrt(v[i]) + s.eps_hat);
+        }
+    }
+}
+
+AdaptativeMomentOptimizer::AdaptativeMomentOptimizer(float lr, float b1, float b2, float eps, float weight_decay) :
+    BaseOptimizer(lr),
+    beta1(b1),
+    beta2(b2),
+    epsilon(eps),
+    weight_decay(weight_decay)
 {
 }
 
 std::string AdaptativeMomentOptimizer::getName() const {
-    return "ADAM";
-}
-
-// void AdaptativeMomentOptimizer::update(float& weight, float gradient) {
-//     // Increase time step once per weight update cycle 
-//     // (Note: technically t should increase once per full backward pass)
-//     t++; 
-//     float* ptr = &weight;
-//     m[ptr] = beta1 * m[ptr] + (1.0f - beta1) * gradient;
-//     v[ptr] = beta2 * v[ptr] + (1.0f - beta2) * (gradient * gradient);
-//     float m_hat = m[ptr] / (1.0f - std::pow(beta1, t));
-//     float v_hat = v[ptr] / (1.0f - std::pow(beta2, t));
-//     weight -= learning_rate * m_hat / (std::sqrt(v_hat) + epsilon);
-// }
\ No newline at end of file
+    return weight_decay > 0.0f ? "ADAMW" : "ADAM";
+}
+
+float AdaptativeMomentOptimizer::getWeightDecay() const {
+    return weight_decay;
+}
+
+std::vector<float> AdaptativeMomentOptimizer::getHyperparameters() const {
+    return {beta1, beta2, epsilon, weight_decay};
+}
+
+void AdaptativeMomentOptimizer::setHyperparameters(const std::vector<float>& values) {
+    if (values.size() != 4) {
+        throw std::invalid_argument(std::format(
+            "{} takes 4 hyperparameters (beta1, beta2, epsilon, weight_decay), got {}", getName(), values.size()));
+    }
+    beta1 = values[0];
+    beta2 = values[1];
+    epsilon = values[2];
+    weight_decay = values[3];
+    reset();
+}
+
+void AdaptativeMomentOptimizer::reset() {
+    moments.clear();
+    flat = Moments();
+}
+
+AdaptativeMomentOptimizer::Moments& AdaptativeMomentOptimizer::momentsFor(const Matrix& w, const Vector& b) {
+    for (Moments& state : moments) {
+        if (state.parameters == w.data() && state.m_w.getShape() == w.getShape() && state.m_b.getSize() == b.getSize()) {
+            return state;
+        }
+    }
+    // First update of this layer: zero moments (Matrix and Vector value-initialize their elements)
+    Moments& state = moments.emplace_back();
+    state.parameters = w.data();
+    state.m_w.resize(w.getShape().rows, w.getShape().cols);
+    state.v_w.resize(w.getShape().rows, w.getShape().cols);
+    state.m_b.setSize(b.getSize());
+    state.v_b.setSize(b.getSize());
+    return state;
+}
+
+void AdaptativeMomentOptimizer::update(Matrix& w, Vector& b, float grad, const float* input, int signal_size) {
+    TRACE_SCOPE("ADAM::update");
+    // Single neuron: the gradient of w[i] is grad * input[i], and b[0] gets grad
+    Moments& state = momentsFor(w, b);
+    state.t++;
+    AdamStep s = makeStep(learning_rate, beta1, beta2, epsilon, state.t);
+    AdamStep bias_step = s;
+    s.decay = 1.0f - learning_rate * weight_decay;
+    adamUpdate(w.data(), state.m_w.data(), state.v_w.data(), signal_size, s,
+               [&](size_t i) { return grad * input[i]; });
+    adamUpdate(b.data(), state.m_b.data(), state.v_b.data(), 1, bias_step,
+               [&](size_t) { return grad; });
+}
+
+void AdaptativeMomentOptimizer::update(Matrix& w, Vector& b, const Vector& delta, const Vector& input) {
+    TRACE_SCOPE("ADAM::update");
+    // Per-sample gradients: grad_w = delta * input^T is never stored, each row is formed in the pass
+    Moments& state = momentsFor(w, b);
+    state.t++;
+    AdamStep s = makeStep(learning_rate, beta1, beta2, epsilon, state.t);
+    AdamStep bias_step = s;
+    s.decay = 1.0f - learning_rate * weight_decay;
+    const size_t rows = w.getShape().rows;
+    const size_t cols = w.getShape().cols;
+    const float* x = input.data();
+    for (size_t i = 0; i < rows; i++) {
+        const float d = delta[i];
+        adamUpdate(w.data() + i*cols, state.m_w.data() + i*cols, state.v_w.data() + i*cols, cols, s,
+                   [&](size_t j) { return d * x[j]; });
+    }
+    adamUpdate(b.data(), state.m_b.data(), state.v_b.data(), rows, bias_step,
+               [&](size_t i) { return delta[i]; });
+}
+
+void AdaptativeMomentOptimizer::update(Matrix& w, Vector& b, const Matrix& grad_w, const Vector& grad_b) {
+    TRACE_SCOPE("ADAM::update");
+    Moments& state = momentsFor(w, b);
+    state.t++;
+    AdamStep s = makeStep(learning_rate, beta1, beta2, epsilon, state.t);
+    AdamStep bias_step = s;
+    s.decay = 1.0f - learning_rate * weight_decay;
+    const float* g_w = grad_w.data();
+    const float* g_b = grad_b.data();
+    adamUpdate(w.data(), state.m_w.data(), state.v_w.data(), w.getShape().N, s,
+               [&](size_t i) { return g_w[i]; });
+    adamUpdate(b.data(), state.m_b.data(), state.v_b.data(), b.getSize(), bias_step,
+               [&](size_t i) { return g_b[i]; });
+}
+
+void AdaptativeMomentOptimizer::update(const ParameterSpan& span) {
+    TRACE_SCOPE("ADAM::update");
+    // A new (or re-laid out) arena starts from zero moments
+    if (flat.parameters != span.parameters || flat.m_w.getShape().N != span.size) {
+        flat = Moments();
+        flat.parameters = span.parameters;
+        flat.m_w.resize(span.size, 1);
+        flat.v_w.resize(span.size, 1);
+    }
+    flat.t++;
+    AdamStep s = makeStep(learning_rate, beta1, beta2, epsilon, flat.t);
+    AdamStep bias_step = s;
+    s.decay = 1.0f - learning_rate * weight_decay;
+    const float* g = span.gradients;
+    const size_t w = span.weight_count;
+    adamUpdate(span.parameters, flat.m_w.data(), flat.v_w.data(), w, s,
+               [&](size_t i) { return g[i]; });
+    adamUpdate(span.parameters + w, flat.m_w.data() + w, flat.v_w.data() + w, span.size - w, bias_step,
+               [&](size_t i) { return g[w + i]; });
+}
@@ -1,4 +1,6 @@
 #include <CustomNeuralNetwork/Optimizers/BaseOptimizer.h>
+#include <stdexcept>
+#include <format>
 
 
 BaseOptimizer::BaseOptimizer(float lr) : learning_rate(lr) {
@@ -16,6 +18,23 @@ float BaseOptimizer::getLearningRate() const {
     return learning_rate;
 }
 
+std::vector<float> BaseOptimizer::getHyperparameters() const {
+    return {};
+}
+
+void BaseOptimizer::setHyperparameters(const std::vector<float>& values) {
+    if (!values.empty()) {
+        throw std::invalid_argument(std::format("The {} optimizer has no hyperparameters besides the learning rate", getName()));
+    }
+}
+
+void BaseOptimizer::reset() {
+}
+
+void BaseOptimizer::updateShared(Matrix&, Vector&, const Matrix&, const Matrix&) {
+    throw std::runtime_error(std::format("The {} optimizer does not support asynchronous (Hogwild) updates", getName()));
+}
+
 // void BaseOptimizer::setParameters(Matrix& weights, Vector& biases) {
 //   for (size_t i = 0; i < input_size; i++) {
 //         optimizer->addParameter(w[i]);
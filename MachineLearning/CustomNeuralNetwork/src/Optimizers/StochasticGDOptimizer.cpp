@@ -1,5 +1,7 @@
 #include <CustomNeuralNetwork/Optimizers/StochasticGDOptimizer.h>
 #include <LinearAlgebra/LinAlg.h>
+#include <Utils/trace.h>
+#include <atomic>
 
 
 StochasticGDOptimizer::StochasticGDOptimizer(float lr) : BaseOptimizer(lr) {
@@ -10,6 +12,7 @@ std::string StochasticGDOptimizer::getName() const {
 }
 
 void StochasticGDOptimizer::update(Matrix& w, Vector& b, float grad, const float* input, int signal_size) {
+    TRACE_SCOPE("SGD::update");
     for (size_t i = 0; i < signal_size; i++) {
         w[i] -= learning_rate * grad * input[i];
     }
@@ -19,6 +22,7 @@ void StochasticGDOptimizer::update(Matrix& w, Vector& b, float grad, const float
 void StochasticGDOptimizer::update(Matrix &w, Vector &b,
                                    const Vector &delta,
                                    const Vector &input) {
+    TRACE_SCOPE("SGD::update");
     Shape S = w.getShape();
     for (size_t i = 0; i < S.rows; i++) {
         float cache = learning_rate * delta[i];
@@ -27,4 +31,53 @@ void StochasticGDOptimizer::update(Matrix &w, Vector &b,
         }
         b[i] -= cache;        
     }
-}
\ No newline at end of file
+}
+
+void StochasticGDOptimizer::update(Matrix &w, Vector &b,
+                                   const Matrix &grad_w,
+                                   const Vector &grad_b) {
+    TRACE_SCOPE("SGD::update");
+    float* w_ptr = w.data();
+    const float* grad_w_ptr = grad_w.data();
+    const size_t N = w.getShape().N;
+    for (size_t i = 0; i < N; i++) {
+        w_ptr[i] -= learning_rate * grad_w_ptr[i];
+    }
+    for (size_t i = 0; i < b.getSize(); i++) {
+        b[i] -= learning_rate * grad_b[i];
+    }
+}
+
+void StochasticGDOptimizer::update(const ParameterSpan &span) {
+    TRACE_SCOPE("SGD::update");
+    const float lr = learning_rate;
+    linalg::kernels::zip(span.parameters, span.gradients, span.parameters, span.size,
+                         [lr](float p, float g) { return p - lr * g; });
+}
+
+void StochasticGDOptimizer::updateShared(Matrix &w, Vector &b,
+                                         const Matrix &delta,
+                                         const Matrix &input) {
+    TRACE_SCOPE("SGD::updateShared");
+    // Other threads update the same parameters without locks. Each element is read and written with
+    // relaxed atomics (no locked read-modify-write): a concurrent update may be overwritten, which
+    // Hogwild tolerates. Zero inputs and deltas are skipped, so sparse samples only touch their weights.
+    const size_t rows = w.getShape().rows;
+    const size_t cols = w.getShape().cols;
+    float* w_ptr = w.data();
+    float* b_ptr = b.data();
+    const float* delta_ptr = delta.data();
+    const float* input_ptr = input.data();
+    for (size_t i = 0; i < rows; i++) {
+        float cache = learning_rate * delta_ptr[i];
+        if (cache == 0.0f) continue;
+        float* w_row = w_ptr + i*cols;
+        for (size_t j = 0; j < cols; j++) {
+            if (input_ptr[j] == 0.0f) continue;
+            std::atomic_ref<float> weight(w_row[j]);
+            weight.store(weight.load(std::memory_order_relaxed) - cache * input_ptr[j], std::memory_order_relaxed);
+        }
+        std::atomic_ref<float> bias(b_ptr[i]);
+        bias.store(bias.load(std::memory_order_relaxed) - cache, std::memory_order_relaxed);
+    }
+}
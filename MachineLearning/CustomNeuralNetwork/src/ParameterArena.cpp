@@ -0,0 +1,137 @@
+#include <CustomNeuralNetwork/ParameterArena.h>
+#include <CustomNeuralNetwork/DenseLayer.h>
+#include <CustomNeuralNetwork/Optimizers/BaseOptimizer.h>
+#include <LinearAlgebra/LinAlg.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <format>
+
+
+namespace {
+    size_t alignUp(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+}
+
+// Getters
+bool ParameterArena::isBound(const std::vector<DenseLayer>& layers, size_t gradient_sets) const {
+    if (!parameters || slots.size() != layers.size() || this->gradient_sets < gradient_sets) {
+        return false;
+    }
+    for (size_t l = 0; l < layers.size(); l++) {
+        if (layers[l].getWeights().data() != parameters + slots[l].weights_offset
+            || layers[l].getBiases().data() != parameters + slots[l].biases_offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ParameterArena::getSize() const {
+    return size;
+}
+
+size_t ParameterArena::getWeightCount() const {
+    return weight_count;
+}
+
+size_t ParameterArena::getGradientSets() const {
+    return gradient_sets;
+}
+
+float* ParameterArena::getParameters() {
+    return parameters;
+}
+
+const float* ParameterArena::getParameters() const {
+    return parameters;
+}
+
+float* ParameterArena::getGradients(size_t set) {
+    if (set >= gradient_sets) {
+        throw std::out_of_range(std::format("Gradient set {} out of range (the arena has {})", set, gradient_sets));
+    }
+    return parameters + (set + 1) * size;
+}
+
+const float* ParameterArena::getGradients(size_t set) const {
+    return const_cast<ParameterArena*>(this)->getGradients(set);
+}
+
+ParameterSpan ParameterArena::getSpan(size_t set) {
+    return {parameters, getGradients(set), size, weight_count};
+}
+
+// Methods
+void ParameterArena::bind(std::vector<DenseLayer>& layers, size_t gradient_sets) {
+    TRACE_SCOPE("ParameterArena::bind");
+    if (gradient_sets == 0) {
+        throw std::invalid_argument("A parameter arena needs at least one gradient set");
+    }
+    // Layout: every weight matrix, then every bias vector, each on its own cache line
+    std::vector<Slot> layout(layers.size());
+    size_t offset = 0;
+    for (size_t l = 0; l < layers.size(); l++) {
+        layout[l].weights_offset = offset;
+        offset = alignUp(offset + layers[l].getWeights().getShape().N, ALIGNMENT);
+    }
+    size_t weights_end = offset;
+    for (size_t l = 0; l < layers.size(); l++) {
+        layout[l].biases_offset = offset;
+        offset = alignUp(offset + layers[l].getBiases().getSize(), ALIGNMENT);
+    }
+
+    // Zero-initialized: the padding of every set stays zero for the whole training
+    std::vector<float> buffer((gradient_sets + 1) * offset + ALIGNMENT);
+    void* start = buffer.data();
+    size_t space = buffer.size() * sizeof(float);
+    float* aligned = static_cast<float*>(std::align(ALIGNMENT * sizeof(float), offset * sizeof(float), start, space));
+
+    // The layers still read their current buffers (owned, mapped or a previous arena) while they are copied
+    for (size_t l = 0; l < layers.size(); l++) {
+        float* gradients = aligned + offset;
+        layers[l].bindParameters(aligned + layout[l].weights_offset, aligned + layout[l].biases_offset,
+                                 gradients + layout[l].weights_offset, gradients + layout[l].biases_offset);
+    }
+    storage = std::move(buffer);
+    parameters = aligned;
+    size = offset;
+    weight_count = weights_end;
+    this->gradient_sets = gradient_sets;
+    slots = std::move(layout);
+}
+
+void ParameterArena::bindGradients(const std::vector<DenseLayer>& layers, std::vector<DenseLayerBuffers>& buffers, size_t set) {
+    if (!isBound(layers) || buffers.size() != layers.size()) {
+        throw std::logic_error("Gradient buffers can only be bound to the arena of their layers");
+    }
+    float* gradients = getGradients(set);
+    for (size_t l = 0; l < layers.size(); l++) {
+        layers[l].bindGradients(buffers[l], gradients + slots[l].weights_offset, gradients + slots[l].biases_offset);
+    }
+}
+
+void ParameterArena::zeroGradients(size_t set) {
+    std::fill_n(getGradients(set), size, 0.0f);
+}
+
+void ParameterArena::accumulateGradients(size_t target, size_t source) {
+    float* into = getGradients(target);
+    linalg::kernels::zip(into, static_cast<const float*>(getGradients(source)), into, size,
+                         [](float a, float b) { return a + b; });
+}
+
+void ParameterArena::snapshot(std::vector<float>& out) const {
+    out.resize(size);
+    std::copy_n(parameters, size, out.data());
+}
+
+void ParameterArena::restore(const std::vector<float>& in) {
+    if (in.size() != size) {
+        throw std::invalid_argument(std::format("Snapshot of {} parameters does not match the arena size {}", in.size(), size));
+    }
+    std::copy_n(in.data(), size, parameters);
+}
@@ -0,0 +1,214 @@
+#include <CustomNeuralNetwork/QuantizedNN.h>
+#include <CustomNeuralNetwork/NN.h>
+#include <CustomNeuralNetwork/DenseLayer.h>
+#include <CustomNeuralNetwork/ActivationFunctions/BaseActivationFunction.h>
+#include <Utils/trace.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+
+namespace {
+    constexpr float INT8_MAX_LEVEL = 127.0f;
+
+    template <typename Act>
+    void denseLayer(const int8_t* x, const int8_t* w, const float* scales, const float* bias, float* y,
+                    size_t rows, size_t input_dim, size_t output_dim, Act act) {
+        linalg::kernels::gemmInt8Epilogue(x, w, y, rows, input_dim, output_dim,
+            linalg::epilogue::Dequantize{scales, bias}, act);
+    }
+
+    // Scale mapping the calibrated range of `values` onto [-127, 127]
+    float calibrateScale(const Matrix& values, const QuantizationOptions& options) {
+        std::vector<float> magnitudes(values.getShape().N);
+        std::transform(values.data(), values.data() + magnitudes.size(), magnitudes.begin(),
+                       [](float v) { return std::abs(v); });
+        float range = 0;
+        if (!magnitudes.empty()) {
+            if (options.method == CalibrationMethod::PERCENTILE) {
+                size_t k = static_cast<size_t>(options.percentile / 100.0f * (magnitudes.size() - 1));
+                std::nth_element(magnitudes.begin(), magnitudes.begin() + k, magnitudes.end());
+                range = magnitudes[k];
+            } else {
+                range = *std::max_element(magnitudes.begin(), magnitudes.end());
+            }
+        }
+        // A layer whose input is constantly zero still needs a usable scale
+        return range > 0 ? range / INT8_MAX_LEVEL : 1.0f;
+    }
+}
+
+ActivationType QuantizedNN::fusedActivation(const BaseActivationFunction& function) {
+    // Softmax is not fused but runs as a row-wise pass over the layer output
+    if (function.getType() == ActivationType::Custom) {
+        throw std::invalid_argument(std::format("Cannot quantize a layer with activation function: {}", function.getName()));
+    }
+    return function.getType();
+}
+
+// Constructor/Destructor
+QuantizedNN::QuantizedNN(const NN& model, const Matrix& calibration, const QuantizationOptions& options) {
+    model.validateNetwork("quantize");
+    if (calibration.getShape().rows == 0 || calibration.getShape().cols != static_cast<size_t>(model.getInputSize())) {
+        throw std::invalid_argument("Calibration data must be a non-empty Matrix with one input sample per row");
+    }
+    if (options.method == CalibrationMethod::PERCENTILE && !(options.percentile > 0.0f && options.percentile <= 100.0f)) {
+        throw std::invalid_argument(std::format("Calibration percentile must be in (0, 100], got {}", options.percentile));
+    }
+    const std::vector<DenseLayer>& layers = model.getLayers();
+    auto quantized = std::make_shared<Plan>();
+    quantized->input_size = model.getInputSize();
+    quantized->output_size = model.getOutputSize();
+
+    size_t weights_total = 0;
+    size_t parameters_total = 0;
+    for (const DenseLayer& layer : layers) {
+        Layer step;
+        step.input_dim = layer.getInputDim();
+        step.output_dim = layer.getOutputDim();
+        step.activation = fusedActivation(*layer.getActivationFunction());
+        step.input_scale = 1.0f;
+        step.weights_offset = weights_total;
+        weights_total += step.output_dim * step.input_dim;
+        step.scales_offset = parameters_total;
+        parameters_total += step.output_dim;
+        step.biases_offset = parameters_total;
+        parameters_total += step.output_dim;
+        quantized->layers.push_back(step);
+        quantized->max_width = std::max(quantized->max_width, step.output_dim);
+        quantized->max_input = std::max(quantized->max_input, step.input_dim);
+    }
+    quantized->weights.resize(weights_total);
+    quantized->parameters.resize(parameters_total);
+
+    // The fp32 model runs over the calibration data: layer l's input range comes from layer l-1's output
+    const Matrix* input = &calibration;
+    Matrix activations[2];
+    for (size_t l = 0; l < layers.size(); l++) {
+        Layer& step = quantized->layers[l];
+        step.input_scale = calibrateScale(*input, options);
+
+        // Symmetric per-output-channel weights: row j is scaled by its own largest magnitude
+        const Matrix& w = layers[l].getWeights();
+        const Vector& b = layers[l].getBiases();
+        int8_t* q = quantized->weights.data() + step.weights_offset;
+        float* scales = quantized->parameters.data() + step.scales_offset;
+        for (size_t j = 0; j < step.output_dim; j++) {
+            const float* row = w.data() + j*step.input_dim;
+            float range = 0;
+            for (size_t k = 0; k < step.input_dim; k++) {
+                range = std::max(range, std::abs(row[k]));
+            }
+            const float channel_scale = range > 0 ? range / INT8_MAX_LEVEL : 1.0f;
+            linalg::kernels::quantizeInt8(row, q + j*step.input_dim, step.input_dim, channel_scale);
+            scales[j] = step.input_scale * channel_scale;
+        }
+        std::copy(b.data(), b.data() + step.output_dim, quantized->parameters.data() + step.biases_offset);
+
+        if (l + 1 < layers.size()) {
+            layers[l].getActivationFunction()->forwardDenseBatch(*input, w, b, activations[l % 2], nullptr);
+            input = &activations[l % 2];
+        }
+    }
+    plan = std::move(quantized);
+    quantized_input.resize(plan->max_input);
+    buffers[0].resize(1, plan->max_width);
+    buffers[1].resize(1, plan->max_width);
+    output.setSize(plan->output_size);
+}
+
+// Getters
+size_t QuantizedNN::getInputSize() const {
+    return plan->input_size;
+}
+
+size_t QuantizedNN::getOutputSize() const {
+    return plan->output_size;
+}
+
+size_t QuantizedNN::getLayerCount() const {
+    return plan->layers.size();
+}
+
+size_t QuantizedNN::getParameterBytes() const {
+    return plan->weights.size() * sizeof(int8_t) + plan->parameters.size() * sizeof(float);
+}
+
+size_t QuantizedNN::getMemoryBytes() const {
+    size_t floats = buffers[0].getShape().N + buffers[1].getShape().N + output.getSize();
+    return getParameterBytes() + quantized_input.size() * sizeof(int8_t) + floats * sizeof(float);
+}
+
+std::vector<float> QuantizedNN::getInputScales() const {
+    std::vector<float> scales;
+    for (const Layer& step : plan->layers) {
+        scales.push_back(step.input_scale);
+    }
+    return scales;
+}
+
+// Methods
+const float* QuantizedNN::run(const float* x, size_t rows) {
+    for (Matrix& buffer : buffers) {
+        if (buffer.getShape().N < rows * plan->max_width) {
+            buffer.resize(rows, plan->max_width);
+        }
+    }
+    if (quantized_input.size() < rows * plan->max_input) {
+        quantized_input.resize(rows * plan->max_input);
+    }
+    // Layer l quantizes what layer l-1 wrote, then writes the other float buffer
+    const float* input = x;
+    for (size_t l = 0; l < plan->layers.size(); l++) {
+        const Layer& step = plan->layers[l];
+        int8_t* q = quantized_input.data();
+        linalg::kernels::quantizeInt8(input, q, rows * step.input_dim, step.input_scale);
+        const int8_t* w = plan->weights.data() + step.weights_offset;
+        const float* scales = plan->parameters.data() + step.scales_offset;
+        const float* bias = plan->parameters.data() + step.biases_offset;
+        float* y = buffers[l % 2].data();
+        if (!dispatchActivation(step.activation, [&](auto act) {
+                denseLayer(q, w, scales, bias, y, rows, step.input_dim, step.output_dim, act);
+            })) {
+            denseLayer(q, w, scales, bias, y, rows, step.input_dim, step.output_dim, linalg::epilogue::Identity{});
+            linalg::kernels::softmaxRows(y, y, rows, step.output_dim);
+        }
+        input = y;
+    }
+    return input;
+}
+
+const Vector& QuantizedNN::predict(const float* x) {
+    TRACE_SCOPE("QuantizedNN::predict");
+    const float* y = run(x, 1);
+    std::copy(y, y + plan->output_size, output.data());
+    return output;
+}
+
+const Vector& QuantizedNN::predict(const Vector& x) {
+    if (x.getSize() != plan->input_size) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    return predict(x.data());
+}
+
+const Vector& QuantizedNN::predict(std::initializer_list<float> x) {
+    if (x.size() != plan->input_size) {
+        throw std::invalid_argument("Input size does not match NN dimension!");
+    }
+    return predict(x.begin());
+}
+
+const Matrix& QuantizedNN::predictBatch(const Matrix& x) {
+    TRACE_SCOPE("QuantizedNN::predictBatch");
+    if (x.getShape().cols != plan->input_size) {
+        throw std::invalid_argument("Matrix columns must match NN input size 'n'");
+    }
+    size_t rows = x.getShape().rows;
+    run(x.data(), rows);
+    Matrix& last = buffers[(plan->layers.size() - 1) % 2];
+    last.resize(rows, plan->output_size);
+    return last;
+}
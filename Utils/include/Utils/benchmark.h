@@ -1,12 +1,241 @@
+#ifndef UTILS_BENCHMARK_H
+#define UTILS_BENCHMARK_H
+
 #include <functional>
 #include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <type_traits>
+
+
+// ========== OPTIMIZATION BARRIERS ==========
+
+/**
+ * @brief Forces the compiler to consider `value` as used (and its computation as needed).
+ *
+ * Prevents dead-code elimination of benchmarked work whose result is otherwise discarded.
+ * @example
+ *   runBenchmark("dot", [&]() { doNotOptimize(A.dot(B)); });
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (std::is_arithmetic_v<T> || std::is_pointer_v<T>) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    } else {
+        asm volatile("" : : "m"(value) : "memory");
+    }
+#else
+    const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+    (void)*sink;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * @brief Forces every pending write to memory to be considered observable.
+ *
+ * Use after work that only has side effects through memory (e.g. in-place kernels).
+ */
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+
+// ========== CONFIGURATION / RESULTS ==========
+
+/**
+ * @brief Controls how runBenchmark() samples an operation.
+ */
+struct BenchmarkOptions {
+    double warmup_ms = 50;          ///< Time spent running the operation before measuring
+    double min_sample_ms = 10;      ///< Target duration of one sample (drives the adaptive iteration count)
+    size_t samples = 30;            ///< Number of timed samples (repetitions)
+    size_t iterations = 0;          ///< Fixed iterations per sample; 0 = adaptive
+    size_t max_iterations = 1'000'000'000;
+    int cpu = -1;                   ///< Pin the calling thread to this CPU before measuring; -1 = no pinning
+    double flops = 0;               ///< Floating point operations per iteration (enables GFLOP/s)
+    double bytes = 0;               ///< Bytes moved per iteration (enables GB/s)
+};
+
+/**
+ * @brief Statistics of one benchmarked operation. All times are per iteration, in nanoseconds.
+ */
+struct BenchmarkResult {
+    std::string name;
+    long long argument = -1;        ///< Sweep parameter (e.g. matrix size); -1 when not part of a sweep
+    size_t iterations = 0;          ///< Iterations per sample
+    std::vector<double> samples_ns; ///< Per-iteration time of each sample
+
+    double mean = 0;
+    double stddev = 0;
+    double min = 0;
+    double max = 0;
+    double median = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double median_ci_low = 0;       ///< 95% confidence interval of the median (order statistics)
+    double median_ci_high = 0;
+
+    double gflops = 0;              ///< 0 when no flop count was given
+    double gbps = 0;                ///< 0 when no byte count was given
+
+    /// Extra named metrics attached by instrumentation (e.g. hardware counters)
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+
+// ========== HARNESS ==========
+
+/**
+ * @brief Pins the calling thread to a CPU core to reduce scheduling noise.
+ * @return false if pinning is not supported or failed
+ */
+bool pinToCpu(int cpu);
+
+/**
+ * @brief Fills the statistics of `result` from its samples and the flop/byte counts in `options`.
+ */
+void computeStatistics(BenchmarkResult& result, const BenchmarkOptions& options);
+
+/**
+ * @brief Runs `func` iterations per sample until `samples` samples have been collected.
+ *
+ * 1. Optional CPU pinning;
+ * 2. Warm-up for `warmup_ms`, which also estimates the cost of one iteration;
+ * 3. Iterations per sample chosen so that one sample lasts about `min_sample_ms`
+ *    (unless `iterations` is fixed);
+ * 4. `samples` timed repetitions, reduced to median/p90/p99, mean/stddev and a median CI.
+ *
+ * `func` is called directly (not through std::function), so the timing loop adds no
+ * indirect call. Use doNotOptimize()/clobberMemory() inside it to keep the work alive.
+ * @param name Label used in reports
+ * @param func Operation to measure (callable with no arguments)
+ * @param options Sampling options
+ */
+template <typename Func>
+BenchmarkResult runBenchmark(const std::string& name, Func&& func, const BenchmarkOptions& options = {}) {
+    using clock = std::chrono::steady_clock;
+    BenchmarkResult result;
+    result.name = name;
+
+    if (options.cpu >= 0) {
+        pinToCpu(options.cpu);
+    }
+
+    // Warm-up (caches, branch predictors, CPU frequency) and cost estimate
+    size_t warmup_iterations = 0;
+    auto warmup_start = clock::now();
+    double elapsed_ns = 0;
+    do {
+        func();
+        clobberMemory();
+        warmup_iterations++;
+        elapsed_ns = std::chrono::duration<double, std::nano>(clock::now() - warmup_start).count();
+    } while (elapsed_ns < options.warmup_ms * 1e6);
 
+    // Adaptive iteration count
+    size_t iterations = options.iterations;
+    if (iterations == 0) {
+        double estimate_ns = elapsed_ns / warmup_iterations;
+        double target = (options.min_sample_ms * 1e6) / (estimate_ns > 0 ? estimate_ns : 1);
+        iterations = target < 1 ? 1 : static_cast<size_t>(target);
+        if (iterations > options.max_iterations) iterations = options.max_iterations;
+    }
+    result.iterations = iterations;
+
+    // Timed samples
+    result.samples_ns.reserve(options.samples);
+    for (size_t s = 0; s < options.samples; s++) {
+        auto start = clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            func();
+        }
+        clobberMemory();
+        auto end = clock::now();
+        result.samples_ns.push_back(std::chrono::duration<double, std::nano>(end - start).count() / iterations);
+    }
+
+    computeStatistics(result, options);
+    return result;
+}
+
+/**
+ * @brief Benchmarks the same operation over a range of sizes.
+ *
+ * @param name Base label; each result is named "name/size"
+ * @param sizes Values of the swept parameter
+ * @param factory Called once per size as `factory(size)`; returns the callable to measure
+ *                (it should own/capture its inputs so setup is excluded from the timing)
+ * @param options Sampling options shared by every size
+ * @param flops Optional flop count per iteration as a function of size
+ * @param bytes Optional byte count per iteration as a function of size
+ * @example
+ *   sweep("dot", {64, 128, 256}, [](size_t n) {
+ *       return [A = Matrix::random(n, n), B = Matrix::random(n, n)]() { doNotOptimize(A.dot(B)); };
+ *   }, {}, [](size_t n) { return 2.0*n*n*n; });
+ */
+template <typename Factory>
+std::vector<BenchmarkResult> sweep(const std::string& name, const std::vector<size_t>& sizes, Factory&& factory,
+                                   BenchmarkOptions options = {},
+                                   const std::function<double(size_t)>& flops = {},
+                                   const std::function<double(size_t)>& bytes = {}) {
+    std::vector<BenchmarkResult> results;
+    results.reserve(sizes.size());
+    for (size_t size : sizes) {
+        auto operation = factory(size);
+        options.flops = flops ? flops(size) : 0;
+        options.bytes = bytes ? bytes(size) : 0;
+        BenchmarkResult result = runBenchmark(name + "/" + std::to_string(size), operation, options);
+        result.argument = static_cast<long long>(size);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+/**
+ * @brief Geometric sequence [from, from*factor, ...] up to and including `to`.
+ */
+std::vector<size_t> geometricRange(size_t from, size_t to, size_t factor = 2);
+
+
+// ========== REPORTING ==========
+
+/**
+ * @brief Prints a table of results (median, p90, p99, CI, throughput and extra metrics).
+ */
+void printResults(const std::vector<BenchmarkResult>& results);
+
+/**
+ * @brief Prints the fastest result (by median) and the speedup over each other result.
+ */
+void printComparison(const std::vector<BenchmarkResult>& results);
+
+std::string toJson(const std::vector<BenchmarkResult>& results);
+std::string toCsv(const std::vector<BenchmarkResult>& results);
+
+/**
+ * @brief Writes the results to a file as JSON or CSV.
+ * @throw std::runtime_error if the file cannot be opened
+ */
+void writeJson(const std::string& file_name, const std::vector<BenchmarkResult>& results);
+void writeCsv(const std::string& file_name, const std::vector<BenchmarkResult>& results);
+
+
+// ========== LEGACY API ==========
 
 /**
  * @brief Generic benchmark function that compares multiple operations
- * 
+ *
+ * Runs each operation through runBenchmark() with a fixed iteration count per sample,
+ * then prints the statistics and the fastest operation.
  * @param operations Vector of pairs (operation_name, lambda_function)
- * @param iterations Number of times to run each operation
+ * @param iterations Number of times to run each operation per sample
  * @param show_fastest If true, highlights which operation is fastest
  */
 void benchmark(const std::vector<std::pair<std::string, std::function<void()>>>& operations,
@@ -19,24 +248,10 @@ void benchmark(const std::vector<std::pair<std::string, std::function<void()>>>&
 //     {"transpose3() - other", [&]() { test.transpose3(); }}
 // }, 2);
 
+// auto results = sweep("dot", geometricRange(32, 512), [](size_t n) {
+//     return [A = Matrix::random(n, n), B = Matrix::random(n, n)]() { doNotOptimize(A.dot(B)); };
+// }, {}, [](size_t n) { return 2.0*n*n*n; }, [](size_t n) { return 3.0*n*n*sizeof(float); });
+// printResults(results);
+// writeJson("dot.json", results);
 
-// Matrix M1({
-//     {1, 2, 3, 4, 5},
-//     {1, 2, 3, 4, 5},
-//     {1, 2, 3, 4, 5},
-//     {1, 2, 3, 4, 5},
-//     {1, 2, 3, 4, 5}
-// });
-
-// Matrix M2({
-//     {6, 7, 8, 9, 10},
-//     {6, 7, 8, 9, 10},
-//     {6, 7, 8, 9, 10},
-//     {6, 7, 8, 9, 10},
-//     {6, 7, 8, 9, 10}
-// });
-
-// benchmark({
-//     {"dot() - naive", [&]() { M1.dot(M2); }},
-//     {"dot2() - block", [&]() { Matrix::dot2(M1, M2); }},
-// }, 100);
+#endif // UTILS_BENCHMARK_H
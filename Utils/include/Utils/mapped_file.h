@@ -0,0 +1,45 @@
+#ifndef UTILS_MAPPED_FILE_H
+#define UTILS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * @brief Read-write, copy-on-write memory mapping of a whole file.
+ *
+ * The pages come straight from the OS page cache: nothing is read until it is touched, and
+ * every process mapping the same file shares the same physical pages. Writes through data()
+ * are private to this mapping (copy-on-write) and never reach the file.
+ *
+ * @example
+ *   MappedFile file("model.cnn");
+ *   const float* weights = reinterpret_cast<const float*>(file.data() + offset);
+ */
+class MappedFile {
+private:
+    std::byte* mapped = nullptr;
+    size_t mapped_size = 0;
+    std::string file_name;
+
+    void unmap();
+
+public:
+    /**
+     * @throw std::runtime_error if the file cannot be opened or mapped, or is empty
+     */
+    explicit MappedFile(const std::string& file_name);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::byte* data();
+    const std::byte* data() const;
+    size_t size() const;
+    const std::string& getFileName() const;
+};
+
+#endif // UTILS_MAPPED_FILE_H
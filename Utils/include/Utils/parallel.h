@@ -0,0 +1,93 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Fork-join pool of persistent worker threads.
+ *
+ * run(func) calls func(worker) once on every worker, worker in [0, size()), and returns when all
+ * of them finished. The calling thread is worker 0, so a pool of size 1 runs inline without
+ * threads. Workers spin briefly before sleeping, which keeps back-to-back run() calls (e.g. one
+ * per mini-batch) cheap, and dispatching a task does not allocate.
+ *
+ * @example
+ *   WorkerPool pool(4);
+ *   pool.run([&](size_t worker) {
+ *       partial[worker] = sumShard(worker);
+ *       pool.barrier();                      // every partial is ready past this point
+ *   });
+ */
+class WorkerPool {
+private:
+    using Task = void (*)(void* context, size_t worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Current task, published by the release increment of `generation`
+    Task task = nullptr;
+    void* context = nullptr;
+    std::atomic<size_t> generation{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> stopping{false};
+    std::exception_ptr worker_error;
+
+    // Sense-reversing barrier shared by the workers of the current task
+    std::atomic<size_t> barrier_count{0};
+    std::atomic<size_t> barrier_generation{0};
+
+    void dispatch(Task task, void* context);
+    void workerLoop(size_t worker);
+
+public:
+    /**
+     * @param threads Number of workers including the calling thread; 0 uses every hardware thread
+     */
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const;
+
+    /**
+     * @brief Runs func(worker) on every worker and waits for all of them.
+     *
+     * The first exception thrown by a worker is rethrown here. A worker that throws must not
+     * leave the others waiting in barrier().
+     */
+    template <typename Func>
+    void run(Func&& func) {
+        using F = std::remove_reference_t<Func>;
+        dispatch([](void* context, size_t worker) { (*static_cast<F*>(context))(worker); },
+                 const_cast<void*>(static_cast<const void*>(&func)));
+    }
+
+    /**
+     * @brief Blocks until every worker of the current run() reached the barrier.
+     * @warning Only callable from inside run(), by all workers the same number of times.
+     */
+    void barrier();
+};
+
+/**
+ * @brief Splits [0, count) into `parts` contiguous chunks whose sizes differ by at most one.
+ * @return The [begin, end) range of chunk `part`
+ */
+inline std::pair<size_t, size_t> chunkRange(size_t count, size_t parts, size_t part) {
+    return {part * count / parts, (part + 1) * count / parts};
+}
+
+#endif // UTILS_PARALLEL_H
@@ -0,0 +1,152 @@
+#ifndef UTILS_PERF_H
+#define UTILS_PERF_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <utility>
+#include <Utils/benchmark.h>
+
+
+/**
+ * @brief Hardware events collected by PerfCounters.
+ */
+enum class PerfEvent : size_t {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    FP_VECTOR_OPS,  ///< Retired packed SSE/AVX FP instructions (Intel only)
+    COUNT
+};
+
+/**
+ * @brief Counter values of one measured region.
+ *
+ * Values are already scaled for multiplexing (enabled/running time).
+ * An event that could not be opened is reported as `available[e] == false`.
+ */
+struct PerfReading {
+    std::array<double, static_cast<size_t>(PerfEvent::COUNT)> values{};
+    std::array<bool, static_cast<size_t>(PerfEvent::COUNT)> available{};
+
+    bool has(PerfEvent event) const;
+    double get(PerfEvent event) const;
+
+    /**
+     * @brief Instructions per cycle (0 if cycles or instructions are unavailable).
+     */
+    double ipc() const;
+
+    /**
+     * @brief Misses per thousand instructions for a miss event (0 if unavailable).
+     */
+    double mpki(PerfEvent event) const;
+
+    /**
+     * @brief Derived metrics ready to attach to a BenchmarkResult.
+     *
+     * Includes IPC, L1D/LLC/branch MPKI and per-iteration cycles, instructions and
+     * FP vector ops. Only metrics whose events are available are included.
+     * @param iterations Number of iterations executed inside the measured region
+     */
+    std::vector<std::pair<std::string, double>> metrics(size_t iterations = 1) const;
+};
+
+/**
+ * @brief Hardware performance counters of the calling thread (Linux perf_event_open).
+ *
+ * Every event is opened on its own, so a missing event (e.g. no LLC counter in a VM,
+ * or a non-Intel CPU for FP_VECTOR_OPS) does not prevent the others from working.
+ * When no counter can be opened at all (non-Linux, containers without perf access,
+ * perf_event_paranoid too strict...) the object stays usable: start()/stop() are
+ * no-ops, isAvailable() is false and getError() tells why.
+ *
+ * Only user-space events are counted, so a perf_event_paranoid of 2 is enough.
+ */
+class PerfCounters {
+private:
+    std::array<int, static_cast<size_t>(PerfEvent::COUNT)> fds;
+    std::string error;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool isAvailable() const;
+    bool isAvailable(PerfEvent event) const;
+    const std::string& getError() const;
+
+    /**
+     * @brief Resets and enables every open counter.
+     */
+    void start();
+
+    /**
+     * @brief Disables every open counter.
+     */
+    void stop();
+
+    /**
+     * @brief Current (multiplex-scaled) values since the last start().
+     */
+    PerfReading read() const;
+
+    static std::string getName(PerfEvent event);
+};
+
+/**
+ * @brief RAII region: counts between construction and destruction, then stores the reading.
+ * @example
+ *   PerfCounters counters;
+ *   PerfReading reading;
+ *   {
+ *       ScopedPerfRegion region(counters, reading);
+ *       A.dot(B);
+ *   }
+ *   print("IPC: ", reading.ipc(), "\n");
+ */
+class ScopedPerfRegion {
+private:
+    PerfCounters& counters;
+    PerfReading& reading;
+
+public:
+    ScopedPerfRegion(PerfCounters& counters, PerfReading& reading);
+    ~ScopedPerfRegion();
+    ScopedPerfRegion(const ScopedPerfRegion&) = delete;
+    ScopedPerfRegion& operator=(const ScopedPerfRegion&) = delete;
+};
+
+/**
+ * @brief runBenchmark() plus a hardware-counter pass.
+ *
+ * After the timed samples, one extra sample of `result.iterations` iterations runs inside
+ * a ScopedPerfRegion (so counter setup never pollutes the timings) and the derived metrics
+ * (IPC, MPKI, per-iteration counts) are appended to `result.metrics`.
+ * Without counter access this is exactly runBenchmark().
+ */
+template <typename Func>
+BenchmarkResult runBenchmarkWithCounters(const std::string& name, Func&& func, PerfCounters& counters,
+                                         const BenchmarkOptions& options = {}) {
+    BenchmarkResult result = runBenchmark(name, func, options);
+    if (!counters.isAvailable()) {
+        return result;
+    }
+    PerfReading reading;
+    {
+        ScopedPerfRegion region(counters, reading);
+        for (size_t i = 0; i < result.iterations; i++) {
+            func();
+        }
+        clobberMemory();
+    }
+    auto metrics = reading.metrics(result.iterations);
+    result.metrics.insert(result.metrics.end(), metrics.begin(), metrics.end());
+    return result;
+}
+
+#endif // UTILS_PERF_H
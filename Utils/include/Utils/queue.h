@@ -0,0 +1,175 @@
+#ifndef UTILS_QUEUE_H
+#define UTILS_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Unbounded lock-free multi-producer single-consumer FIFO queue (Vyukov's intrusive MPSC).
+ *
+ * push() is wait-free: one atomic exchange plus one store, callable from any number of threads.
+ * pop() must only be called from a single consumer thread. Each element lives in its own node,
+ * allocated by push() and freed by pop().
+ *
+ * @note While a producer is between its exchange and its store, pop() may briefly report the
+ * queue as empty even though later pushes completed; the element shows up on a later pop().
+ */
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value; // Empty in the stub node
+    };
+
+    alignas(64) std::atomic<Node*> head; // Producers: last pushed node
+    alignas(64) Node* tail;              // Consumer: node before the next element (the stub)
+
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+
+    ~MpscQueue() {
+        while (pop()) {
+        }
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node();
+        node->value.emplace(std::move(value));
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Removes the oldest element (consumer thread only).
+     * @return std::nullopt if the queue is empty
+     */
+    std::optional<T> pop() {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+        // `next` becomes the new stub: its value is moved out and the old stub freed
+        std::optional<T> value(std::move(next->value));
+        next->value.reset();
+        delete tail;
+        tail = next;
+        return value;
+    }
+
+    /**
+     * @brief True if pop() would currently return nothing (consumer thread only).
+     */
+    bool empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+/**
+ * @brief Bounded lock-free single-producer single-consumer ring of reusable slots.
+ *
+ * The slots are constructed once and filled in place: the producer takes the next free slot with
+ * writeSlot(), fills it and publishes it with commit(); the consumer reads the oldest published
+ * slot with readSlot() and hands it back with release(). Nothing is moved or allocated per
+ * element, so a slot can own large buffers (e.g. a double- or triple-buffered batch).
+ *
+ * A side that finds the ring full (or empty) can block without a lock: observe() the signal,
+ * retry, then wait() on the observed value. Every commit(), release() and notify() changes the
+ * signal, so a wait() never misses the event it is waiting for.
+ *
+ * @example
+ *   uint32_t observed = ring.observe();
+ *   T* slot = ring.readSlot();
+ *   if (!slot) ring.wait(observed);       // then retry
+ */
+template <typename T>
+class SpscRing {
+private:
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> write_count{0}; // Slots published by the producer
+    alignas(64) std::atomic<size_t> read_count{0};  // Slots released by the consumer
+    alignas(64) std::atomic<uint32_t> signal{0};
+
+    void bump() {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        signal.notify_all();
+    }
+
+public:
+    explicit SpscRing(size_t capacity, const T& prototype = T()) : slots(capacity, prototype) {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const {
+        return slots.size();
+    }
+
+    /**
+     * @brief Next free slot (producer thread only).
+     * @return nullptr if every slot is published and not yet released
+     */
+    T* writeSlot() {
+        size_t written = write_count.load(std::memory_order_relaxed);
+        if (written - read_count.load(std::memory_order_acquire) == slots.size()) {
+            return nullptr;
+        }
+        return &slots[written % slots.size()];
+    }
+
+    void commit() {
+        write_count.fetch_add(1, std::memory_order_release);
+        bump();
+    }
+
+    /**
+     * @brief Oldest published slot (consumer thread only).
+     * @return nullptr if the ring is empty
+     */
+    T* readSlot() {
+        size_t read = read_count.load(std::memory_order_relaxed);
+        if (write_count.load(std::memory_order_acquire) == read) {
+            return nullptr;
+        }
+        return &slots[read % slots.size()];
+    }
+
+    void release() {
+        read_count.fetch_add(1, std::memory_order_release);
+        bump();
+    }
+
+    uint32_t observe() const {
+        return signal.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Blocks while the signal still equals `observed`.
+     */
+    void wait(uint32_t observed) const {
+        signal.wait(observed, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Wakes both sides, e.g. after setting a stop flag they check.
+     */
+    void notify() {
+        bump();
+    }
+};
+
+#endif // UTILS_QUEUE_H
@@ -0,0 +1,133 @@
+#ifndef UTILS_TRACE_H
+#define UTILS_TRACE_H
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+
+
+/**
+ * @brief One completed zone ("complete" event of the Chrome trace format).
+ *
+ * `name` must point to storage that outlives the trace (string literals, __func__...).
+ */
+struct TraceEvent {
+    const char* name;
+    int64_t id;          ///< Optional instance id (e.g. layer id); -1 when unused
+    int64_t start_ns;    ///< Relative to the trace epoch
+    int64_t duration_ns;
+};
+
+namespace trace_detail {
+    extern std::atomic<bool> enabled;
+
+    /**
+     * @brief Appends an event to the calling thread's buffer.
+     *
+     * Each thread owns a fixed-capacity buffer registered once (under a lock) on first use;
+     * afterwards appending is a plain store plus a release increment, without locks.
+     * Events beyond the capacity are dropped and counted.
+     */
+    void record(const TraceEvent& event);
+
+    inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+/**
+ * @brief RAII tracing zone: records the time between construction and destruction.
+ *
+ * Prefer the TRACE_SCOPE/TRACE_SCOPE_ID macros, which compile to nothing unless
+ * ENABLE_TRACING is defined. When tracing is compiled in but disabled at runtime
+ * (traceSetEnabled(false)), a zone costs one relaxed atomic load.
+ */
+class TraceZone {
+private:
+    const char* name;
+    int64_t id;
+    int64_t start_ns;
+
+public:
+    explicit TraceZone(const char* name, int64_t id = -1) :
+        name(name),
+        id(id),
+        start_ns(trace_detail::enabled.load(std::memory_order_relaxed) ? trace_detail::now() : -1)
+    {
+    }
+
+    ~TraceZone() {
+        if (start_ns >= 0) {
+            trace_detail::record({name, id, start_ns, trace_detail::now() - start_ns});
+        }
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+
+// ========== CONTROL / EXPORT ==========
+
+/**
+ * @brief Turns recording on or off at runtime (on by default when compiled in).
+ */
+void traceSetEnabled(bool enabled);
+bool traceIsEnabled();
+
+/**
+ * @brief Capacity (in events) of the buffers of threads that start tracing after this call.
+ */
+void traceSetBufferCapacity(size_t events);
+
+/**
+ * @brief Names the calling thread in the exported trace.
+ * @param name Must outlive the trace (e.g. a string literal)
+ */
+void traceSetThreadName(const char* name);
+
+/**
+ * @brief Discards every recorded event (buffers stay registered and allocated).
+ * @warning Not synchronized with threads that are still recording.
+ */
+void traceClear();
+
+/**
+ * @brief Number of events recorded / dropped because a thread buffer was full.
+ */
+size_t traceEventCount();
+size_t traceDroppedCount();
+
+/**
+ * @brief Serializes every recorded event to Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Zones with an id are exported as "name [id]" (and the id as an argument), so e.g. each
+ * layer gets its own slice name. Call it once recording threads are idle.
+ */
+std::string toChromeTrace();
+
+/**
+ * @brief Writes toChromeTrace() to a file.
+ * @throw std::runtime_error if the file cannot be opened
+ */
+void writeChromeTrace(const std::string& file_name);
+
+
+// ========== MACROS ==========
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+    /// Traces the rest of the enclosing scope under `name` (a string literal)
+    #define TRACE_SCOPE(name) TraceZone TRACE_CONCAT(trace_zone_, __LINE__)(name)
+    /// Same as TRACE_SCOPE, tagged with an instance id (e.g. a layer id)
+    #define TRACE_SCOPE_ID(name, id) TraceZone TRACE_CONCAT(trace_zone_, __LINE__)(name, static_cast<int64_t>(id))
+#else
+    #define TRACE_SCOPE(name) ((void)0)
+    #define TRACE_SCOPE_ID(name, id) ((void)0)
+#endif
+
+#endif // UTILS_TRACE_H
@@ -1,2 +1,7 @@
 #include <Utils/print.h>
-#include <Utils/benchmark.h>
\ No newline at end of file
+#include <Utils/benchmark.h>
+#include <Utils/perf.h>
+#include <Utils/trace.h>
+#include <Utils/parallel.h>
+#include <Utils/queue.h>
+#include <Utils/mapped_file.h>
@@ -1,39 +1,231 @@
 #include <Utils/benchmark.h>
 #include <chrono>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <format>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+
+// Harness
+bool pinToCpu(int cpu) {
+    if (cpu < 0) return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    return false;
+#endif
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    // Linear interpolation between closest ranks
+    if (sorted.empty()) return 0;
+    double rank = p * (sorted.size() - 1);
+    size_t low = static_cast<size_t>(std::floor(rank));
+    size_t high = static_cast<size_t>(std::ceil(rank));
+    double fraction = rank - low;
+    return sorted[low] + (sorted[high] - sorted[low]) * fraction;
+}
+
+void computeStatistics(BenchmarkResult& result, const BenchmarkOptions& options) {
+    const size_t n = result.samples_ns.size();
+    if (n == 0) return;
+    std::vector<double> sorted = result.samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+
+    result.min = sorted.front();
+    result.max = sorted.back();
+    result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+    double squares = 0;
+    for (double s : sorted) {
+        squares += (s - result.mean) * (s - result.mean);
+    }
+    result.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+    result.median = percentile(sorted, 0.5);
+    result.p90 = percentile(sorted, 0.9);
+    result.p99 = percentile(sorted, 0.99);
+
+    // Distribution-free 95% CI of the median: ranks n/2 -+ 1.96*sqrt(n)/2
+    double half_width = 1.96 * std::sqrt(static_cast<double>(n)) / 2;
+    long long low = static_cast<long long>(std::floor(n / 2.0 - half_width));
+    long long high = static_cast<long long>(std::ceil(n / 2.0 + half_width));
+    result.median_ci_low = sorted[std::clamp<long long>(low, 0, n - 1)];
+    result.median_ci_high = sorted[std::clamp<long long>(high, 0, n - 1)];
+
+    // flop/ns == GFLOP/s and byte/ns == GB/s
+    result.gflops = options.flops > 0 ? options.flops / result.median : 0;
+    result.gbps = options.bytes > 0 ? options.bytes / result.median : 0;
+}
+
+std::vector<size_t> geometricRange(size_t from, size_t to, size_t factor) {
+    if (from == 0 || factor < 2) {
+        throw std::invalid_argument("geometricRange() needs from > 0 and factor >= 2");
+    }
+    std::vector<size_t> range;
+    for (size_t value = from; value <= to; value *= factor) {
+        range.push_back(value);
+    }
+    return range;
+}
+
+
+// Reporting
+static std::string formatTime(double ns) {
+    if (ns < 1e3) return std::format("{:.2f} ns", ns);
+    if (ns < 1e6) return std::format("{:.2f} us", ns / 1e3);
+    if (ns < 1e9) return std::format("{:.2f} ms", ns / 1e6);
+    return std::format("{:.2f} s", ns / 1e9);
+}
+
+void printResults(const std::vector<BenchmarkResult>& results) {
+    std::cout << std::format("{:<32} {:>12} {:>12} {:>12} {:>27} {:>10} {:>10} {:>9}\n",
+        "Benchmark", "Median", "p90", "p99", "Median 95% CI", "GFLOP/s", "GB/s", "Iters");
+    for (const auto& r : results) {
+        std::cout << std::format("{:<32} {:>12} {:>12} {:>12} {:>27} {:>10} {:>10} {:>9}",
+            r.name, formatTime(r.median), formatTime(r.p90), formatTime(r.p99),
+            std::format("[{}, {}]", formatTime(r.median_ci_low), formatTime(r.median_ci_high)),
+            r.gflops > 0 ? std::format("{:.3f}", r.gflops) : "-",
+            r.gbps > 0 ? std::format("{:.3f}", r.gbps) : "-",
+            r.iterations);
+        for (const auto& [metric, value] : r.metrics) {
+            std::cout << std::format("  {}={:.4g}", metric, value);
+        }
+        std::cout << "\n";
+    }
+}
+
+void printComparison(const std::vector<BenchmarkResult>& results) {
+    if (results.empty()) return;
+    auto fastest = std::min_element(results.begin(), results.end(),
+        [](const auto& a, const auto& b) { return a.median < b.median; });
+    std::cout << "\n[Fastest: " << fastest->name << "]\n\n";
+
+    // Show speedups relative to fastest
+    for (const auto& r : results) {
+        if (&r != &*fastest && fastest->median > 0) {
+            double speedup = r.median / fastest->median;
+            std::cout << fastest->name << " is " << speedup << "x faster than " << r.name << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+static std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string toJson(const std::vector<BenchmarkResult>& results) {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {";
+        out << std::format("\"name\": \"{}\", \"argument\": {}, \"iterations\": {}, \"samples\": {}, ",
+            escapeJson(r.name), r.argument, r.iterations, r.samples_ns.size());
+        out << std::format("\"mean_ns\": {}, \"stddev_ns\": {}, \"min_ns\": {}, \"max_ns\": {}, ",
+            r.mean, r.stddev, r.min, r.max);
+        out << std::format("\"median_ns\": {}, \"p90_ns\": {}, \"p99_ns\": {}, ",
+            r.median, r.p90, r.p99);
+        out << std::format("\"median_ci_low_ns\": {}, \"median_ci_high_ns\": {}, \"gflops\": {}, \"gbps\": {}",
+            r.median_ci_low, r.median_ci_high, r.gflops, r.gbps);
+        for (const auto& [metric, value] : r.metrics) {
+            out << std::format(", \"{}\": {}", escapeJson(metric), std::isfinite(value) ? value : 0.0);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+std::string toCsv(const std::vector<BenchmarkResult>& results) {
+    // Metric columns are the union of every result's metrics, in first-seen order
+    std::vector<std::string> metric_names;
+    for (const auto& r : results) {
+        for (const auto& [metric, value] : r.metrics) {
+            if (std::find(metric_names.begin(), metric_names.end(), metric) == metric_names.end()) {
+                metric_names.push_back(metric);
+            }
+        }
+    }
+    std::ostringstream out;
+    out << "name,argument,iterations,samples,mean_ns,stddev_ns,min_ns,max_ns,"
+           "median_ns,p90_ns,p99_ns,median_ci_low_ns,median_ci_high_ns,gflops,gbps";
+    for (const auto& metric : metric_names) {
+        out << "," << metric;
+    }
+    out << "\n";
+    for (const auto& r : results) {
+        out << std::format("\"{}\",{},{},{},{},{},{},{},{},{},{},{},{},{},{}",
+            r.name, r.argument, r.iterations, r.samples_ns.size(), r.mean, r.stddev, r.min, r.max,
+            r.median, r.p90, r.p99, r.median_ci_low, r.median_ci_high, r.gflops, r.gbps);
+        for (const auto& metric : metric_names) {
+            auto it = std::find_if(r.metrics.begin(), r.metrics.end(),
+                [&](const auto& m) { return m.first == metric; });
+            out << ",";
+            if (it != r.metrics.end()) out << it->second;
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+static void writeText(const std::string& file_name, const std::string& text) {
+    std::ofstream file(file_name);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Could not open file: {}", file_name));
+    }
+    file << text;
+}
+
+void writeJson(const std::string& file_name, const std::vector<BenchmarkResult>& results) {
+    writeText(file_name, toJson(results));
+}
+
+void writeCsv(const std::string& file_name, const std::vector<BenchmarkResult>& results) {
+    writeText(file_name, toCsv(results));
+}
+
+
+// Legacy API
 void benchmark(const std::vector<std::pair<std::string, std::function<void()>>>
                    &operations,
                int iterations, bool show_fastest) {
-    
-    std::vector<std::pair<std::string, long long>> results;
-    
-    // Run each operation and measure time
+    BenchmarkOptions options;
+    options.iterations = iterations > 0 ? static_cast<size_t>(iterations) : 1;
+    options.warmup_ms = 10;
+    options.samples = 10;
+
+    std::vector<BenchmarkResult> results;
+    results.reserve(operations.size());
     for (const auto& [name, operation] : operations) {
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int i = 0; i < iterations; ++i) {
-            operation();
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-        results.emplace_back(name, duration);
-        std::cout << name << ":  " << duration << " ns\n";
+        results.push_back(runBenchmark(name, operation, options));
     }
-    
+    printResults(results);
+
     // Find fastest operation
-    if (show_fastest && !results.empty()) {
-        auto fastest = std::min_element(results.begin(), results.end(),
-            [](const auto& a, const auto& b) { return a.second < b.second; });
-        std::cout << "\n[Fastest: " << fastest->first << "]\n\n";
-        
-        // Show speedups relative to fastest
-        for (const auto& [name, duration] : results) {
-            if (name != fastest->first && fastest->second > 0) {
-                double speedup = static_cast<double>(duration) / fastest->second;
-                std::cout << fastest->first << " is " << speedup << "x faster than " << name << "\n";
-            }
-        }
-        std::cout << "\n";
+    if (show_fastest) {
+        printComparison(results);
     }
-}
\ No newline at end of file
+}
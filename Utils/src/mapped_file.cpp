@@ -0,0 +1,114 @@
+#include <Utils/mapped_file.h>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& file_name) : file_name(file_name) {
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(std::format("Could not open file: {}", file_name));
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error(std::format("Could not map empty file: {}", file_name));
+    }
+    // PAGE_WRITECOPY + FILE_MAP_COPY: shared read-only pages, private copies on write
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        throw std::runtime_error(std::format("Could not map file: {}", file_name));
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if (!view) {
+        throw std::runtime_error(std::format("Could not map file: {}", file_name));
+    }
+    mapped = static_cast<std::byte*>(view);
+    mapped_size = static_cast<size_t>(size.QuadPart);
+}
+
+void MappedFile::unmap() {
+    if (mapped) UnmapViewOfFile(mapped);
+    mapped = nullptr;
+    mapped_size = 0;
+}
+
+#else
+MappedFile::MappedFile(const std::string& file_name) : file_name(file_name) {
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("Could not open file: {}", file_name));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error(std::format("Could not map empty file: {}", file_name));
+    }
+    // MAP_PRIVATE: shared read-only pages, private copies on write
+    void* view = ::mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        throw std::runtime_error(std::format("Could not map file: {}", file_name));
+    }
+    mapped = static_cast<std::byte*>(view);
+    mapped_size = static_cast<size_t>(info.st_size);
+}
+
+void MappedFile::unmap() {
+    if (mapped) ::munmap(mapped, mapped_size);
+    mapped = nullptr;
+    mapped_size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    mapped(std::exchange(other.mapped, nullptr)),
+    mapped_size(std::exchange(other.mapped_size, 0)),
+    file_name(std::move(other.file_name))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapped = std::exchange(other.mapped, nullptr);
+        mapped_size = std::exchange(other.mapped_size, 0);
+        file_name = std::move(other.file_name);
+    }
+    return *this;
+}
+
+std::byte* MappedFile::data() {
+    return mapped;
+}
+
+const std::byte* MappedFile::data() const {
+    return mapped;
+}
+
+size_t MappedFile::size() const {
+    return mapped_size;
+}
+
+const std::string& MappedFile::getFileName() const {
+    return file_name;
+}
@@ -0,0 +1,110 @@
+#include <Utils/parallel.h>
+#include <algorithm>
+
+
+namespace {
+    // Iterations a worker polls for new work (or a barrier release) before sleeping
+    constexpr size_t SPIN_LIMIT = 1 << 12;
+}
+
+WorkerPool::WorkerPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    this->threads.reserve(threads - 1);
+    for (size_t worker = 1; worker < threads; worker++) {
+        this->threads.emplace_back(&WorkerPool::workerLoop, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t WorkerPool::size() const {
+    return threads.size() + 1;
+}
+
+void WorkerPool::dispatch(Task task, void* context) {
+    if (threads.empty()) {
+        task(context, 0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = task;
+        this->context = context;
+        worker_error = nullptr;
+        pending.store(threads.size(), std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    wake.notify_all();
+
+    // The caller is worker 0
+    std::exception_ptr error;
+    try {
+        task(context, 0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    while (pending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    if (!error) {
+        error = worker_error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::workerLoop(size_t worker) {
+    size_t seen = 0;
+    while (true) {
+        size_t current = generation.load(std::memory_order_acquire);
+        for (size_t spin = 0; current == seen && spin < SPIN_LIMIT; spin++) {
+            if (stopping.load(std::memory_order_acquire)) return;
+            std::this_thread::yield();
+            current = generation.load(std::memory_order_acquire);
+        }
+        if (current == seen) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() {
+                return stopping.load(std::memory_order_relaxed) || generation.load(std::memory_order_relaxed) != seen;
+            });
+            if (stopping.load(std::memory_order_relaxed)) return;
+            current = generation.load(std::memory_order_acquire);
+        }
+        seen = current;
+
+        try {
+            task(context, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!worker_error) {
+                worker_error = std::current_exception();
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void WorkerPool::barrier() {
+    size_t round = barrier_generation.load(std::memory_order_acquire);
+    if (barrier_count.fetch_add(1, std::memory_order_acq_rel) + 1 == size()) {
+        // Last to arrive: reset for the next barrier and release the others
+        barrier_count.store(0, std::memory_order_relaxed);
+        barrier_generation.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    while (barrier_generation.load(std::memory_order_acquire) == round) {
+        std::this_thread::yield();
+    }
+}
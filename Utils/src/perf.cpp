@@ -0,0 +1,229 @@
+#include <Utils/perf.h>
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdint>
+#endif
+
+
+// PerfReading
+bool PerfReading::has(PerfEvent event) const {
+    return available[static_cast<size_t>(event)];
+}
+
+double PerfReading::get(PerfEvent event) const {
+    return has(event) ? values[static_cast<size_t>(event)] : 0.0;
+}
+
+double PerfReading::ipc() const {
+    if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || get(PerfEvent::CYCLES) == 0) {
+        return 0;
+    }
+    return get(PerfEvent::INSTRUCTIONS) / get(PerfEvent::CYCLES);
+}
+
+double PerfReading::mpki(PerfEvent event) const {
+    if (!has(event) || !has(PerfEvent::INSTRUCTIONS) || get(PerfEvent::INSTRUCTIONS) == 0) {
+        return 0;
+    }
+    return 1000.0 * get(event) / get(PerfEvent::INSTRUCTIONS);
+}
+
+std::vector<std::pair<std::string, double>> PerfReading::metrics(size_t iterations) const {
+    std::vector<std::pair<std::string, double>> result;
+    double n = iterations > 0 ? static_cast<double>(iterations) : 1.0;
+    if (has(PerfEvent::CYCLES) && has(PerfEvent::INSTRUCTIONS)) {
+        result.emplace_back("ipc", ipc());
+    }
+    if (has(PerfEvent::CYCLES)) result.emplace_back("cycles/iter", get(PerfEvent::CYCLES) / n);
+    if (has(PerfEvent::INSTRUCTIONS)) result.emplace_back("instructions/iter", get(PerfEvent::INSTRUCTIONS) / n);
+    if (has(PerfEvent::INSTRUCTIONS)) {
+        if (has(PerfEvent::L1D_MISSES)) result.emplace_back("l1d_mpki", mpki(PerfEvent::L1D_MISSES));
+        if (has(PerfEvent::LLC_MISSES)) result.emplace_back("llc_mpki", mpki(PerfEvent::LLC_MISSES));
+        if (has(PerfEvent::BRANCH_MISSES)) result.emplace_back("branch_mpki", mpki(PerfEvent::BRANCH_MISSES));
+    }
+    if (has(PerfEvent::FP_VECTOR_OPS)) result.emplace_back("fp_vector_ops/iter", get(PerfEvent::FP_VECTOR_OPS) / n);
+    return result;
+}
+
+
+// PerfCounters
+#if defined(__linux__)
+
+static bool isIntelCpu() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_is("intel");
+#else
+    return false;
+#endif
+}
+
+static bool eventAttributes(PerfEvent event, perf_event_attr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (event) {
+        case PerfEvent::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PerfEvent::LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfEvent::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfEvent::FP_VECTOR_OPS:
+            // FP_ARITH_INST_RETIRED (0xC7), umask 0x3C: 128/256-bit packed single and double
+            if (!isIntelCpu()) return false;
+            attr.type = PERF_TYPE_RAW;
+            attr.config = 0x3CC7;
+            break;
+        default:
+            return false;
+    }
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return true;
+}
+
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+    for (size_t e = 0; e < fds.size(); e++) {
+        perf_event_attr attr;
+        if (!eventAttributes(static_cast<PerfEvent>(e), attr)) {
+            continue;
+        }
+        // Calling thread, any CPU, no group: each event succeeds or fails on its own
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            if (error.empty()) {
+                error = std::format("perf_event_open({}) failed: {}", getName(static_cast<PerfEvent>(e)), std::strerror(errno));
+            }
+            continue;
+        }
+        fds[e] = static_cast<int>(fd);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void PerfCounters::start() {
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCounters::stop() {
+    for (int fd : fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+PerfReading PerfCounters::read() const {
+    PerfReading reading;
+    for (size_t e = 0; e < fds.size(); e++) {
+        if (fds[e] < 0) continue;
+        // {value, time_enabled, time_running}
+        uint64_t data[3] = {0, 0, 0};
+        if (::read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        double value = static_cast<double>(data[0]);
+        // Scale up when the kernel multiplexed this counter
+        if (data[2] > 0 && data[2] < data[1]) {
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        reading.values[e] = value;
+        reading.available[e] = data[2] > 0 || data[1] == 0;
+    }
+    return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() : error("Hardware counters require Linux perf_event_open") {
+    fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {
+}
+
+void PerfCounters::start() {
+}
+
+void PerfCounters::stop() {
+}
+
+PerfReading PerfCounters::read() const {
+    return PerfReading();
+}
+
+#endif
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+bool PerfCounters::isAvailable(PerfEvent event) const {
+    return fds[static_cast<size_t>(event)] >= 0;
+}
+
+const std::string& PerfCounters::getError() const {
+    return error;
+}
+
+std::string PerfCounters::getName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES: return "cycles";
+        case PerfEvent::INSTRUCTIONS: return "instructions";
+        case PerfEvent::L1D_MISSES: return "l1d_misses";
+        case PerfEvent::LLC_MISSES: return "llc_misses";
+        case PerfEvent::BRANCH_MISSES: return "branch_misses";
+        case PerfEvent::FP_VECTOR_OPS: return "fp_vector_ops";
+        default: return "unknown";
+    }
+}
+
+
+// ScopedPerfRegion
+ScopedPerfRegion::ScopedPerfRegion(PerfCounters& counters, PerfReading& reading) :
+    counters(counters),
+    reading(reading)
+{
+    counters.start();
+}
+
+ScopedPerfRegion::~ScopedPerfRegion() {
+    counters.stop();
+    reading = counters.read();
+}
@@ -0,0 +1,156 @@
+#include <Utils/trace.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace {
+    struct ThreadBuffer {
+        std::vector<TraceEvent> events;  // Preallocated, never grows
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> dropped{0};
+        size_t thread_index = 0;
+        const char* thread_name = nullptr;
+    };
+
+    // Buffers are owned by the registry, so events survive the threads that produced them
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+    std::atomic<size_t> buffer_capacity{1 << 16};
+    const int64_t epoch_ns = trace_detail::now();
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            auto owned = std::make_unique<ThreadBuffer>();
+            owned->events.resize(buffer_capacity.load(std::memory_order_relaxed));
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            owned->thread_index = registry.size();
+            buffer = owned.get();
+            registry.push_back(std::move(owned));
+        }
+        return *buffer;
+    }
+
+    std::string escapeJson(const char* text) {
+        std::string escaped;
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') escaped += '\\';
+            escaped += *c;
+        }
+        return escaped;
+    }
+}
+
+std::atomic<bool> trace_detail::enabled{true};
+
+void trace_detail::record(const TraceEvent& event) {
+    ThreadBuffer& buffer = threadBuffer();
+    // Single producer: only this thread writes `count`, readers pair with the release store
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= buffer.events.size()) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = event;
+    buffer.events[index].start_ns -= epoch_ns;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+
+// Control
+void traceSetEnabled(bool enabled) {
+    trace_detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool traceIsEnabled() {
+    return trace_detail::enabled.load(std::memory_order_relaxed);
+}
+
+void traceSetBufferCapacity(size_t events) {
+    buffer_capacity.store(events, std::memory_order_relaxed);
+}
+
+void traceSetThreadName(const char* name) {
+    threadBuffer().thread_name = name;
+}
+
+void traceClear() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& buffer : registry) {
+        buffer->count.store(0, std::memory_order_release);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t traceEventCount() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    size_t total = 0;
+    for (auto& buffer : registry) {
+        total += buffer->count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+size_t traceDroppedCount() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    size_t total = 0;
+    for (auto& buffer : registry) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+
+// Export
+std::string toChromeTrace() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        const char* s = first ? "\n" : ",\n";
+        first = false;
+        return s;
+    };
+    for (auto& buffer : registry) {
+        size_t tid = buffer->thread_index;
+        std::string thread_name = buffer->thread_name
+            ? escapeJson(buffer->thread_name)
+            : std::format("Thread {}", tid);
+        out << separator() << std::format(
+            "{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{\"name\": \"{}\"}}}}",
+            tid, thread_name);
+
+        // Timestamps and durations are in microseconds in the Chrome format
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const TraceEvent& e = buffer->events[i];
+            std::string name = escapeJson(e.name);
+            out << separator();
+            if (e.id >= 0) {
+                out << std::format(
+                    "{{\"name\": \"{} [{}]\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}, \"args\": {{\"id\": {}}}}}",
+                    name, e.id, tid, e.start_ns / 1e3, e.duration_ns / 1e3, e.id);
+            } else {
+                out << std::format(
+                    "{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+                    name, tid, e.start_ns / 1e3, e.duration_ns / 1e3);
+            }
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+void writeChromeTrace(const std::string& file_name) {
+    std::ofstream file(file_name);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Could not open file: {}", file_name));
+    }
+    file << toChromeTrace();
+}
@@ -19,6 +19,7 @@ $flags = @(
     "-Wall", 
     # "-Wextra",
     # "-O3",
+    "-fno-math-errno", # No errno from sqrt: lets the fused optimizer passes vectorize
     "-fcolor-diagnostics", 
     "-fansi-escape-codes",
     "-g",
@@ -1,11 +1,30 @@
 #include <CustomNeuralNetwork/NN.h>
 #include <CustomNeuralNetwork/DenseLayer.h>
+#include <CustomNeuralNetwork/InferenceSession.h>
+#include <CustomNeuralNetwork/DynamicBatcher.h>
+#include <CustomNeuralNetwork/FrozenNN.h>
+#include <CustomNeuralNetwork/QuantizedNN.h>
+#include <CustomNeuralNetwork/ParameterArena.h>
+#include <CustomNeuralNetwork/DataPipeline.h>
+#include <CustomNeuralNetwork/ModelFormat.h>
 #include <CustomNeuralNetwork/ActivationFunctions/ActivationFunctions.h>
 #include <CustomNeuralNetwork/InitializationFunctions/InitializationFunctions.h>
 #include <CustomNeuralNetwork/LossFunctions/LossFunctions.h>
 #include <CustomNeuralNetwork/Optimizers/Optimizers.h>
 #include <utils.h>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <future>
+#include <filesystem>
+#include <fstream>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
 
 void testLinearAlgebra() {
     Matrix W1 ({ // 4x3
@@ -30,6 +49,30 @@ void testLinearAlgebra() {
 }
 
 
+bool testMatrixViews() {
+    // std::vector<Matrix> moves its elements on reallocation only if move-assignment cannot throw
+    static_assert(std::is_nothrow_move_assignable_v<Matrix> && std::is_nothrow_move_constructible_v<Matrix>);
+    std::vector<float> buffer(6, 0.0f);
+    Matrix view = Matrix::view(buffer.data(), 2, 3);
+    view.copyFrom(Matrix({{1, 2, 3}, {4, 5, 6}}));
+    bool passed = view.isView() && buffer[5] == 6.0f;
+
+    bool threw = false;
+    try {
+        (void)view.getElements();
+    } catch (const linalg::MatrixError &) {
+        threw = true;
+    }
+    passed = passed && threw;
+
+    // Assignment replaces the view and leaves the borrowed buffer alone
+    view = Matrix(2, 3);
+    passed = passed && !view.isView() && buffer[5] == 6.0f && view.getElements().size() == 6;
+    print(passed ? "Matrix views: passed\n" : "Matrix views: FAILED\n");
+    return passed;
+}
+
+
 void testLayer() {
     DenseLayer L1(2,2,1);
     DenseLayer L2(2,1,2);
@@ -51,21 +94,56 @@ void testLayer() {
 }
 
 
-void testSaveLoad() {
+bool testSaveLoad() {
     int input_dim = 5;
     int hidden_layers = 2;
     int hidden_layers_dim = 2;
     int output_dim = 1;
+    // Built without a problem type: the text format must still round-trip every field
     NN model("SaveLoadTest", input_dim, hidden_layers, hidden_layers_dim, output_dim);
     model.setInitializationFunction(RANDOM);
     model.setActivationFunction(SIGMOID);
     model.setLossFunction(MSE);
     model.setOptimizer(SGD);
     model.initialize();
+    Vector x({0.1f, -0.2f, 0.3f, -0.4f, 0.5f});
+    float expected = model.predict(x)[0];
     model.save("SaveLoadTest.txt");
     model = NN();
     model.load("SaveLoadTest.txt");
     model.print();
+    bool passed = model.getInputSize() == input_dim && model.getOutputSize() == output_dim
+        && model.predict(x)[0] == expected;
+    print(passed ? "Text save/load: passed\n" : "Text save/load: FAILED\n");
+
+    // AdamW hyperparameters survive both formats instead of falling back to the ADAMW defaults
+    std::vector<float> hyperparameters = {0.8f, 0.99f, 1e-7f, 0.05f};
+    model.setOptimizer(std::make_unique<AdaptativeMomentOptimizer>(1e-3f, 0.8f, 0.99f, 1e-7f, 0.05f), 1e-3f);
+    for (const std::string file_name : {"SaveLoadTest.txt", "SaveLoadTest.cnn"}) {
+        model.save(file_name);
+        NN loaded;
+        loaded.load(file_name);
+        bool restored = loaded.getOptimizer()->getName() == "ADAMW"
+            && loaded.getOptimizer()->getHyperparameters() == hyperparameters;
+        print(std::format("{} optimizer hyperparameters: {}\n", file_name, restored ? "passed" : "FAILED"));
+        passed = passed && restored;
+    }
+
+    // The checksum covers the header: a corrupted hyperparameter must not load
+    {
+        std::fstream file("SaveLoadTest.cnn", std::ios::in | std::ios::out | std::ios::binary);
+        float corrupted = 0.5f;
+        file.seekp(offsetof(ModelFileHeader, optimizer_hyperparameters));
+        file.write(reinterpret_cast<const char*>(&corrupted), sizeof(corrupted));
+    }
+    bool rejected = false;
+    try {
+        NN().load("SaveLoadTest.cnn");
+    } catch (const std::runtime_error &) {
+        rejected = true;
+    }
+    print(rejected ? "Corrupted header: passed\n" : "Corrupted header: FAILED\n");
+    return passed && rejected;
 }
 
 
@@ -119,6 +197,7 @@ void xorNetwork() {
     // model.setOptimizer(SGD, learning_rate);
     // model.initialize();
     // model.print(); print("\n");
+    // model.setEarlyStopping({.patience = 1000, .min_delta = 1e-7f, .target_loss = 1e-4f});
     // model.fit(x_train, y_train, epochs);
     // model.save("models/XorModel.txt");
 
@@ -160,12 +239,1171 @@ void testEvaluate() {
 }
 
 
+bool testConcurrentInference() {
+    // One shared, read-only model; every thread predicts through its own session
+    NN model = NN();
+    model.load("models/XorModel.txt");
+    const NN &shared = model;
+    Matrix inputs = Matrix::random(1000, 2);
+
+    InferenceSession reference(shared);
+    Matrix expected(1000, 1);
+    for (size_t i = 0; i < 1000; i++) {
+        expected.setElement(reference.predict(inputs.getRow(i))[0], i, 0);
+    }
+
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 8; t++) {
+        workers.emplace_back([&]() {
+            InferenceSession session(shared);
+            for (size_t repeat = 0; repeat < 10; repeat++) {
+                for (size_t i = 0; i < 1000; i++) {
+                    if (session.predict(inputs.getRow(i))[0] != expected.getElement(i, 0)) {
+                        mismatches.fetch_add(1);
+                    }
+                }
+                const Matrix &batch = session.predictBatch(inputs);
+                for (size_t i = 0; i < 1000; i++) {
+                    if (std::abs(batch.getElement(i, 0) - expected.getElement(i, 0)) > 1e-5f) {
+                        mismatches.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    bool passed = mismatches.load() == 0;
+    print(passed ? "Concurrent inference: passed\n" : "Concurrent inference: FAILED\n");
+    return passed;
+}
+
+
+void benchmarkLinearAlgebra() {
+    // Hardware counters are optional: without perf access only timings are reported
+    PerfCounters counters;
+    if (!counters.isAvailable()) {
+        print("Hardware counters unavailable: ", counters.getError(), "\n");
+    }
+    BenchmarkOptions options;
+    options.cpu = 0;
+
+    // Square products: 2n^3 flops, 3 matrices of n^2 floats touched
+    std::vector<BenchmarkResult> results;
+    for (size_t n : geometricRange(32, 256)) {
+        Matrix A = Matrix::random(n, n);
+        Matrix B = Matrix::random(n, n);
+        options.flops = 2.0*n*n*n;
+        options.bytes = 3.0*n*n*sizeof(float);
+        results.push_back(runBenchmarkWithCounters(std::format("Matrix::dot/{}", n),
+            [&]() { doNotOptimize(A.dot(B)); }, counters, options));
+        results.back().argument = n;
+    }
+
+    options.flops = options.bytes = 0;
+    Matrix M = Matrix::random(512, 512);
+    results.push_back(runBenchmarkWithCounters("Matrix::transpose/512",
+        [&]() { M.transpose(); clobberMemory(); }, counters, options));
+
+    printResults(results);
+    writeJson("benchmark_linalg.json", results);
+    writeCsv("benchmark_linalg.csv", results);
+}
+
+void benchmarkTraining() {
+    PerfCounters counters;
+    Matrix x_train = Matrix::random(256, 16);
+    Matrix y_train = Matrix::random(256, 1);
+    NN model(16, 2, 32, 1, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+
+    // One iteration = one epoch over 256 samples
+    BenchmarkOptions options;
+    options.cpu = 0;
+    options.iterations = 1;
+    options.samples = 10;
+    options.warmup_ms = 0;
+    auto result = runBenchmarkWithCounters("NN::fit/epoch",
+        [&]() { model.fit(x_train, y_train, 1, 1); }, counters, options);
+    printResults({result});
+}
+
+
+void benchmarkOptimizers() {
+    // y = mean_k sin(3 u_k), but feature k is fed as u_k * 2^k: unnormalized inputs on very different
+    // scales, where one SGD learning rate is too large for some weights and too small for others
+    size_t inputs = 8, samples = 1024, epochs = 30;
+    float target_loss = 2e-2f;
+    Matrix x_train = Matrix::random(samples, inputs, -1.0f, 1.0f);
+    Matrix y_train(samples, 1);
+    for (size_t i = 0; i < samples; i++) {
+        float y = 0;
+        for (size_t k = 0; k < inputs; k++) {
+            y += std::sin(3.0f * x_train.getElement(i, k));
+            x_train.setElement(x_train.getElement(i, k) * float(1 << k), i, k);
+        }
+        y_train.setElement(y / inputs, i, 0);
+    }
+
+    struct Candidate {
+        std::string name;
+        std::function<std::unique_ptr<BaseOptimizer>()> make;
+        float learning_rate;
+    };
+    std::vector<Candidate> candidates = {
+        {"SGD", []() -> std::unique_ptr<BaseOptimizer> { return SGD; }, 1e-2f},
+        {"ADAM", []() -> std::unique_ptr<BaseOptimizer> { return ADAM; }, 1e-3f},
+        {"ADAMW", []() -> std::unique_ptr<BaseOptimizer> { return ADAMW; }, 1e-3f},
+    };
+    for (const Candidate &candidate : candidates) {
+        NN model(inputs, 1, "REGRESSION");
+        DenseLayer hidden1(inputs, 64, RELU, 1);
+        DenseLayer hidden2(64, 64, RELU, 2);
+        DenseLayer output(64, 1, LINEAR, 3);
+        model.addLayer(hidden1);
+        model.addLayer(hidden2);
+        model.addLayer(output);
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(candidate.make(), candidate.learning_rate);
+        model.initialize();
+
+        size_t reached = 0;
+        float last_loss = 0;
+        model.setEpochCallback([&](size_t epoch, float loss) {
+            if (!reached && loss < target_loss) reached = epoch + 1;
+            last_loss = loss;
+        });
+        auto start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, 1, 32);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<6} final loss {:.2e} | epochs to loss < {:.0e}: {} | {:.2f} ms/epoch\n",
+            candidate.name, last_loss, target_loss, reached ? std::to_string(reached) : "-", ms / epochs));
+    }
+}
+
+
+void benchmarkParameterArena() {
+    // Deep, narrow network: many small tensors, where per-tensor optimizer calls add up
+    size_t inputs = 32, width = 32, hidden = 12, batch = 16;
+    Matrix x_batch = Matrix::random(batch, inputs);
+    Matrix y_batch = Matrix::random(batch, 4);
+    auto build = [&]() {
+        auto model = std::make_unique<NN>("arena", inputs, 4, "REGRESSION");
+        for (size_t l = 0; l < hidden; l++) {
+            DenseLayer layer(l == 0 ? inputs : width, width, RELU, l + 1);
+            model->addLayer(layer);
+        }
+        DenseLayer output(width, 4, LINEAR, hidden + 1);
+        model->addLayer(output);
+        model->setInitializationFunction(XAVIER);
+        model->setLossFunction(MSE);
+        model->setOptimizer(ADAMW, 1e-3f);
+        return model;
+    };
+    // Same initial parameters: one model updates tensor by tensor, the other binds an arena
+    std::unique_ptr<NN> per_tensor = build(), flat = build();
+    per_tensor->initialize();
+    for (size_t l = 0; l < per_tensor->getLayers().size(); l++) {
+        const DenseLayer &source = per_tensor->getLayers()[l];
+        flat->getLayers()[l].setParamenters(Matrix(source.getWeights()), Vector(source.getBiases()));
+    }
+    ParameterArena &arena = flat->getParameterArena();
+    arena.bind(flat->getLayers());
+
+    auto step = [&](NN &model) {
+        model.forwardBatch(x_batch);
+        model.backwardBatch(y_batch);
+    };
+    for (int i = 0; i < 100; i++) {
+        step(*per_tensor);
+        step(*flat);
+    }
+    float max_error = 0;
+    for (size_t l = 0; l < flat->getLayers().size(); l++) {
+        const Matrix &a = per_tensor->getLayers()[l].getWeights();
+        const Matrix &b = flat->getLayers()[l].getWeights();
+        for (size_t i = 0; i < a.getShape().N; i++) {
+            max_error = std::max(max_error, std::abs(a[i] - b[i]));
+        }
+    }
+    print(std::format("{} tensors in {} floats ({} weights) | max |per-tensor - arena| after 100 steps = {:.2e}\n",
+        2 * flat->getLayers().size(), arena.getSize(), arena.getWeightCount(), max_error));
+
+    // Checkpoint: one copy of the arena against one copy per tensor
+    std::vector<float> snapshot;
+    std::vector<std::pair<Matrix, Vector>> copies(per_tensor->getLayers().size());
+    BenchmarkOptions options;
+    options.cpu = 0;
+    // The optimizer alone, on the gradients of the last step
+    std::unique_ptr<BaseOptimizer> per_tensor_optimizer = ADAMW, arena_optimizer = ADAMW;
+    std::vector<BenchmarkResult> steps = {
+        runBenchmark("AdamW step, per tensor", [&]() {
+            for (DenseLayer &layer : per_tensor->getLayers()) {
+                per_tensor_optimizer->update(layer.getWeights(), layer.getBiases(), layer.getWeightsGradient(), layer.getBiasesGradient());
+            }
+        }, options),
+        runBenchmark("AdamW step, arena", [&]() { arena_optimizer->update(arena.getSpan()); }, options),
+        runBenchmark("training step, per-tensor update", [&]() { step(*per_tensor); }, options),
+        runBenchmark("training step, arena update", [&]() { step(*flat); }, options),
+    };
+    std::vector<BenchmarkResult> checkpoints = {
+        runBenchmark("checkpoint, per tensor", [&]() {
+            for (size_t l = 0; l < copies.size(); l++) {
+                copies[l].first = per_tensor->getLayers()[l].getWeights();
+                copies[l].second = per_tensor->getLayers()[l].getBiases();
+            }
+            doNotOptimize(copies[0].first[0]);
+        }, options),
+        runBenchmark("checkpoint, arena", [&]() { arena.snapshot(snapshot); doNotOptimize(snapshot[0]); }, options),
+    };
+    printResults(steps);
+    printComparison(steps);
+    printResults(checkpoints);
+    printComparison(checkpoints);
+}
+
+
+void benchmarkGradientAccumulation() {
+    // Per-sample training: a rank-1 weight update after every sample reads and writes each weight
+    // matrix once per sample. Accumulating K samples applies one rank-K product and one step instead.
+    size_t inputs = 64, width = 256, outputs = 8, samples = 2048, epochs = 3;
+    Matrix x_train = Matrix::random(samples, inputs);
+    Matrix y_train = Matrix::random(samples, outputs);
+    auto build = [&](const NN *source) {
+        auto model = std::make_unique<NN>("accumulation", inputs, outputs, "REGRESSION");
+        DenseLayer hidden1(inputs, width, RELU, 1);
+        DenseLayer hidden2(width, width, RELU, 2);
+        DenseLayer output(width, outputs, LINEAR, 3);
+        model->addLayer(hidden1);
+        model->addLayer(hidden2);
+        model->addLayer(output);
+        model->setInitializationFunction(XAVIER);
+        model->setLossFunction(MSE);
+        model->setOptimizer(SGD, 0.05f);
+        model->initialize();
+        // Same initial parameters for every configuration
+        for (size_t l = 0; source && l < source->getLayers().size(); l++) {
+            const DenseLayer &layer = source->getLayers()[l];
+            model->getLayers()[l].setParamenters(Matrix(layer.getWeights()), Vector(layer.getBiases()));
+        }
+        return model;
+    };
+    std::unique_ptr<NN> reference = build(nullptr);
+
+    struct Configuration {
+        size_t batch_size;
+        size_t steps;
+    };
+    std::vector<Configuration> configurations = {{1, 1}, {1, 16}, {1, 64}, {16, 1}, {4, 4}, {64, 1}, {16, 4}};
+    for (const Configuration &configuration : configurations) {
+        std::unique_ptr<NN> model = build(reference.get());
+        model->setGradientAccumulation(configuration.steps);
+        auto start = std::chrono::steady_clock::now();
+        model->fit(x_train, y_train, epochs, 1, configuration.batch_size);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("batch {:>2} x {:>2} steps (effective {:>2}): {:>8.2f} ms/epoch | final loss {:.6f}\n",
+            configuration.batch_size, configuration.steps, configuration.batch_size * configuration.steps,
+            ms / epochs, model->getLossHistory().back()));
+    }
+}
+
+
+// Custom activation: only the scalar call() and grad(); its buffer passes call them per element
+class SoftplusActivationFunction : public BaseActivationFunction {
+public:
+    SoftplusActivationFunction() : BaseActivationFunction(ActivationType::Custom) {}
+    std::string getName() const override { return "SOFTPLUS"; }
+    float call(float x) const override { return std::log1p(std::exp(x)); }
+    float grad(float x) const override { return 1.0f / (1.0f + std::exp(-x)); }
+    using BaseActivationFunction::call;
+    using BaseActivationFunction::grad;
+};
+
+// Written against the original API: default constructor, not registered
+class LeakyReLUActivationFunction : public BaseActivationFunction {
+public:
+    std::string getName() const override { return "LEAKY_RELU"; }
+    float call(float x) const override { return x > 0 ? x : 0.1f * x; }
+    float grad(float x) const override { return x > 0 ? 1.0f : 0.1f; }
+    using BaseActivationFunction::call;
+    using BaseActivationFunction::grad;
+};
+
+bool testCustomActivation() {
+    // Untagged subclasses must run their own call()/grad() in the fused buffer passes
+    DenseLayer layer(2, 2, std::make_unique<LeakyReLUActivationFunction>(), 1);
+    layer.setParamenters(Matrix({{1.0f, -2.0f}, {0.5f, 1.0f}}), Vector{0.0f, -1.0f});
+    Vector x{1.0f, 1.0f};
+    const Vector &y = layer.forward(x); // z = (-1, 0.5)
+    bool passed = layer.getActivationFunction()->getType() == ActivationType::Custom
+        && std::abs(y[0] + 0.1f) < 1e-6f && std::abs(y[1] - 0.5f) < 1e-6f;
+    layer.backward(Vector{1.0f, 1.0f});
+    passed = passed && std::abs(layer.getDelta()[0] - 0.1f) < 1e-6f && std::abs(layer.getDelta()[1] - 1.0f) < 1e-6f;
+    const Matrix &batch = layer.forwardBatch(Matrix({{1.0f, 1.0f}, {2.0f, 0.0f}})); // z = (-1, 0.5), (2, 0)
+    passed = passed && std::abs(batch.getElement(0, 0) + 0.1f) < 1e-6f && std::abs(batch.getElement(1, 0) - 2.0f) < 1e-6f
+        && std::abs(batch.getElement(0, 1) - 0.5f) < 1e-6f && batch.getElement(1, 1) == 0.0f;
+    print(passed ? "Custom activation: passed\n" : "Custom activation: FAILED\n");
+    return passed;
+}
+
+void benchmarkActivationDispatch() {
+    // Before: call(Matrix) and backward through a custom activation made a virtual call per element.
+    // The built-ins now resolve their tag once per buffer and run the inlined epilogue stage.
+    size_t rows = 256, cols = 1024, repeats = 20;
+    Matrix z = Matrix::random(rows, cols);
+    Matrix out(rows, cols), delta(rows, cols);
+    auto time = [&](auto &&body) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats; r++) body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+    };
+
+    std::vector<std::unique_ptr<BaseActivationFunction>> functions;
+    functions.push_back(RELU);
+    functions.push_back(SIGMOID);
+    functions.push_back(TANH);
+    for (const auto &function : functions) {
+        const BaseActivationFunction &f = *function;
+        double virtual_call = time([&] { linalg::transformInto(z, out, [&f](float v) { return f.call(v); }); });
+        double dispatched_call = time([&] { f.callInto(z, out); });
+        double virtual_grad = time([&] { linalg::transformInto(z, delta, [&f](float v) { return f.grad(v); }); });
+        double dispatched_grad = time([&] { f.gradInto(z, delta); });
+        print(std::format("{:<8} call: {:>7.3f} -> {:>7.3f} ms ({:.1f}x) | grad: {:>7.3f} -> {:>7.3f} ms ({:.1f}x)\n",
+            f.getName(), virtual_call, dispatched_call, virtual_call / dispatched_call,
+            virtual_grad, dispatched_grad, virtual_grad / dispatched_grad));
+    }
+
+    // A registered custom activation round-trips through a model file
+    registerActivationFunction("SOFTPLUS", [] { return std::make_unique<SoftplusActivationFunction>(); });
+    NN model("Softplus", 8, 2, "REGRESSION");
+    DenseLayer hidden(8, 16, std::make_unique<SoftplusActivationFunction>(), 1);
+    DenseLayer output(16, 2, LINEAR, 2);
+    model.addLayer(hidden);
+    model.addLayer(output);
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.05f);
+    model.initialize();
+    model.fit(Matrix::random(64, 8), Matrix::random(64, 2), 5, 5);
+    model.save("models/SoftplusModel.cnn");
+    NN loaded;
+    loaded.load("models/SoftplusModel.cnn");
+    Vector x(8);
+    Matrix sample = Matrix::random(1, 8);
+    std::copy(sample.getRow(0), sample.getRow(0) + 8, x.data());
+    InferenceSession trained(model), reloaded(loaded);
+    const Vector &expected = trained.predict(x);
+    const Vector &actual = reloaded.predict(x);
+    bool same = loaded.getLayers()[0].getActivationFunction()->getName() == "SOFTPLUS";
+    for (size_t i = 0; i < expected.getSize(); i++) {
+        same = same && expected[i] == actual[i];
+    }
+    print(same ? "Custom activation reloaded\n" : "Custom activation DIFFERS after reload\n");
+    std::filesystem::remove("models/SoftplusModel.cnn");
+}
+
+void benchmarkActivationGradients() {
+    // Training step of one layer: storing z and differentiating from it evaluates sigmoid/tanh twice
+    // per element; the fused forward writes dy/dz from y in the same pass and backward only multiplies
+    size_t batch = 512, inputs = 8, width = 1024, repeats = 20;
+    Matrix x = Matrix::random(batch, inputs);
+    Matrix w = Matrix::random(width, inputs);
+    Vector b(width);
+    Matrix upstream = Matrix::random(batch, width);
+    Matrix y, z, cache, delta, expected_delta;
+    auto time = [&](auto &&body) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats; r++) body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+    };
+    auto compare = [&](const std::unique_ptr<BaseActivationFunction> &function, auto act) {
+        double from_z = time([&] {
+            Matrix::dotTransposedFusedInto(x, w, y, linalg::epilogue::ColBias<float>{b.data()}, act, &z);
+            linalg::transformInto(z, upstream, expected_delta, [act](float v, float g) { return g * act.grad(v); });
+        });
+        double fused = time([&] {
+            function->forwardDenseBatch(x, w, b, y, &cache);
+            function->backwardInto(cache, upstream, delta);
+        });
+        float error = 0.0f;
+        for (size_t i = 0; i < delta.getShape().N; i++) {
+            error = std::max(error, std::abs(delta.data()[i] - expected_delta.data()[i]));
+        }
+        print(std::format("{:<8} forward + backward: {:>7.3f} ms (grad from z) -> {:>7.3f} ms (fused dy/dz) ({:.2f}x) | max error {:.1e}\n",
+            function->getName(), from_z, fused, from_z / fused, error));
+    };
+    compare(SIGMOID, linalg::epilogue::Sigmoid{});
+    compare(TANH, linalg::epilogue::Tanh{});
+    compare(RELU, linalg::epilogue::ReLU{});
+}
+
+void benchmarkCrossEntropy() {
+    // Multi-class blobs: sigmoid outputs trained on MSE against a LINEAR output trained on CROSS_ENTROPY
+    size_t classes = 8, features = 16, samples = 2048, epochs = 30, batch = 32;
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    Matrix centers = Matrix::random(classes, features);
+    Matrix x_train(samples, features), y_train(samples, classes);
+    for (size_t i = 0; i < samples; i++) {
+        size_t c = i % classes;
+        for (size_t j = 0; j < features; j++) {
+            x_train.setElement(centers.getElement(c, j) + 0.35f * noise(rng), i, j);
+        }
+        y_train.setElement(1.0f, i, c);
+    }
+
+    auto train = [&](const std::string &name, std::unique_ptr<BaseActivationFunction> output_activation,
+                     std::unique_ptr<BaseLossFunction> loss) {
+        NN model(name, features, classes, "CLASSIFICATION");
+        DenseLayer hidden(features, 64, RELU, 1);
+        DenseLayer output(64, classes, std::move(output_activation), 2);
+        model.addLayer(hidden);
+        model.addLayer(output);
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(std::move(loss));
+        model.setOptimizer(ADAM, 0.005f);
+        model.initialize();
+        size_t epochs_to_90 = 0;
+        model.setEpochCallback([&](size_t epoch, float) {
+            if (!epochs_to_90 && model.evaluate(x_train, y_train) >= 0.9f) epochs_to_90 = epoch + 1;
+        });
+        auto start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, 1, batch);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<24} accuracy {:.3f} | epochs to 90%: {:>3} | {:.2f} ms/epoch (incl. evaluation)\n",
+            name, model.evaluate(x_train, y_train), epochs_to_90 ? std::to_string(epochs_to_90) : "-", ms / epochs));
+    };
+    train("SIGMOID + MSE", SIGMOID, MSE);
+    train("LINEAR + CROSS_ENTROPY", LINEAR, CROSS_ENTROPY);
+
+    // The fused gradient matches central differences of the loss, and huge logits stay finite
+    Matrix logits = Matrix::random(4, classes);
+    Matrix targets(4, classes), grad;
+    for (size_t i = 0; i < 4; i++) targets.setElement(1.0f, i, (3 * i) % classes);
+    SoftmaxCrossEntropyLossFunction cross_entropy;
+    cross_entropy.valueAndGradInto(logits, targets, grad);
+    float max_error = 0.0f, h = 1e-2f;
+    for (size_t i = 0; i < logits.getShape().N; i++) {
+        float original = logits[i];
+        logits[i] = original + h;
+        float up = cross_entropy.value(logits, targets);
+        logits[i] = original - h;
+        float down = cross_entropy.value(logits, targets);
+        logits[i] = original;
+        max_error = std::max(max_error, std::abs((up - down) / (2 * h) - grad[i]));
+    }
+    Matrix extreme = logits * 1e4f;
+    float extreme_loss = cross_entropy.valueAndGradInto(extreme, targets, grad);
+    bool finite = std::isfinite(extreme_loss);
+    for (size_t i = 0; i < grad.getShape().N; i++) finite = finite && std::isfinite(grad[i]);
+    print(std::format("Gradient vs finite differences: {:.1e} | logits x 1e4: loss {:.3e}, {}\n",
+        max_error, extreme_loss, finite ? "finite" : "NOT FINITE"));
+
+    // A SOFTMAX output layer gives probabilities, also from the frozen plan
+    NN probabilities("Softmax", features, classes, "CLASSIFICATION");
+    DenseLayer hidden(features, 32, RELU, 1);
+    DenseLayer output(32, classes, SOFTMAX, 2);
+    probabilities.addLayer(hidden);
+    probabilities.addLayer(output);
+    probabilities.setInitializationFunction(XAVIER);
+    probabilities.setLossFunction(MSE);
+    probabilities.setOptimizer(ADAM, 0.005f);
+    probabilities.initialize();
+    probabilities.fit(x_train, y_train, 2, 1, batch);
+    FrozenNN frozen = probabilities.freeze();
+    InferenceSession session(probabilities);
+    const Matrix &expected = session.predictBatch(x_train);
+    const Matrix &actual = frozen.predictBatch(x_train);
+    float frozen_error = 0.0f, sum_error = 0.0f;
+    for (size_t i = 0; i < samples; i++) {
+        float total = 0.0f;
+        for (size_t j = 0; j < classes; j++) {
+            total += expected.getElement(i, j);
+            frozen_error = std::max(frozen_error, std::abs(expected.getElement(i, j) - actual.getElement(i, j)));
+        }
+        sum_error = std::max(sum_error, std::abs(total - 1.0f));
+    }
+    print(std::format("SOFTMAX output: max |sum - 1| = {:.1e}, max |frozen - session| = {:.1e}, accuracy {:.3f}\n",
+        sum_error, frozen_error, probabilities.evaluate(x_train, y_train)));
+}
+
+void traceTraining() {
+    // Build with -DENABLE_TRACING, then open the file in https://ui.perfetto.dev
+    Matrix x_train = Matrix::random(256, 16);
+    Matrix y_train = Matrix::random(256, 1);
+    NN model(16, 2, 32, 1, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+
+    traceSetThreadName("main");
+    model.fit(x_train, y_train, 5, 5);
+    writeChromeTrace("trace_fit.json");
+    print("Trace events: ", traceEventCount(), " (dropped: ", traceDroppedCount(), ")\n");
+}
+
+
+void profileAllocations() {
+    // Build with -DLINALG_INSTRUMENTATION to enable the counters
+    Matrix x_train = Matrix::random(256, 16);
+    Matrix y_train = Matrix::random(256, 1);
+    NN model(16, 2, 32, 1, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+
+    linalg::instrumentation::ScopedSnapshot counters;
+    model.fit(x_train, y_train, 1, 1);
+    auto epoch = counters.delta();
+    print("One epoch: ", epoch.toString(), "\n");
+    print("Allocations per sample: ", epoch.allocationsPer(x_train.getShape().rows), "\n");
+}
+
+
+void benchmarkParallelTraining() {
+    // Samples/second of data-parallel mini-batch training for growing thread counts
+    Matrix x_train = Matrix::random(8192, 64);
+    Matrix y_train = Matrix::random(8192, 8);
+    size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<BenchmarkResult> results;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        NN model(64, 2, 256, 8, "REGRESSION");
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(SGD, 0.01f);
+        model.initialize();
+        model.setThreads(threads);
+
+        BenchmarkOptions options;
+        options.iterations = 1;
+        options.samples = 5;
+        options.warmup_ms = 0;
+        auto result = runBenchmark(std::format("NN::fit/threads={}", threads),
+            [&]() { model.fit(x_train, y_train, 1, 1, 256); }, options);
+        result.metrics.emplace_back("samples/s", x_train.getShape().rows / (result.median * 1e-9));
+        results.push_back(result);
+    }
+    printResults(results);
+}
+
+void benchmarkHogwild() {
+    // Sparse, wide regression problem: ~1% of the 1024 inputs are active in each sample
+    size_t samples = 4096, features = 1024, epochs = 5;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> feature(0, features - 1);
+    std::normal_distribution<float> teacher_weight(0.0f, 1.0f);
+    std::vector<float> teacher(features);
+    for (float &w : teacher) w = teacher_weight(generator);
+    Matrix x_train(samples, features);
+    Matrix y_train(samples, 1);
+    for (size_t i = 0; i < samples; i++) {
+        float target = 0;
+        for (size_t k = 0; k < features / 100; k++) {
+            size_t j = feature(generator);
+            x_train.setElement(1.0f, i, j);
+            target += teacher[j];
+        }
+        y_train.setElement(1.0f / (1.0f + std::exp(-target)), i, 0);
+    }
+
+    size_t threads = std::max<size_t>(2, std::thread::hardware_concurrency());
+    auto train = [&](const std::string &name, size_t model_threads, ParallelMode mode, size_t batch_size, float lr) {
+        NN model(features, 1, 64, 1, "REGRESSION");
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(SGD, lr);
+        model.initialize();
+        model.setThreads(model_threads, mode);
+        auto start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, epochs, batch_size);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<28} threads={:<3} samples/s={:<10.0f} final loss={:.5f}",
+            name, model_threads, epochs * samples / seconds, model.getLossHistory().back()));
+        if (mode == ParallelMode::HOGWILD) {
+            const AsyncEpochStats &last = model.getAsyncHistory().back();
+            print(std::format(" staleness mean={:.2f} max={}", last.mean_staleness, last.max_staleness));
+        }
+        print("\n");
+    };
+
+    print("\n");
+    train("Serial SGD (batch 1)", 1, ParallelMode::SYNCHRONOUS, 1, 0.1f);
+    train("Synchronous (batch 32)", threads, ParallelMode::SYNCHRONOUS, 32, 0.1f * 32);
+    train("Hogwild (batch 1)", threads, ParallelMode::HOGWILD, 1, 0.1f);
+}
+
+void benchmarkDynamicBatching() {
+    // Open-loop load generator: requests arrive at a fixed rate whatever the latency, and each
+    // one is timed from submission until its future is ready
+    NN model(64, 2, 256, 8, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+    Matrix inputs = Matrix::random(256, 64);
+    double duration_s = 0.5;
+
+    std::vector<BenchmarkResult> results;
+    for (BatchingOptions options : {BatchingOptions{1, 0}, BatchingOptions{8, 100}, BatchingOptions{32, 500}}) {
+        for (double qps : {1000.0, 5000.0, 20000.0}) {
+            size_t requests = static_cast<size_t>(qps * duration_s);
+            std::vector<std::future<Vector>> futures(requests);
+            std::vector<std::chrono::steady_clock::time_point> submitted(requests);
+            std::atomic<size_t> published{0};
+
+            BenchmarkResult result;
+            result.name = std::format("batch<={} wait={}us qps={}", options.max_batch_size, options.max_wait_us, qps);
+            result.iterations = 1;
+            result.samples_ns.reserve(requests);
+            auto start = std::chrono::steady_clock::now();
+            {
+                DynamicBatcher batcher(model, options);
+                // Completions are FIFO, so collecting the futures in order measures each latency
+                std::thread collector([&]() {
+                    for (size_t i = 0; i < requests; i++) {
+                        while (published.load(std::memory_order_acquire) <= i) std::this_thread::yield();
+                        futures[i].wait();
+                        auto latency = std::chrono::steady_clock::now() - submitted[i];
+                        result.samples_ns.push_back(std::chrono::duration<double, std::nano>(latency).count());
+                    }
+                });
+                auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / qps));
+                auto next = start;
+                for (size_t i = 0; i < requests; i++) {
+                    while (std::chrono::steady_clock::now() < next) std::this_thread::yield();
+                    submitted[i] = std::chrono::steady_clock::now();
+                    Vector x(64);
+                    std::copy(inputs.getRow(i % 256), inputs.getRow(i % 256) + 64, x.data());
+                    futures[i] = batcher.submit(std::move(x));
+                    published.store(i + 1, std::memory_order_release);
+                    next += interval;
+                }
+                collector.join();
+                result.metrics.emplace_back("mean batch", batcher.getMeanBatchSize());
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.metrics.emplace_back("achieved qps", requests / elapsed);
+            computeStatistics(result, BenchmarkOptions());
+            results.push_back(result);
+        }
+    }
+    printResults(results);
+}
+
+void benchmarkModelLoading() {
+    // ~3.4M parameters: decimal text needs ~12 characters per weight, the binary format 4 bytes
+    NN model("Loading", 256, 3, 1024, 16, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+    model.save("models/LoadingModel.txt");
+    model.save("models/LoadingModel.cnn");
+    print(std::format("Text: {:.1f} MB, binary: {:.1f} MB\n",
+        std::filesystem::file_size("models/LoadingModel.txt") / 1e6, std::filesystem::file_size("models/LoadingModel.cnn") / 1e6));
+
+    auto timeLoad = [](const std::string &name, NN &loaded, const std::string &file_name, bool verify) {
+        auto start = std::chrono::steady_clock::now();
+        loaded.load(file_name, verify);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<32} {:>10.2f} ms\n", name, ms));
+    };
+    NN from_text, from_binary, unverified;
+    timeLoad("Text (parsed)", from_text, "models/LoadingModel.txt", true);
+    timeLoad("Binary (mmap + checksum)", from_binary, "models/LoadingModel.cnn", true);
+    timeLoad("Binary (mmap only)", unverified, "models/LoadingModel.cnn", false);
+
+    Matrix inputs = Matrix::random(1, 256);
+    Vector x(256);
+    std::copy(inputs.getRow(0), inputs.getRow(0) + 256, x.data());
+    InferenceSession text_session(from_text), binary_session(from_binary);
+    const Vector &expected = text_session.predict(x);
+    const Vector &actual = binary_session.predict(x);
+    bool same = true;
+    for (size_t i = 0; i < expected.getSize(); i++) {
+        same = same && expected[i] == actual[i];
+    }
+    print(same ? "Binary and text models agree\n" : "Binary and text models DIFFER\n");
+    std::filesystem::remove("models/LoadingModel.txt");
+    std::filesystem::remove("models/LoadingModel.cnn");
+}
+
+void benchmarkFrozenInference() {
+    NN model(256, 3, 512, 16, "REGRESSION");
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.01f);
+    model.initialize();
+    Matrix x_batch = Matrix::random(64, 256);
+    Matrix y_batch = Matrix::random(64, 16);
+    model.fit(x_batch, y_batch, 1, 1, 64);
+    FrozenNN frozen = model.freeze();
+    InferenceSession session(model);
+    Vector x(256);
+    std::copy(x_batch.getRow(0), x_batch.getRow(0) + 256, x.data());
+
+    // Same model, same input: only the summation order differs
+    float max_error = 0;
+    const Matrix &expected = session.predictBatch(x_batch);
+    const Matrix &actual = frozen.predictBatch(x_batch);
+    for (size_t i = 0; i < expected.getShape().N; i++) {
+        max_error = std::max(max_error, std::abs(expected[i] - actual[i]));
+    }
+    // What a trained NN carries: parameters, per-sample buffers and the mini-batch activations and gradients
+    size_t model_floats = 0;
+    for (const DenseLayer &layer : model.getLayers()) {
+        model_floats += layer.getWeights().getShape().N + layer.getBiases().getSize()
+                      + layer.getCache().getSize() + layer.getOutput().getSize() + layer.getDelta().getSize()
+                      + layer.getBatchOutput().getShape().N + layer.getWeightsGradient().getShape().N + layer.getBiasesGradient().getSize();
+    }
+    print(std::format("Max |frozen - session| = {:.2e}, NN: {:.2f} MB, frozen: {:.2f} MB\n",
+        max_error, model_floats * sizeof(float) / 1e6, frozen.getMemoryBytes() / 1e6));
+
+    BenchmarkOptions options;
+    options.cpu = 0;
+    std::vector<BenchmarkResult> single = {
+        runBenchmark("NN::predict", [&]() { doNotOptimize(model.predict(x)[0]); }, options),
+        runBenchmark("InferenceSession::predict", [&]() { doNotOptimize(session.predict(x)[0]); }, options),
+        runBenchmark("FrozenNN::predict", [&]() { doNotOptimize(frozen.predict(x)[0]); }, options),
+    };
+    std::vector<BenchmarkResult> batch = {
+        runBenchmark("InferenceSession::predictBatch/64", [&]() { doNotOptimize(session.predictBatch(x_batch)[0]); }, options),
+        runBenchmark("FrozenNN::predictBatch/64", [&]() { doNotOptimize(frozen.predictBatch(x_batch)[0]); }, options),
+    };
+    printResults(single);
+    printComparison(single);
+    printResults(batch);
+    printComparison(batch);
+}
+
+void benchmarkQuantizedInference() {
+    // Synthetic 8-class problem: noisy samples around random class centers, one-hot targets
+    size_t inputs = 64, classes = 8, train_size = 2048, test_size = 1024;
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.6f);
+    Matrix centers = Matrix::random(classes, inputs);
+    auto makeData = [&](size_t n, Matrix &x, Matrix &y) {
+        x = Matrix(n, inputs);
+        y = Matrix(n, classes);
+        for (size_t i = 0; i < n; i++) {
+            size_t c = rng() % classes;
+            for (size_t k = 0; k < inputs; k++) {
+                x.setElement(centers.getElement(c, k) + noise(rng), i, k);
+            }
+            y.setElement(1.0f, i, c);
+        }
+    };
+    Matrix x_train, y_train, x_test, y_test;
+    makeData(train_size, x_train, y_train);
+    makeData(test_size, x_test, y_test);
+
+    NN model(inputs, classes, "CLASSIFICATION");
+    DenseLayer hidden1(inputs, 256, RELU, 1);
+    DenseLayer hidden2(256, 256, RELU, 2);
+    DenseLayer output(256, classes, SIGMOID, 3);
+    model.addLayer(hidden1);
+    model.addLayer(hidden2);
+    model.addLayer(output);
+    model.setInitializationFunction(XAVIER);
+    model.setLossFunction(MSE);
+    model.setOptimizer(SGD, 0.5f);
+    model.initialize();
+    model.fit(x_train, y_train, 10, 10, 16);
+
+    // Calibrate on training samples, report on the held-out ones
+    Matrix calibration = Matrix::view(x_train.data(), 256, inputs);
+    float fp32_accuracy = model.evaluate(x_test, y_test);
+    print(std::format("fp32 accuracy: {:.4f}\n", fp32_accuracy));
+    for (CalibrationMethod method : {CalibrationMethod::MIN_MAX, CalibrationMethod::PERCENTILE}) {
+        QuantizationOptions options;
+        options.method = method;
+        QuantizedNN quantized = model.quantize(calibration, options);
+        float int8_accuracy = model.score(quantized.predictBatch(x_test), y_test);
+        print(std::format("int8 accuracy ({}): {:.4f} (delta {:+.4f})\n",
+            method == CalibrationMethod::MIN_MAX ? "min/max" : "percentile", int8_accuracy, int8_accuracy - fp32_accuracy));
+    }
+
+    // Scoring speed and memory on a wider model
+    NN wide(256, 3, 512, 16, "REGRESSION");
+    wide.setInitializationFunction(XAVIER);
+    wide.setLossFunction(MSE);
+    wide.setOptimizer(SGD, 0.01f);
+    wide.initialize();
+    Matrix x_batch = Matrix::random(64, 256);
+    FrozenNN frozen = wide.freeze();
+    QuantizedNN quantized = wide.quantize(x_batch);
+    Vector x(256);
+    std::copy(x_batch.getRow(0), x_batch.getRow(0) + 256, x.data());
+
+    size_t fp32_bytes = 0;
+    for (const DenseLayer &layer : wide.getLayers()) {
+        fp32_bytes += (layer.getWeights().getShape().N + layer.getBiases().getSize()) * sizeof(float);
+    }
+    float max_error = 0;
+    const Matrix &expected = frozen.predictBatch(x_batch);
+    const Matrix &actual = quantized.predictBatch(x_batch);
+    for (size_t i = 0; i < expected.getShape().N; i++) {
+        max_error = std::max(max_error, std::abs(expected[i] - actual[i]));
+    }
+    print(std::format("Parameters: fp32 {:.2f} MB, int8 {:.2f} MB ({:.2f}x), max |int8 - fp32| = {:.2e}\n",
+        fp32_bytes / 1e6, quantized.getParameterBytes() / 1e6, double(fp32_bytes) / quantized.getParameterBytes(), max_error));
+
+    BenchmarkOptions bench_options;
+    bench_options.cpu = 0;
+    std::vector<BenchmarkResult> single = {
+        runBenchmark("NN::predict", [&]() { doNotOptimize(wide.predict(x)[0]); }, bench_options),
+        runBenchmark("FrozenNN::predict", [&]() { doNotOptimize(frozen.predict(x)[0]); }, bench_options),
+        runBenchmark("QuantizedNN::predict", [&]() { doNotOptimize(quantized.predict(x)[0]); }, bench_options),
+    };
+    std::vector<BenchmarkResult> batch = {
+        runBenchmark("FrozenNN::predictBatch/64", [&]() { doNotOptimize(frozen.predictBatch(x_batch)[0]); }, bench_options),
+        runBenchmark("QuantizedNN::predictBatch/64", [&]() { doNotOptimize(quantized.predictBatch(x_batch)[0]); }, bench_options),
+    };
+    printResults(single);
+    printComparison(single);
+    printResults(batch);
+    printComparison(batch);
+}
+
+bool testAllocationFreeFit() {
+    // After the first sample sized the buffers, a training epoch must not allocate a Matrix/Vector buffer.
+    // Build with -DLINALG_INSTRUMENTATION to enable the counters
+    if constexpr (!linalg::instrumentation::enabled) {
+        print("Allocation-free fit: skipped (needs LINALG_INSTRUMENTATION)\n");
+        return true;
+    }
+    Matrix x_train = Matrix::random(64, 8);
+    Matrix y_train = Matrix::random(64, 1);
+    bool passed = true;
+    for (size_t batch_size : {1, 16}) {
+        NN model(8, 2, 16, 1, "REGRESSION");
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(SGD, 0.01f);
+        model.initialize();
+
+        size_t epochs = 5;
+        std::vector<uint64_t> epoch_allocations;
+        epoch_allocations.reserve(epochs);
+        linalg::instrumentation::ScopedSnapshot counters(true);
+        model.setEpochCallback([&](size_t, float) {
+            epoch_allocations.push_back(counters.delta().allocations);
+            counters.reset();
+        });
+        model.fit(x_train, y_train, epochs, 1, batch_size);
+
+        // The first epoch contains the first sample (and the first batch): only later ones must be clean
+        for (size_t e = 1; e < epoch_allocations.size(); e++) {
+            if (epoch_allocations[e] != 0) {
+                print("FAILED: batch size ", batch_size, ", epoch ", e + 1, ": ", epoch_allocations[e], " allocations\n");
+                passed = false;
+            }
+        }
+    }
+    print(passed ? "Allocation-free fit: passed\n" : "Allocation-free fit: FAILED\n");
+    return passed;
+}
+
+
+void benchmarkLossBookkeeping() {
+    // Tiny model, per-sample training: the reported loss used to be a second pass over the outputs
+    // after backward(). It now comes out of the gradient pass, and can be skipped on unlogged epochs.
+    size_t inputs = 4, width = 16, outputs = 2, samples = 4096, epochs = 40, repeats = 200;
+    Matrix x_train = Matrix::random(samples, inputs);
+    Matrix y_train = Matrix::random(samples, outputs);
+
+    // The loss kernels alone, over one batch of outputs
+    Matrix y_predict = Matrix::random(samples, outputs), grad;
+    MeanSquaredErrorLossFunction mse;
+    float separate_loss = 0.0f, fused_loss = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        mse.gradInto(y_predict, y_train, grad);
+        separate_loss = mse.value(y_predict, y_train);
+    }
+    double separate = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+    Matrix expected_grad = grad;
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        fused_loss = mse.valueAndGradInto(y_predict, y_train, grad);
+    }
+    double fused = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+    // Same gradient; the loss only differs by the summation order
+    bool same = true;
+    for (size_t i = 0; i < grad.getShape().N; i++) same = same && grad[i] == expected_grad[i];
+    print(std::format("MSE value + gradInto: {:.2f} us -> valueAndGradInto: {:.2f} us ({:.2f}x) | gradient {} | loss error {:.1e}\n",
+        separate, fused, separate / fused, same ? "identical" : "DIFFERENT", std::abs(separate_loss - fused_loss) / separate_loss));
+
+    for (LossReporting mode : {LossReporting::EVERY_EPOCH, LossReporting::LOGGED_EPOCHS}) {
+        NN model("bookkeeping", inputs, outputs, "REGRESSION");
+        DenseLayer hidden(inputs, width, TANH, 1);
+        DenseLayer output(width, outputs, LINEAR, 2);
+        model.addLayer(hidden);
+        model.addLayer(output);
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(SGD, 0.01f);
+        model.setLossReporting(mode);
+        model.initialize();
+        start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, 4);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<13}: {:>7.3f} ms/epoch | final loss {:.6f}\n",
+            mode == LossReporting::EVERY_EPOCH ? "every epoch" : "logged epochs", ms / epochs, model.getLossHistory().back()));
+    }
+}
+
+void benchmarkEarlyStopping() {
+    // Small, noisy regression set: the held-out loss bottoms out within a few dozen epochs while the
+    // training loss keeps creeping down, which is where a fixed epoch count spends most of its time
+    size_t inputs = 8, samples = 64, validation = 512, epochs = 400, batch = 8;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    Matrix weights = Matrix::random(1, inputs);
+    auto makeSet = [&](size_t rows, Matrix &x, Matrix &y) {
+        x = Matrix::random(rows, inputs);
+        y = Matrix(rows, 1);
+        for (size_t i = 0; i < rows; i++) {
+            float target = 0.0f;
+            for (size_t j = 0; j < inputs; j++) target += weights.getElement(0, j) * x.getElement(i, j);
+            y.setElement(target + noise(rng), i, 0);
+        }
+    };
+    Matrix x_train, y_train, x_validation, y_validation;
+    makeSet(samples, x_train, y_train);
+    makeSet(validation, x_validation, y_validation);
+
+    std::vector<std::pair<Matrix, Vector>> initial;
+    auto run = [&](const std::string &name, const EarlyStopping &criteria,
+                   LossReporting reporting = LossReporting::EVERY_EPOCH) {
+        NN model("EarlyStopping", inputs, 1, "REGRESSION");
+        DenseLayer hidden1(inputs, 128, RELU, 1);
+        DenseLayer hidden2(128, 128, RELU, 2);
+        DenseLayer output(128, 1, LINEAR, 3);
+        model.addLayer(hidden1);
+        model.addLayer(hidden2);
+        model.addLayer(output);
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(MSE);
+        model.setOptimizer(ADAM, 0.01f);
+        model.initialize();
+        // Same initial parameters for every run
+        for (size_t l = 0; l < model.getLayers().size(); l++) {
+            DenseLayer &layer = model.getLayers()[l];
+            if (initial.size() < model.getLayers().size()) {
+                initial.emplace_back(Matrix(layer.getWeights()), Vector(layer.getBiases()));
+            }
+            layer.setParamenters(Matrix(initial[l].first), Vector(initial[l].second));
+        }
+        model.setEarlyStopping(criteria);
+        model.setLossReporting(reporting);
+        auto start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, 1, batch);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const FitSummary &summary = model.getFitSummary();
+        bool monitored = criteria.patience > 0 || criteria.target_loss > 0 || criteria.time_budget > 0 || criteria.x_validation;
+        print(std::format("{:<24}: {:>3} epochs in {:>7.1f} ms | best epoch {:>3}{} | validation loss {:.5f}\n",
+            name, summary.epochs, ms, monitored ? std::to_string(summary.best_epoch + 1) : "-",
+            summary.restored ? " (restored)" : "", model.evaluate(x_validation, y_validation)));
+    };
+    run("fixed epochs", EarlyStopping{});
+    run("validation, patience 20", {.patience = 20, .x_validation = &x_validation, .y_validation = &y_validation});
+    run("training loss plateau", {.patience = 10, .min_delta = 1e-4f});
+    run("target loss 0.05", {.target_loss = 0.05f});
+    // Unlogged epochs must still track the loss the target reads, or they stop with a zero loss
+    run("validation, target 0.05", {.target_loss = 0.05f, .x_validation = &x_validation, .y_validation = &y_validation},
+        LossReporting::LOGGED_EPOCHS);
+    run("time budget 0.2 s", {.time_budget = 0.2});
+}
+
+// Samples decoded from their index, at a configurable cost per feature (stands in for parsing a file)
+class SyntheticDataSource : public DataSource {
+private:
+    size_t samples, inputs, work;
+
+public:
+    SyntheticDataSource(size_t samples, size_t inputs, size_t work) : samples(samples), inputs(inputs), work(work) {}
+    size_t getSize() const override { return samples; }
+    size_t getInputSize() const override { return inputs; }
+    size_t getOutputSize() const override { return 1; }
+    void read(size_t begin, size_t count, Matrix &x, Matrix &y) const override {
+        for (size_t i = 0; i < count; i++) {
+            float target = 0.0f;
+            for (size_t j = 0; j < inputs; j++) {
+                float value = 0.0f;
+                for (size_t w = 0; w < work; w++) value += std::sin(0.37f * ((begin + i) * inputs + j) + 0.11f * w);
+                x.setElement(4.0f + 2.0f * value / work, i, j);
+                target += (j % 3 == 0 ? 1.0f : -0.5f) * value / work;
+            }
+            y.setElement(target, i, 0);
+        }
+    }
+};
+
+void benchmarkDataPipeline() {
+    // Decoding a batch costs about as much as training on it: read synchronously, training waits
+    // for every batch; prefetched by producer threads, reading overlaps with forward/backward
+    size_t samples = 8192, inputs = 32, work = 256, batch = 64, epochs = 2;
+    SyntheticDataSource source(samples, inputs, work);
+    // Per-batch normalization on the producer thread (the decoded features are centered on 4)
+    BatchTransform normalize = [](Matrix &x, Matrix &) {
+        linalg::transformInto(x, x, [](float v) { return (v - 4.0f) * 0.5f; });
+    };
+
+    std::vector<std::pair<Matrix, Vector>> initial;
+    auto build = [&]() {
+        auto model = std::make_unique<NN>("Pipeline", inputs, 1, "REGRESSION");
+        DenseLayer hidden1(inputs, 256, RELU, 1);
+        DenseLayer hidden2(256, 256, RELU, 2);
+        DenseLayer output(256, 1, LINEAR, 3);
+        model->addLayer(hidden1);
+        model->addLayer(hidden2);
+        model->addLayer(output);
+        model->setInitializationFunction(XAVIER);
+        model->setLossFunction(MSE);
+        model->setOptimizer(ADAM, 0.001f);
+        model->initialize();
+        // Same initial parameters for every run
+        for (size_t l = 0; l < model->getLayers().size(); l++) {
+            DenseLayer &layer = model->getLayers()[l];
+            if (initial.size() < model->getLayers().size()) {
+                initial.emplace_back(Matrix(layer.getWeights()), Vector(layer.getBiases()));
+            }
+            layer.setParamenters(Matrix(initial[l].first), Vector(initial[l].second));
+        }
+        return model;
+    };
+
+    // Lower bound: everything decoded up front, then the in-memory fit
+    Matrix x_train(samples, inputs), y_train(samples, 1);
+    source.read(0, samples, x_train, y_train);
+    normalize(x_train, y_train);
+    std::unique_ptr<NN> in_memory = build();
+    auto start = std::chrono::steady_clock::now();
+    in_memory->fit(x_train, y_train, epochs, 1, batch);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    float reference_loss = in_memory->getLossHistory().back();
+    print(std::format("{:<26}: {:>8.1f} ms/epoch | final loss {:.3e}\n", "in memory (decoded before)", ms / epochs, reference_loss));
+
+    struct Configuration {
+        size_t producers;
+        size_t depth;
+    };
+    for (Configuration configuration : std::vector<Configuration>{{0, 1}, {1, 2}, {1, 3}, {2, 3}, {4, 3}}) {
+        std::unique_ptr<NN> model = build();
+        DataPipeline pipeline(source, {.batch_size = batch, .producers = configuration.producers, .depth = configuration.depth}, normalize);
+        start = std::chrono::steady_clock::now();
+        model->fit(pipeline, epochs, 1);
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        float loss = model->getLossHistory().back();
+        print(std::format("{} producer(s), depth {}     : {:>8.1f} ms/epoch | stalls {:>4}/{} | final loss {:.3e} ({})\n",
+            configuration.producers, configuration.depth, ms / epochs, pipeline.getStallCount(),
+            epochs * pipeline.getBatchesPerEpoch(), loss, loss == reference_loss ? "same as in memory" : "DIFFERS"));
+    }
+}
+
+void benchmarkShuffledTraining() {
+    // Gathering a shuffled batch reads scattered rows; with the rows ahead prefetched it should cost
+    // about as much as copying the same rows in order
+    size_t rows = 1 << 18, cols = 64, batch = 256, repeats = 3;
+    Matrix data = Matrix::random(rows, cols);
+    Matrix out(batch, cols);
+    std::vector<size_t> sequential(rows), shuffled(rows);
+    std::iota(sequential.begin(), sequential.end(), size_t(0));
+    shuffled = sequential;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(1));
+    auto time = [&](auto &&body) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats; r++) body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+    };
+    auto pass = [&](const std::vector<size_t> &order, bool prefetch) {
+        for (size_t start = 0; start < rows; start += batch) {
+            if (prefetch) {
+                linalg::kernels::gatherRows(data.data(), order.data() + start, batch, cols, out.data());
+            } else {
+                for (size_t i = 0; i < batch; i++) {
+                    std::copy(data.getRow(order[start + i]), data.getRow(order[start + i]) + cols, out.data() + i*cols);
+                }
+            }
+        }
+    };
+    double in_order = time([&] { pass(sequential, true); });
+    double plain = time([&] { pass(shuffled, false); });
+    double gathered = time([&] { pass(shuffled, true); });
+    print(std::format("Epoch of {} x {} rows in batches of {}: in order {:.2f} ms | shuffled {:.2f} ms -> {:.2f} ms with prefetch ({:.2f}x in-order cost)\n",
+        rows, cols, batch, in_order, plain, gathered, gathered / in_order));
+
+    // Samples stored class by class: in order, each batch holds one class and training chases the last one
+    size_t classes = 4, features = 16, samples = 4096, epochs = 5;
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    Matrix centers = Matrix::random(classes, features);
+    Matrix x_train(samples, features), y_train(samples, classes);
+    for (size_t i = 0; i < samples; i++) {
+        size_t c = i * classes / samples;
+        for (size_t j = 0; j < features; j++) {
+            x_train.setElement(centers.getElement(c, j) + noise(rng), i, j);
+        }
+        y_train.setElement(1.0f, i, c);
+    }
+    for (bool shuffle : {false, true}) {
+        NN model("Shuffle", features, classes, "CLASSIFICATION");
+        DenseLayer hidden(features, 64, RELU, 1);
+        DenseLayer output(64, classes, LINEAR, 2);
+        model.addLayer(hidden);
+        model.addLayer(output);
+        model.setInitializationFunction(XAVIER);
+        model.setLossFunction(CROSS_ENTROPY);
+        model.setOptimizer(SGD, 0.05f);
+        model.setShuffle(shuffle, 7);
+        model.initialize();
+        auto start = std::chrono::steady_clock::now();
+        model.fit(x_train, y_train, epochs, 1, 32);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        print(std::format("{:<10}: {:.2f} ms/epoch | accuracy after {} epochs {:.3f}\n",
+            shuffle ? "shuffled" : "in order", ms / epochs, epochs, model.evaluate(x_train, y_train)));
+    }
+}
+
 int main(int argc, char const *argv[]) {
     // testLinearAlgebra();
     // testLayer();
     // testSaveLoad();
+    // testMatrixViews();
+    // testCustomActivation();
     // testForwardBackward();
     // xorNetwork();
     testEvaluate(); 
+    // testConcurrentInference();
+    // benchmarkLinearAlgebra();
+    // benchmarkTraining();
+    // benchmarkOptimizers();
+    // benchmarkParameterArena();
+    // benchmarkGradientAccumulation();
+    // benchmarkActivationDispatch();
+    // benchmarkActivationGradients();
+    // benchmarkCrossEntropy();
+    // benchmarkLossBookkeeping();
+    // benchmarkEarlyStopping();
+    // benchmarkDataPipeline();
+    // benchmarkShuffledTraining();
+    // traceTraining();
+    // profileAllocations();
+    // testAllocationFreeFit();
+    // benchmarkParallelTraining();
+    // benchmarkHogwild();
+    // benchmarkDynamicBatching();
+    // benchmarkModelLoading();
+    // benchmarkFrozenInference();
+    // benchmarkQuantizedInference();
     return 0;
 }
\ No newline at end of file